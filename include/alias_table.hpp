@@ -0,0 +1,53 @@
+/*! File alias_table.hpp
+ *  Contains the AliasTable class.
+ */
+#ifndef __ALIAS_TABLE_HPP__
+#define __ALIAS_TABLE_HPP__
+
+#include "util.hpp"
+#include <cstdint>
+#include <vector>
+
+/*! The AliasTable class draws an index with probability proportional to its
+ * weight in constant time, from a single random 64 bit word, using Vose's
+ * alias method. The weights can not be changed once the table is built.
+ */
+class AliasTable
+{
+  private:
+    // Chance, scaled to 2^64, of keeping each column instead of its alias
+    std::vector<uint64_t> thresholds;
+    std::vector<uint> aliases;
+
+  public:
+    /*! The constructor of an empty table.
+     */
+    AliasTable();
+
+    /*! The constructor.
+     * @param vector weights The non negative weight of each index.
+     * @throw invalid_argument if there are no weights, one is negative or
+     * they add up to 0.
+     */
+    AliasTable(const std::vector<double> &weights);
+
+    /*! Query the number of weights.
+     * @return The number of weights in the table.
+     */
+    uint size() const;
+
+    /*! Draws an index. The high part of word times the number of columns
+     * picks a column and the low part decides between it and its alias.
+     * @param uint64_t word A uniformly random word.
+     * @return The index drawn.
+     */
+    uint sample(uint64_t word) const
+    {
+        unsigned __int128 scaled = (unsigned __int128)word * thresholds.size();
+        uint column              = (uint)(scaled >> 64);
+        return (uint64_t)scaled < thresholds[column] ? column
+                                                     : aliases[column];
+    }
+};
+
+#endif
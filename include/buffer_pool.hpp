@@ -0,0 +1,130 @@
+/*! File buffer_pool.hpp
+ *  Contains the BufferPool class and the PoolAllocator that draws from it.
+ */
+#ifndef __BUFFER_POOL_HPP__
+#define __BUFFER_POOL_HPP__
+
+#include "util.hpp"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Smallest and largest size classes, as powers of two. Larger blocks are not
+// kept by the pool.
+#define BUFFER_POOL_MIN_BITS 6
+#define BUFFER_POOL_MAX_BITS 30
+
+// Maximum number of bytes kept in free blocks, the rest is given back
+#define BUFFER_POOL_MAX_CACHED (256ULL << 20)
+
+// Blocks of at least this size may be backed by transparent huge pages
+#define BUFFER_POOL_HUGE_PAGE (1ULL << 21)
+
+/*! The BufferPool class keeps freed blocks by size class, a power of two, so
+ * that the buffers of one cell are reused by the next ones instead of being
+ * allocated and faulted in again. Each size class has its own lock, blocks
+ * can be freed by any thread, like the writer threads of an OutputQueue, and
+ * at most BUFFER_POOL_MAX_CACHED bytes are kept, counted without a lock. Blocks of
+ * BUFFER_POOL_HUGE_PAGE bytes or more can be asked to be backed by
+ * transparent huge pages.
+ */
+class BufferPool
+{
+  private:
+    typedef struct
+    {
+        std::mutex mutex;
+        std::vector<void *> blocks;
+
+    } size_class_t;
+
+    size_class_t classes[BUFFER_POOL_MAX_BITS - BUFFER_POOL_MIN_BITS + 1];
+    std::atomic<unsigned long long> cached;
+    std::atomic<bool> huge_pages;
+
+    static uint size_class(size_t size);
+
+    void *allocate_block(size_t size);
+
+  public:
+    /*! The constructor.
+     * @param bool huge_pages Whether to back large blocks by huge pages.
+     */
+    BufferPool(bool huge_pages = false);
+
+    /*! The destructor. Frees the blocks kept by the pool; blocks still in
+     * use must not be given back after this.
+     */
+    ~BufferPool();
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /*! Gives a block of at least size bytes, aligned for any type.
+     * @param size_t size The number of bytes.
+     * @return The block.
+     * @throw bad_alloc if there is no memory left.
+     */
+    void *allocate(size_t size);
+
+    /*! Gives back a block taken from allocate.
+     * @param void* block The block.
+     * @param size_t size The size given to allocate.
+     */
+    void deallocate(void *block, size_t size);
+
+    /*! Sets whether new large blocks are backed by huge pages.
+     * @param bool huge_pages True to back them by huge pages.
+     */
+    void set_huge_pages(bool huge_pages);
+
+    /*! Query the number of bytes kept in free blocks.
+     * @return The number of bytes.
+     */
+    unsigned long long cached_bytes();
+
+    /*! The pool the PoolAllocator draws from, shared by all threads.
+     * @return The pool.
+     */
+    static BufferPool &shared();
+};
+
+/*! Allocator for standard containers that draws from BufferPool::shared.
+ */
+template <class T> class PoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    PoolAllocator() noexcept {}
+    template <class U> PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        return (T *)BufferPool::shared().allocate(n * sizeof(T));
+    }
+
+    void deallocate(T *block, size_t n)
+    {
+        BufferPool::shared().deallocate(block, n * sizeof(T));
+    }
+};
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return false;
+}
+
+// A vector whose memory comes from the pool
+template <class T> using pool_vector = std::vector<T, PoolAllocator<T>>;
+
+#endif
@@ -4,7 +4,12 @@
 #ifndef __CHROMOSOME_HPP__
 #define __CHROMOSOME_HPP__
 
+#include "constitutive_origin_index.hpp"
 #include "data_provider.hpp"
+#include "fenwick_tree.hpp"
+#include "gap_index.hpp"
+#include "probability_landscape.hpp"
+#include "strand.hpp"
 #include "util.hpp"
 #include <memory>
 #include <string>
@@ -13,6 +18,10 @@
 // Interval between bases in the output
 #define CHRM_OUTPUT_STEP 1
 
+// Number of bases summed in each leaf of the activation sampler, as a power
+// of two
+#define ACTIVATION_BLOCK_BITS 10
+
 class GenomicLocation;
 
 /*! The Chromosome class stores relevant data like length, number of bases
@@ -22,22 +31,83 @@ class GenomicLocation;
 class Chromosome
 {
     friend class GenomicLocation;
+    friend class Genome;
     friend class TestDataManager;
 
   private:
     std::string code;
+    uint id;
+
+    // Position in the Genome that holds the Chromosome
+    uint index;
     uint length;
     uint n_replicated_bases;
     uint n_fired_origins;
-    std::vector<int> strand;
+    Strand strand;
+
+    // Activation probability of the unreplicated bases, in fixed point
+    unsigned long long activation_mass;
+
+    // The same sums over the shared landscape, per block and in total, which
+    // is what they are before any base is replicated
+    unsigned long long landscape_mass;
+    std::vector<unsigned long long> landscape_blocks;
+
+    // Same sum per block of bases, empty unless activation sampling is on
+    FenwickTree activation_blocks;
+
+    // Runs of unreplicated bases, kept only if gap sampling is on
+    bool gap_sampling;
+    GapIndex unreplicated_gaps;
+
+    // Constitutive origins sorted by base, and which of them fired
+    ConstitutiveOriginIndex constitutive_origin_index;
 
-    std::vector<double> probability_landscape;
-    const std::shared_ptr<std::vector<transcription_region_t>>
+    // Unreplicated bases of the Genome that holds the Chromosome, if any
+    std::shared_ptr<unsigned long long> genome_unreplicated_bases;
+
+    // Keeps the shared probability landscape alive
+    std::shared_ptr<DataProvider> provider;
+    ProbabilityLandscape probability_landscape;
+    const std::shared_ptr<const std::vector<transcription_region_t>>
         transcription_regions;
+    const std::shared_ptr<const TranscriptionRegionIndex>
+        transcription_region_index;
+
+    /*! Builds the Chromosome from the data given by the provider.
+     */
+    Chromosome(std::shared_ptr<const chromosome_data_t> data,
+               std::shared_ptr<DataProvider> provider);
+
+    /*! Adds to the activation mass of the block holding base.
+     * @param uint base Any base of the block.
+     * @param long long delta The change, in fixed point units.
+     */
+    void add_activation(uint base, long long delta);
+
+    /*! Removes the activation probability of bases that got replicated.
+     * @param int anchor The base before the run.
+     * @param int direction The direction of the run (1 or -1).
+     * @param uint n_bases The number of bases in the run.
+     */
+    void remove_activation(int anchor, int direction, uint n_bases);
+
+    /*! Removes bases that got replicated from the unreplicated gaps.
+     * @param int anchor The base before the run.
+     * @param int direction The direction of the run (1 or -1).
+     * @param uint n_bases The number of bases in the run.
+     */
+    void remove_gap(int anchor, int direction, uint n_bases);
+
+    /*! Counts bases that got replicated, in the Chromosome and in the Genome
+     * that holds it.
+     * @param uint n_bases The number of bases.
+     */
+    void add_replicated(uint n_bases);
 
   public:
     std::shared_ptr<std::vector<constitutive_origin_t>> fired_constitutive_origins;
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
+    const std::shared_ptr<const std::vector<constitutive_origin_t>>
         constitutive_origins;
 
   public:
@@ -49,12 +119,12 @@ class Chromosome
      * Number of replication origins available for the Chromosome.
      */
 
-    /*! @var vector strand
+    /*! @var Strand strand
      * Stores the time when each base was replicated.
      */
 
     /*! The constructor for a Chromosome object.
-     * @param code The id of the Chromosome.
+     * @param code The code of the Chromosome.
      * @param length The length of the chromosome
      * @param probability_landscape The probability of each base to be an \
      * activation point
@@ -64,6 +134,12 @@ class Chromosome
 
     Chromosome(std::string code, std::shared_ptr<DataProvider> provider);
 
+    /*! The constructor for a Chromosome object.
+     * @param id The id of the Chromosome, its index in the provider codes.
+     * @param provider The provider of the Chromosome data.
+     */
+    Chromosome(uint id, std::shared_ptr<DataProvider> provider);
+
     /*! Query the length of the Chromosome.
      * @return The length of the Chromosome.
      */
@@ -109,6 +185,88 @@ class Chromosome
      */
     bool replicate(int start, int end, int time);
 
+    /*! Replicates the bases a fork starting at base covers in n_steps
+     * consecutive steps, as if replicate was called once per step. The caller
+     * must make sure that all those bases are inside the Chromosome and not
+     * replicated yet.
+     * @param uint base The base where the fork currently is.
+     * @param int direction The direction of the fork (1 or -1).
+     * @param uint speed The number of bases the fork replicates per step.
+     * @param uint time The time of the first step.
+     * @param uint n_steps How many steps to replicate.
+     */
+    void replicate_run(uint base, int direction, uint speed, uint time,
+                       uint n_steps);
+
+    /*! Counts the unreplicated bases following a given base.
+     * @param uint base The base to start from (not counted).
+     * @param int direction The direction to walk (1 or -1).
+     * @param uint limit Maximum number of bases to count.
+     * @return The number of consecutive unreplicated bases after base, up to
+     * the first replicated base, the end of the Chromosome or limit.
+     */
+    uint unreplicated_run(uint base, int direction, uint limit);
+
+    /*! Sum of the activation probability of all the bases not replicated yet.
+     * It is kept up to date by replicate and
+     * set_dormant_activation_probability.
+     * @return The expected number of successful firing attempts if every
+     * base of the Chromosome was tried once.
+     */
+    double unreplicated_activation_mass();
+
+    /*! Lists the bases where a firing attempt succeeds when constitutive
+     * origins are used, that is, the bases around origins that did not fire.
+     * @param uint origins_range Considered range around a constitutive origin.
+     * @return Sorted and disjoint [first, last] base intervals.
+     * @see GenomicLocation::will_activate
+     */
+    std::vector<std::pair<uint, uint>> unfired_origin_windows(uint origins_range);
+
+    /*! Same as unreplicated_activation_mass, in fixed point units of 2^-32.
+     * @return The activation mass of the unreplicated bases.
+     */
+    unsigned long long unreplicated_activation_units();
+
+    /*! Starts keeping the activation probability of the unreplicated bases in
+     * a sum tree, so that random_activation_base can be used.
+     */
+    void enable_activation_sampling();
+
+    /*! Picks an unreplicated base with probability proportional to its
+     * activation probability.
+     * @param unsigned long long target A uniform value in
+     * [0, unreplicated_activation_units()).
+     * @return The index of the base.
+     * @see enable_activation_sampling
+     */
+    uint random_activation_base(unsigned long long target);
+
+    /*! Starts keeping the runs of unreplicated bases in a GapIndex, so that
+     * random_unreplicated_base can be used.
+     */
+    void enable_gap_sampling();
+
+    /*! Brings the Chromosome back to the state it was built in, with no base
+     * replicated, no origin fired and the shared probability landscape, so
+     * that it can be used for another cell. The samplers that were enabled
+     * stay enabled, and the memory already taken is kept.
+     */
+    void reset();
+
+    /*! Query the replication times of the bases.
+     * @return The Strand of the Chromosome.
+     */
+    const Strand &get_strand() const;
+
+    /*! Picks an unreplicated base by its rank.
+     * @param unsigned long long rank A uniform value in
+     * [0, size() - get_n_replicated_bases()) gives a uniform base.
+     * @return The index of the base.
+     * @see enable_gap_sampling
+     */
+    uint random_unreplicated_base(unsigned long long rank);
+
     /*! Checks if the entire Chromosome is replicated.
      * @return True if all bases have been replicated.
      * @see base_is_replicated
@@ -116,11 +274,23 @@ class Chromosome
      */
     bool is_replicated();
 
-    /*! Query the id of the Chromosome.
+    /*! Query the code of the Chromosome, to name it in the output.
      * @return The code of the Chromosome.
      */
     std::string get_code();
 
+    /*! Query the id of the Chromosome, its index in the codes of the provider.
+     * @return The id of the Chromosome.
+     */
+    uint get_id();
+
+    /*! Query the index of the Chromosome in the Genome that holds it, which
+     * is its id only if the Genome has every Chromosome of the provider, in
+     * order.
+     * @return The index of the Chromosome.
+     */
+    uint get_index();
+
     /*! Retrieve the number of constitutive origins of this chromosome.
      * @return The number of constitutive origins.
      */
@@ -135,9 +305,14 @@ class Chromosome
 
     void add_fired_origin();
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
+    const std::shared_ptr<const std::vector<transcription_region_t>>
     get_transcription_regions() const;
 
+    /*! Query the transcription regions indexed by position.
+     * @return The index, shared with the other cells.
+     */
+    const TranscriptionRegionIndex &get_transcription_region_index() const;
+
     bool operator==(Chromosome &other);
 
     // Strand accessor
@@ -51,6 +51,20 @@
             }                                                                  \
     }
 
+#define PUSH_LIST(field, parse)                                                \
+    {                                                                          \
+        ([]() -> std::string {                                                 \
+            std::string path = #field;                                         \
+            return path.substr(path.rfind(".") + 1, path.size());              \
+        })(),                                                                  \
+            [](cl_configuration_data &data, std::string val,                   \
+               ryml::NodeRef &base) {                                          \
+                std::string path = #field;                                     \
+                std::string k = path.substr(path.rfind(".") + 1, path.size()); \
+                data.field    = parse(read_yml_list(base, k));                 \
+            }                                                                  \
+    }
+
 #define PUSH_FUNCS(field, functions)                                           \
     {                                                                          \
         ([]() -> std::string {                                                 \
@@ -144,6 +158,20 @@ typedef struct
     } fitness;
 } cl_evolution_data;
 
+typedef struct
+{
+    // Values taken by each swept parameter, empty when it is not swept
+    std::vector<unsigned long long> resources;
+    std::vector<unsigned long long> period;
+    std::vector<unsigned long long> speed;
+    std::vector<unsigned long long> constitutive;
+    std::vector<bool> dormant;
+
+    // "config" to simulate the points in the order of the configuration, or
+    // "longest" to start with those expected to take longest
+    std::string order = "config";
+} cl_sweep_data;
+
 typedef struct
 {
     std::string mode = "basic";
@@ -163,13 +191,23 @@ typedef struct
     double probability              = 0;
     std::string output              = "output";
     unsigned long long threads      = 8;
+    std::string engine              = "step";
+    std::string sampler             = "rejection";
+    std::string format              = "text";
+    std::string cache_dir           = "";
+    bool huge_pages                 = false;
+    std::string rng                 = "mt19937";
+    unsigned long long profile_bin  = 0;
 
     // Other modes data
     cl_evolution_data evolution;
+    cl_sweep_data sweep;
 } cl_configuration_data;
 
 bool operator==(const cl_evolution_data &a, const cl_evolution_data &b);
 
+bool operator==(const cl_sweep_data &a, const cl_sweep_data &b);
+
 bool operator==(const cl_configuration_data &a, const cl_configuration_data &b);
 
 typedef std::unordered_map<
@@ -185,6 +223,44 @@ void read_conf_yml(
             "Unknown parameter in configuration file: " + argument);
     });
 
+/*! Reads the items of a list in a configuration file, either a YAML sequence
+ * or a single comma separated value.
+ * @param ryml::NodeRef base The node containing the list.
+ * @param std::string key The key of the list in base.
+ * @return The items of the list, as written.
+ */
+std::vector<std::string> read_yml_list(ryml::NodeRef &base, std::string key);
+
+/*! Parses a list of non negative integers. Each item is either a number or an
+ * inclusive range "from:to" or "from:to:step".
+ * @param vector items The items of the list.
+ * @return The numbers, in the order they were given.
+ * @throw invalid_argument if an item is not a number or range, or a range
+ * has a zero step or ends before it starts.
+ */
+std::vector<unsigned long long>
+parse_ull_list(const std::vector<std::string> &items);
+
+/*! Parses a list of booleans, written as "true" or "false".
+ * @param vector items The items of the list.
+ * @return The booleans, in the order they were given.
+ * @throw invalid_argument if an item is neither "true" nor "false".
+ */
+std::vector<bool> parse_bool_list(const std::vector<std::string> &items);
+
+/*! Expands a sweep into its parameter points, one for every combination of
+ * the swept values. Parameters that are not swept keep their single value.
+ * Points that only differ by speed or constitutive range would share an
+ * output folder, so when those are swept their values are appended to the
+ * name of each point. The points come in the order of the configuration, or,
+ * when sweep.order is "longest", sorted by increasing resources * speed, as
+ * an S-phase lasts about genome / (resources * speed) steps.
+ * @param cl_configuration_data arguments The configuration of the sweep.
+ * @return The configuration of each point, in basic mode.
+ */
+std::vector<cl_configuration_data>
+sweep_points(const cl_configuration_data &arguments);
+
 /*! This class represents a running configuration for the simulations.
  *
  * It contains parses and stores all configuration options for passing
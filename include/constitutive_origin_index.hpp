@@ -0,0 +1,91 @@
+/*! File constitutive_origin_index.hpp
+ *  Contains the ConstitutiveOriginIndex class.
+ */
+#ifndef __CONSTITUTIVE_ORIGIN_INDEX_HPP__
+#define __CONSTITUTIVE_ORIGIN_INDEX_HPP__
+
+#include "util.hpp"
+#include <vector>
+
+/*! The ConstitutiveOriginIndex class keeps the constitutive origins of a
+ * Chromosome sorted by base, along with which of them already fired. Finding
+ * the unfired origins around a base takes logarithmic time and does not
+ * allocate. Origins are told apart by their base, as in operator==, so
+ * firing one fires all the origins on the same base.
+ */
+class ConstitutiveOriginIndex
+{
+  private:
+    // Origins sorted by base, and their position in the original list
+    std::vector<constitutive_origin_t> origins;
+    std::vector<uint> order;
+
+    std::vector<bool> fired;
+
+    // Links towards the next unfired origin, the first unfired origin at
+    // i or after it is found by following them from i
+    std::vector<uint> next_unfired;
+
+    /*! Finds the first unfired origin at a sorted position or after it.
+     * @param uint i The sorted position to start from.
+     * @return The sorted position found, or size() if there is none.
+     */
+    uint first_unfired_from(uint i);
+
+    /*! Finds the sorted position of the first origin on base or after it.
+     */
+    uint lower_bound(long long base) const;
+
+  public:
+    /*! The constructor of an empty index.
+     */
+    ConstitutiveOriginIndex();
+
+    /*! The constructor. No origin is fired.
+     * @param vector origins The constitutive origins of a Chromosome.
+     */
+    ConstitutiveOriginIndex(const std::vector<constitutive_origin_t> &origins);
+
+    /*! Query the number of origins in the index.
+     * @return The number of origins.
+     */
+    uint size() const;
+
+    /*! Marks the origins on a base as fired.
+     * @param int base The base of the origin.
+     * @return True if there was an unfired origin on base.
+     */
+    bool fire(int base);
+
+    /*! Queries if the origins on a base fired.
+     * @param int base The base of the origin.
+     * @return True if there is an origin on base and it fired.
+     */
+    bool is_fired(int base) const;
+
+    /*! Looks for an unfired origin with base in [first, last].
+     * @param long long first The lowest base.
+     * @param long long last The highest base.
+     * @return True if there is one.
+     */
+    bool has_unfired(long long first, long long last);
+
+    /*! Finds the unfired origin with base in [first, last] that comes first
+     * in the original list of origins.
+     * @param long long first The lowest base.
+     * @param long long last The highest base.
+     * @return The origin found, or an origin with base -1 if there is none.
+     */
+    constitutive_origin_t first_unfired(long long first, long long last);
+
+    /*! Lists the unfired origins, sorted by base.
+     * @return The unfired origins.
+     */
+    std::vector<constitutive_origin_t> unfired();
+
+    /*! Marks every origin as unfired again.
+     */
+    void reset();
+};
+
+#endif
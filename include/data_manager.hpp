@@ -3,7 +3,9 @@
 
 #include "chromosome.hpp"
 #include "data_provider.hpp"
+#include "genome_cache.hpp"
 #include "util.hpp"
+#include <SQLiteCpp/SQLiteCpp.h>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -21,39 +23,87 @@ class DataManager : public DataProvider
     std::string mfa_seq_data_path;
     double uniform;
 
+    // Ids are the indexes of the codes, names are only used to look them up
     std::vector<std::string> codes;
-    std::unordered_map<std::string, int> lengths;
+    std::unordered_map<std::string, uint> ids;
+    std::vector<int> lengths;
 
-    void generate_prob_landscape(std::string code, uint length);
+    // Where the landscapes are read from when a cache file was used
+    std::unique_ptr<GenomeCache> cache;
 
-    void generate_transcription_regions(std::string code);
+    /*! Loads the data from a cache file if it exists and was made from the
+     * current database and MFA-Seq files.
+     * @return True if the cache was used.
+     */
+    bool load_cache(std::string path, std::string organism);
 
-    void generate_constitutive_origins(std::string code);
+    /*! Writes the loaded data to a cache file, warning if it fails.
+     */
+    void save_cache(std::string path, std::string organism);
+
+    void generate_prob_landscape(uint id);
+
+    void generate_transcription_regions(SQLite::Database &db,
+                                        std::string organism);
+
+    void generate_constitutive_origins(SQLite::Database &db,
+                                       std::string organism);
 
   protected:
-    std::mutex lengths_mutex;
     std::mutex prob_landscape_mutex;
-    std::mutex transcription_regions_mutex;
-    std::mutex constitutive_origins_mutex;
 
-    std::unordered_map<std::string, std::vector<double>> probability_landscape;
-    std::unordered_map<std::string, std::vector<constitutive_origin_t>>
+    // Indexed by Chromosome id. The origins and regions are shared with the
+    // snapshot, so they are replaced instead of changed.
+    std::vector<std::vector<double>> probability_landscape;
+    std::vector<std::shared_ptr<const std::vector<constitutive_origin_t>>>
         constitutive_origins;
-    std::unordered_map<std::string, std::vector<transcription_region_t>>
+    std::vector<std::shared_ptr<const std::vector<transcription_region_t>>>
         transcription_regions;
 
+    // Data of each Chromosome by id, read without locking once frozen
+    std::vector<std::shared_ptr<const chromosome_data_t>> snapshot;
+
+    /*! Builds the snapshot from the loaded data. It must be called again
+     * whenever the data changes, while no cell is being created.
+     */
+    void freeze();
+
   public:
+    /*! The constructor.
+     * @param string organism The organism whose Chromosomes are loaded.
+     * @param string database_path The path of the database file.
+     * @param string mfa_seq_data_path The folder of the MFA-Seq files.
+     * @param double p If not 0, the activation probability of every base.
+     * @param string cache_dir The folder of the genome cache files, or empty
+     * not to use them. The cache file of the organism and p is used if it is
+     * up to date, and written otherwise.
+     * @throws std::runtime_error If an MFA-Seq file could not be read.
+     */
     DataManager(std::string organism, std::string database_path,
-                std::string mfa_seq_data_path, double p = 0);
+                std::string mfa_seq_data_path, double p = 0,
+                std::string cache_dir = "");
     ~DataManager();
 
+    using DataProvider::get_chromosome_data;
+    using DataProvider::get_constitutive_origins;
+    using DataProvider::get_landscape_view;
+    using DataProvider::get_length;
+    using DataProvider::get_probability_landscape;
+    using DataProvider::get_transcription_region_index;
+    using DataProvider::get_transcription_regions;
+
     const std::vector<std::string> &get_codes();
-    int get_length(std::string code);
-    const std::vector<double> &get_probability_landscape(std::string code);
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code);
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code);
+    uint get_chromosome_id(std::string code);
+    int get_length(uint id);
+    const std::vector<double> &get_probability_landscape(uint id);
+    landscape_view_t get_landscape_view(uint id);
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id);
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id);
+    const std::shared_ptr<const TranscriptionRegionIndex>
+    get_transcription_region_index(uint id);
+    std::shared_ptr<const chromosome_data_t> get_chromosome_data(uint id);
 };
 
 #endif
@@ -2,25 +2,167 @@
 #define __DATA_PROVIDER_HPP__
 
 #include "chromosome.hpp"
+#include "probability_landscape.hpp"
+#include "transcription_region_index.hpp"
 #include "util.hpp"
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+/*! The data of a Chromosome, which does not change while cells are
+ * simulated and is shared by all of them.
+ */
+typedef struct
+{
+    std::string code;
+    int length;
+    landscape_view_t probability_landscape;
+    std::shared_ptr<const std::vector<transcription_region_t>>
+        transcription_regions;
+    std::shared_ptr<const TranscriptionRegionIndex> transcription_region_index;
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+        constitutive_origins;
+
+} chromosome_data_t;
+
 /*! The DataProvider class is an abstract class for passing data to a chromosome
+ * by its id, codes are only resolved to ids.
  */
 class DataProvider
 {
   public:
     virtual const std::vector<std::string> &get_codes() = 0;
-    virtual int get_length(std::string code)            = 0;
-    virtual const std::vector<double> &
-    get_probability_landscape(std::string code) = 0;
-    virtual const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code) = 0;
-    virtual const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code) = 0;
+
+    /*! Query the id of a Chromosome, which is the index of its code in
+     * get_codes. Names are only meant to be resolved at input and output,
+     * everything else should refer to Chromosomes by id.
+     * @param string code The code of the Chromosome.
+     * @return The id of the Chromosome.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    virtual uint get_chromosome_id(std::string code)
+    {
+        const std::vector<std::string> &codes = get_codes();
+        auto found = std::find(codes.begin(), codes.end(), code);
+        if (found == codes.end())
+            throw std::out_of_range("Chromosome " + code +
+                                    " is not in the provider.");
+        return found - codes.begin();
+    }
+
+    /*! Query the length of a Chromosome.
+     * @param uint id The id of the Chromosome, its index in get_codes.
+     * @return The number of bases of the Chromosome.
+     */
+    virtual int get_length(uint id) = 0;
+
+    /*! Gives the probability landscape of a Chromosome as a vector.
+     * @param uint id The id of the Chromosome.
+     * @return The activation probability of each base.
+     */
+    virtual const std::vector<double> &get_probability_landscape(uint id) = 0;
+
+    /*! Gives the transcription regions of a Chromosome, which may be
+     * shared with other callers.
+     * @param uint id The id of the Chromosome.
+     * @return The transcription regions.
+     */
+    virtual std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id) = 0;
+
+    /*! Gives the constitutive origins of a Chromosome, which may be shared
+     * with other callers.
+     * @param uint id The id of the Chromosome.
+     * @return The constitutive origins.
+     */
+    virtual std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id) = 0;
+
+    /*! Gives the probability landscape of a Chromosome without requiring it
+     * to be stored in a vector. Providers that keep it elsewhere, like in a
+     * memory mapped cache, should override this.
+     */
+    virtual landscape_view_t get_landscape_view(uint id)
+    {
+        const std::vector<double> &landscape = get_probability_landscape(id);
+        return landscape_view_t{landscape.data(), (uint)landscape.size()};
+    }
+
+    /*! Gives the transcription regions of a Chromosome indexed by position.
+     * Providers that serve many cells should build it once and share it.
+     */
+    virtual const std::shared_ptr<const TranscriptionRegionIndex>
+    get_transcription_region_index(uint id)
+    {
+        return std::make_shared<const TranscriptionRegionIndex>(
+            *get_transcription_regions(id));
+    }
+
+    /*! Gives all the data of a Chromosome at once. Providers that serve many
+     * cells should keep it in a snapshot, so that it is neither locked nor
+     * copied.
+     * @param uint id The id of the Chromosome, its index in get_codes.
+     * @return The data of the Chromosome.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    virtual std::shared_ptr<const chromosome_data_t>
+    get_chromosome_data(uint id)
+    {
+        auto data    = std::make_shared<chromosome_data_t>();
+        data->code   = get_codes().at(id);
+        data->length = get_length(id);
+        data->probability_landscape      = get_landscape_view(id);
+        data->transcription_regions      = get_transcription_regions(id);
+        data->transcription_region_index = get_transcription_region_index(id);
+        data->constitutive_origins       = get_constitutive_origins(id);
+        return data;
+    }
+
+    // The same queries by code, for names that come from input. They only
+    // resolve the id, so providers override the queries by id, and bring
+    // these in with a using declaration.
+
+    int get_length(std::string code)
+    {
+        return get_length(get_chromosome_id(code));
+    }
+
+    const std::vector<double> &get_probability_landscape(std::string code)
+    {
+        return get_probability_landscape(get_chromosome_id(code));
+    }
+
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(std::string code)
+    {
+        return get_transcription_regions(get_chromosome_id(code));
+    }
+
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(std::string code)
+    {
+        return get_constitutive_origins(get_chromosome_id(code));
+    }
+
+    landscape_view_t get_landscape_view(std::string code)
+    {
+        return get_landscape_view(get_chromosome_id(code));
+    }
+
+    const std::shared_ptr<const TranscriptionRegionIndex>
+    get_transcription_region_index(std::string code)
+    {
+        return get_transcription_region_index(get_chromosome_id(code));
+    }
+
+    std::shared_ptr<const chromosome_data_t>
+    get_chromosome_data(std::string code)
+    {
+        return get_chromosome_data(get_chromosome_id(code));
+    }
 };
 
 #endif
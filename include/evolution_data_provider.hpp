@@ -20,7 +20,7 @@ struct BellCurve
 {
     struct
     {
-        std::string chromosome;
+        uint chromosome; // The id of the Chromosome
         long base;
     } location;
 
@@ -36,7 +36,7 @@ class EvolutionDataProvider : public DataManager
   private:
     std::mt19937 rand_generator;
     std::vector<BellCurve> bell_curves;
-    std::unordered_map<std::string, std::vector<double>> original_landscape;
+    std::vector<std::vector<double>> original_landscape;
     bool dead = false;
 
   public:
@@ -0,0 +1,57 @@
+/*! File fenwick_tree.hpp
+ *  Contains the FenwickTree class.
+ */
+#ifndef __FENWICK_TREE_HPP__
+#define __FENWICK_TREE_HPP__
+
+#include "util.hpp"
+#include <vector>
+
+/*! The FenwickTree class keeps the prefix sums of a list of non negative
+ * integer weights, so that a weight can be changed and an index can be drawn
+ * with probability proportional to its weight in logarithmic time.
+ */
+class FenwickTree
+{
+  private:
+    std::vector<unsigned long long> tree;
+    unsigned long long sum;
+
+  public:
+    /*! The constructor of an empty tree.
+     */
+    FenwickTree();
+
+    /*! The constructor.
+     * @param vector weights The initial weight of each index.
+     */
+    FenwickTree(const std::vector<unsigned long long> &weights);
+
+    /*! Query the number of weights.
+     * @return The number of weights in the tree.
+     */
+    uint size();
+
+    /*! Query the sum of all weights.
+     * @return The total weight.
+     */
+    unsigned long long total();
+
+    /*! Changes the weight of an index. The resulting weight must not be
+     * negative.
+     * @param uint index The index to change.
+     * @param long long delta The amount to add to its weight.
+     */
+    void add(uint index, long long delta);
+
+    /*! Finds the index whose cumulative weight range holds target, that is,
+     * the first index for which the sum of the weights up to it exceeds
+     * target.
+     * @param unsigned long long target A value in [0, total()). It is
+     * decreased by the sum of the weights before the returned index.
+     * @return The index found.
+     */
+    uint find(unsigned long long &target);
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*! File fork_event_log.hpp
+ *  Contains the ForkEventLog and ForkEventReader classes, which record the
+ *  runs of the replication forks of a cell and rebuild its replication times
+ *  from them.
+ */
+#ifndef __FORK_EVENT_LOG_HPP__
+#define __FORK_EVENT_LOG_HPP__
+
+#include "buffer_pool.hpp"
+#include "strand.hpp"
+#include "util.hpp"
+#include <string>
+#include <vector>
+
+// Why a fork run ended
+#define FORK_RUN_MET 'M'       // The next base was replicated by another fork
+#define FORK_RUN_END 'E'       // The fork reached the end of its Chromosome
+#define FORK_RUN_COLLISION 'C' // Head-to-head collision with an RNAP
+#define FORK_RUN_ATTACHED 'A'  // The fork was attached when the S-phase ended
+
+/*! A fork run: the bases one fork replicated from the origin it was attached
+ * to until it was detached. The base at origin + direction * i, for i from 0
+ * to |last - origin|, was replicated at start_time + ceil(i / speed), speed
+ * being the one of all the forks of the cell. The two forks of an origin
+ * both hold the origin, and runs share no other base.
+ */
+typedef struct
+{
+    uint chromosome;
+    int origin;
+    int direction;
+    int start_time;
+    int last;
+    char end;
+
+} fork_run_t;
+
+/*! Formats a run as a line of a fork event file: origin, direction, start
+ * time, last base and end, separated by tabs. The chromosome is not written,
+ * as each file holds the runs of a single Chromosome.
+ * @param fork_run_t run The run.
+ * @return The text, without line break.
+ */
+std::string to_string(const fork_run_t &run);
+
+/*! The ForkEventLog class records the runs of the forks of a ForkManager as
+ * they are attached and detached, so that the replication of a cell can be
+ * saved as a couple of runs per fired origin instead of its times.
+ * @see ForkManager::set_event_log
+ */
+class ForkEventLog
+{
+  private:
+    // Run of each attached fork, by index of the fork
+    pool_vector<fork_run_t> open;
+
+    // Runs of the forks already detached, in the order they were
+    pool_vector<fork_run_t> runs;
+
+  public:
+    /*! Starts the run of a fork.
+     * @param uint fork The index of the fork in its ForkManager.
+     * @param uint chromosome The id of the Chromosome.
+     * @param int origin The base the fork was attached to.
+     * @param int direction The direction of the fork (1 or -1).
+     * @param int time The time the fork was attached at.
+     */
+    void attach(uint fork, uint chromosome, int origin, int direction,
+                int time);
+
+    /*! Ends the run of a fork.
+     * @param uint fork The index of the fork in its ForkManager.
+     * @param int last The last base the fork replicated.
+     * @param char end Why the run ended, one of the FORK_RUN_* values.
+     * @throw runtime_error if the fork has no run started.
+     */
+    void detach(uint fork, int last, char end);
+
+    /*! Query the ended runs.
+     * @return The runs, in the order they ended.
+     */
+    const pool_vector<fork_run_t> &get_runs() const;
+
+    /*! Drops every run, keeping their memory, for another cell.
+     */
+    void clear();
+
+    /*! Writes the runs of a Chromosome to a fork event file: a header line
+     * "# code length speed" followed by one line per run, sorted by position.
+     * @param string path The path of the file.
+     * @param string code The code of the Chromosome.
+     * @param uint length The number of bases of the Chromosome.
+     * @param uint speed The speed of the forks.
+     * @param vector runs The runs of the Chromosome, sorted in place.
+     * @throw runtime_error if the file can not be written.
+     */
+    static void write(std::string path, std::string code, uint length,
+                      uint speed, std::vector<fork_run_t> &runs);
+};
+
+/*! The ForkEventReader class reads the files written by ForkEventLog::write.
+ * Only the runs are loaded, the replication times of a range of bases or of
+ * the whole Chromosome are computed from them when asked for.
+ */
+class ForkEventReader
+{
+  private:
+    std::string code;
+    uint length;
+    uint speed;
+
+    // Runs sorted by their lowest base
+    std::vector<fork_run_t> runs;
+
+    /*! Finds the run that holds a base.
+     * @param uint base The base to look for.
+     * @return The index of the run, or runs.size() if the base is not
+     * replicated.
+     */
+    uint find(uint base) const;
+
+  public:
+    /*! The constructor. Reads every run of the file.
+     * @param string path The path of the file.
+     * @throw runtime_error if the file can not be read or is not valid.
+     */
+    ForkEventReader(std::string path);
+
+    /*! Query the code of the Chromosome in the file.
+     * @return The code of the Chromosome.
+     */
+    std::string get_code() const;
+
+    /*! Query the number of bases of the Chromosome in the file.
+     * @return The length of the Chromosome.
+     */
+    uint get_length() const;
+
+    /*! Query the speed of the forks of the cell.
+     * @return The number of bases a fork replicates per step.
+     */
+    uint get_speed() const;
+
+    /*! Query the runs, with their chromosome set to 0. Collisions with RNAPs
+     * are the runs ending with FORK_RUN_COLLISION, at their last base.
+     * @return The runs, sorted by their lowest base.
+     */
+    const std::vector<fork_run_t> &get_runs() const;
+
+    /*! Query the replication time of a base.
+     * @param uint base The index of the base.
+     * @return The time the base was replicated at, -1 if it was not.
+     * @throw out_of_range if the base is not in the Chromosome.
+     */
+    int time(uint base) const;
+
+    /*! Query the replication times of a range of bases.
+     * @param uint first The first base of the range.
+     * @param uint last The last base of the range, included.
+     * @return The time of each base of the range, -1 for unreplicated ones.
+     * @throw out_of_range if the range is not in the Chromosome.
+     */
+    std::vector<int> times(uint first, uint last) const;
+
+    /*! Rebuilds the Strand of the Chromosome, which holds the same times as
+     * the one that was simulated.
+     * @return The Strand.
+     */
+    Strand strand() const;
+
+    /*! Replication time of a base inside a run.
+     * @param fork_run_t run The run containing base.
+     * @param uint speed The speed of the forks.
+     * @param int base The index of the base.
+     * @return The time the base was replicated at.
+     */
+    static int time_at(const fork_run_t &run, uint speed, int base);
+};
+
+#endif
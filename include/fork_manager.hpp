@@ -1,6 +1,8 @@
 #ifndef __FORK_MANAGER__
 #define __FORK_MANAGER__
 
+#include "buffer_pool.hpp"
+#include "fork_event_log.hpp"
 #include "replication_fork.hpp"
 #include "util.hpp"
 #include "genome.hpp"
@@ -8,20 +10,91 @@
 #include <vector>
 #include <memory>
 
+// Fork state flags
+#define FORK_JUST_DETACHED 1
+#define FORK_IDLE_CACHED 2
+
 // Forward declaration
 class ReplicationFork;
 
+/*! The ForkManager class owns the replication forks of a cell. Forks are
+ * stored as a table with one array per field, so that the passes over all
+ * forks made at every step run over contiguous memory. A fork is attached
+ * when its direction is not 0.
+ */
 class ForkManager
 {
+    friend class ReplicationFork;
+
+  private:
+    std::shared_ptr<Genome> genome;
+    uint speed;
+
+    // The Chromosomes of the Genome, which keeps them alive
+    std::vector<Chromosome *> chromosomes;
+
+    // Fork table
+    pool_vector<int> fork_base;
+    pool_vector<int> fork_direction;
+    pool_vector<uint> fork_chromosome;
+    pool_vector<unsigned char> fork_flags;
+
+    // Cache for fork_idle_steps, valid until the step fork_idle_until or
+    // until a new origin fires on the path between the fork and
+    // fork_idle_path_end.
+    pool_vector<uint> fork_idle_until;
+    pool_vector<int> fork_idle_path_end;
+
+    // Free forks, sorted so that the lowest index is at the back
+    pool_vector<uint> free_forks;
+
+    // Where the runs of the forks are recorded, if anywhere
+    std::shared_ptr<ForkEventLog> event_log;
+
+    /*! Makes a fork available for attach_forks.
+     */
+    void push_free_fork(uint fork);
+
+    /*! Attaches a fork to a base and replicates that base right away.
+     * @throw runtime_error if the fork is attached or just detached.
+     * @throw invalid_argument if the Chromosome is not in the Genome.
+     */
+    void attach_fork(uint fork, const GenomicLocation &location, int direction,
+                     uint time);
+
+    /*! Unbinds a fork from the position where it was, which is the last
+     * base of its run in the ForkEventLog.
+     * @param problem If the detachment is caused by a problem in
+     * replication, in which case the fork is only freed in the next step.
+     */
+    void detach_fork(uint fork, bool problem);
+
+    /*! Advances a fork one step.
+     * @return True if the replication went well.
+     */
+    bool advance_fork(uint fork, uint time);
+
+    /*! Computes how many of the steps following time a fork can take without
+     * reaching a replicated base, the end of its Chromosome or a head-to-head
+     * RNAP.
+     * @see ReplicationFork::idle_steps
+     */
+    uint fork_idle_steps(uint fork, uint time, uint period, uint limit);
+
   public:
     uint n_forks, n_free_forks;
-    std::vector<std::shared_ptr<ReplicationFork>> replication_forks;
     uint metric_times_attached, metric_times_detached_normal,
         metric_times_detached_collision;
 
   public:
     ForkManager(uint n_forks, std::shared_ptr<Genome> genome, uint speed);
 
+    /*! Gives access to one of the forks.
+     * @param uint index The index of the fork, less than n_forks.
+     * @return A ReplicationFork that refers to the fork in this manager.
+     */
+    ReplicationFork get_fork(uint index);
+
     /*! This function checks if there is any fork (replication) colliding with
      * any RNAP (transcription) and handles the collision by rainsing the
      * collision counter, changing the activation probability landscape around
@@ -40,13 +113,49 @@ class ForkManager
      */
     void advance_attached_forks(uint time);
 
+    /*! This function moves all attached forks through several idle steps at
+     * once.
+     * @param time The time of the first step.
+     * @param n_steps The number of steps, as returned by idle_steps.
+     * @see idle_steps
+     */
+    void advance_attached_forks(uint time, uint n_steps);
+
+    /*! This function computes how many of the steps following time are
+     * guaranteed to have no fork event: no fork meets another fork, a
+     * chromosome end or an RNAP, and no fork is waiting to be freed.
+     * @param time The current simulation time.
+     * @param period The period of the RNAP carousel, 0 without transcription.
+     * @param limit The maximum number of steps that matter to the caller.
+     * @return uint The number of idle steps, at most limit.
+     */
+    uint idle_steps(uint time, uint period, uint limit);
+
     /*! This function attaches available forks to a given genomic location. If
-     * there are not enough forks, the just one or none is attached.
+     * there are not enough forks, the just one or none is attached. The free
+     * forks with the lowest indexes are used.
      * @param genomic_location The location where the fork will be attached.
      * @param time The simulation time when the attachment was done.
      * @see GenomicLocation
      */
-    void attach_forks(GenomicLocation &location, uint time);
+    void attach_forks(const GenomicLocation &location, uint time);
+
+    /*! Detaches every fork and clears the metrics, as they were when the
+     * ForkManager was built, for the Genome to be simulated again. The
+     * ForkEventLog, if any, is cleared too.
+     */
+    void reset();
+
+    /*! Makes the forks record their runs in a ForkEventLog from now on.
+     * @param event_log The log, or nullptr to record nothing.
+     */
+    void set_event_log(std::shared_ptr<ForkEventLog> event_log);
+
+    /*! Ends the runs of the forks that are still attached, at the base they
+     * are at, as FORK_RUN_ATTACHED. Meant for the end of the S-phase, the
+     * forks themselves are left as they are.
+     */
+    void log_attached_forks();
 };
 
 #endif
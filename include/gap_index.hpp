@@ -0,0 +1,101 @@
+/*! File gap_index.hpp
+ *  Contains the GapIndex class.
+ */
+#ifndef __GAP_INDEX_HPP__
+#define __GAP_INDEX_HPP__
+
+#include "util.hpp"
+#include <vector>
+
+/*! A run of unreplicated bases, from first to last, stored as a node of the
+ * GapIndex treap. Children are indexes into the node pool, -1 if absent.
+ */
+typedef struct
+{
+    uint first;
+    uint last;
+    unsigned long long total;
+    unsigned int priority;
+    int left;
+    int right;
+
+} gap_node_t;
+
+/*! The GapIndex class keeps the unreplicated gaps of a Chromosome ordered by
+ * position, along with the number of bases under each subtree. It finds the
+ * n-th unreplicated base in time logarithmic on the number of gaps, and is
+ * kept up to date as runs of bases get replicated.
+ */
+class GapIndex
+{
+  private:
+    // Node pool of the treap and the nodes that can be reused
+    std::vector<gap_node_t> nodes;
+    std::vector<int> free_nodes;
+    int root;
+
+    // State of the generator of node priorities, independent from the
+    // simulation so that the index does not change its random sequence
+    unsigned int priority_state;
+
+    unsigned long long total_of(int node) const;
+    void update(int node);
+    int new_node(uint first, uint last);
+
+    /*! Splits a subtree in the gaps that start before key and the others.
+     */
+    void split(int node, uint key, int &left, int &right);
+
+    /*! Joins two subtrees, all gaps of left being before those of right.
+     */
+    int merge(int left, int right);
+
+    void insert(uint first, uint last);
+    void erase(uint first);
+
+  public:
+    /*! The constructor of an empty index.
+     */
+    GapIndex();
+
+    /*! The constructor.
+     * @param uint length The number of bases, all of them unreplicated.
+     */
+    GapIndex(uint length);
+
+    /*! The constructor from a list of gaps.
+     * @param vector gaps The first and last base of each gap, sorted and
+     * disjoint.
+     */
+    GapIndex(const std::vector<std::pair<uint, uint>> &gaps);
+
+    /*! Query the number of gaps.
+     * @return The number of runs of unreplicated bases.
+     */
+    uint size() const;
+
+    /*! Query the number of unreplicated bases.
+     * @return The sum of the length of all gaps.
+     */
+    unsigned long long total() const;
+
+    /*! Removes a run of bases from the gap that holds them, shrinking or
+     * splitting it.
+     * @param uint first The first base of the run.
+     * @param uint last The last base of the run.
+     */
+    void remove(uint first, uint last);
+
+    /*! Finds an unreplicated base by its rank.
+     * @param unsigned long long rank A value in [0, total()).
+     * @return The rank-th unreplicated base, counting from the start.
+     */
+    uint find(unsigned long long rank) const;
+
+    /*! Query the gaps, sorted by position.
+     * @return The first and last base of each gap.
+     */
+    std::vector<std::pair<uint, uint>> get_gaps() const;
+};
+
+#endif
@@ -4,12 +4,28 @@
 #ifndef __GENOME_HPP__
 #define __GENOME_HPP__
 
+#include "alias_table.hpp"
 #include "chromosome.hpp"
 #include "genomic_location.hpp"
+#include "random_generator.hpp"
 #include <memory>
 #include <random>
 #include <vector>
 
+/*! The candidates of a batch of firing attempts, one entry per attempt in
+ * each array, so that they are drawn and tested in bulk.
+ */
+typedef struct
+{
+    std::vector<uint> chromosomes;
+    std::vector<uint> bases;
+    std::vector<double> thresholds;
+    std::vector<double> probabilities;
+    std::vector<char> accepted;
+    std::vector<uint64_t> words;
+
+} candidate_batch_t;
+
 /*! This class represents a Genome.
  * It stores a set of Chromosomes and has methods to manipulate, replicate and
  * verify a Genome.
@@ -17,9 +33,19 @@
 class Genome
 {
   private:
-    std::mt19937 rand_generator;
+    RandomGenerator rand_generator;
     std::discrete_distribution<int> chromosome_distribution;
     std::uniform_int_distribution<int> base_distribution;
+    AliasTable chromosome_table;
+
+    // Draw activation candidates from the Chromosomes' sum trees
+    bool activation_sampling;
+
+    // Draw activation candidates among the unreplicated bases only
+    bool gap_sampling;
+
+    // Unreplicated bases of all Chromosomes, kept by the Chromosomes
+    std::shared_ptr<unsigned long long> n_unreplicated_bases;
 
   public:
     std::vector<std::shared_ptr<Chromosome>> chromosomes;
@@ -43,7 +69,7 @@ class Genome
      * @return A GenomicLocation object referencing the random base selected.
      * @see GenomicLocation
      */
-    std::shared_ptr<GenomicLocation> random_genomic_location();
+    GenomicLocation random_genomic_location();
 
     /*! This function chooses a random UNREPLICATED base from a random
      *Chromosome. It assumes that the genome is not completely replicated yet.
@@ -51,10 +77,75 @@ class Genome
      * @return A GenomicLocation object referencing the random base selected.
      * @see GenomicLocation
      */
-    std::shared_ptr<GenomicLocation> random_unreplicated_genomic_location();
+    GenomicLocation random_unreplicated_genomic_location();
+
+    /*! Draws a batch of firing attempts on the probability landscape: a
+     * Chromosome from an alias table of the Chromosome sizes, a uniform base
+     * in it and a uniform threshold each. A candidate is accepted if its
+     * threshold is below the activation probability of its base, which is
+     * tested for the whole batch at once. Whether the base is replicated is
+     * left to the caller.
+     * @param uint n The number of candidates.
+     * @param candidate_batch_t batch Where the candidates are written, its
+     * arrays are reused from batch to batch.
+     */
+    void random_candidates(uint n, candidate_batch_t &batch);
+
+    /*! Builds a GenomicLocation that draws from the Genome's generator.
+     * @param uint chromosome The index of the Chromosome.
+     * @param uint base The base.
+     * @return The location.
+     */
+    GenomicLocation location(uint chromosome, uint base);
+
+    /*! Upper bound on the chance of a firing attempt succeeding, multiplied
+     * by the size of the Genome. With the probability landscape it is the
+     * exact activation probability summed over the unreplicated bases; with
+     * constitutive origins it is the number of bases around unfired origins.
+     * @param Boolean use_constitutive_origins True if uses this type of origin.
+     * @param int origins_range Considered range around a constitutive origin.
+     * @return The activation bound, in bases.
+     * @see random_activation_candidate
+     */
+    double activation_bound(bool use_constitutive_origins, uint origins_range);
+
+    /*! Makes random_activation_candidate draw from a sum tree of the
+     * activation probability of the unreplicated bases instead of rejecting
+     * random bases. It only applies to the probability landscape.
+     * @see Chromosome::enable_activation_sampling
+     */
+    void enable_activation_sampling();
+
+    /*! Makes random_activation_candidate draw uniform bases among the
+     * unreplicated ones, from the Chromosomes' gap indexes, and reject them
+     * by their activation probability. It only applies to the probability
+     * landscape.
+     * @see Chromosome::enable_gap_sampling
+     */
+    void enable_gap_sampling();
+
+    /*! Draws the location of a firing attempt given that it passed the
+     * activation_bound. The attempt succeeds if the location is still
+     * unreplicated when it is made.
+     * @param Boolean use_constitutive_origins True if uses this type of origin.
+     * @param int origins_range Considered range around a constitutive origin.
+     * @return A GenomicLocation where an origin may fire.
+     * @throw runtime_error if no unreplicated base has activation mass, or
+     * no constitutive origin is left to fire.
+     * @see activation_bound
+     */
+    GenomicLocation random_activation_candidate(bool use_constitutive_origins,
+                                                uint origins_range);
+
+    /*! Draws how many attempts fail before the first one succeeds.
+     * @param double success_probability The chance of each attempt.
+     * @return The number of failed attempts.
+     */
+    unsigned long long random_failed_attempts(double success_probability);
 
     /*! Checks if the Genome is entirely replicated.
-     * It checks if all Chromosomes are completely replicated.
+     * It checks the count of unreplicated bases the Chromosomes keep, in
+     * constant time.
      * @return True if all bases of all Chromosomes have been replicated.
      * @see Chromosome
      */
@@ -70,6 +161,20 @@ class Genome
      * @return The number of constitutive origins in the whole genome.
      */
     uint n_constitutive_origins();
+
+    /*! Brings the Genome back to the state it was built in, as if it was
+     * built again with another seed, keeping its Chromosomes and samplers.
+     * @param seed The seed of the random generator.
+     * @see Chromosome::reset
+     */
+    void reset(unsigned long long seed);
+
+    /*! Brings the Genome back to the state it was built in, drawing from
+     * another random generator, such as a counter based one.
+     * @param rand_generator The random generator of the new cell.
+     * @see reset
+     */
+    void reset(const RandomGenerator &rand_generator);
 };
 
 #endif
@@ -0,0 +1,143 @@
+/*! File genome_cache.hpp
+ *  Contains the GenomeCache class.
+ */
+#ifndef __GENOME_CACHE_HPP__
+#define __GENOME_CACHE_HPP__
+
+#include "chromosome.hpp"
+#include "data_provider.hpp"
+#include "util.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Identifies the cache format and its version
+#define GENOME_CACHE_MAGIC 0x47444552 // "REDG"
+#define GENOME_CACHE_VERSION 1
+
+/*! Header at the start of a cache file.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_hash;
+    double uniform;
+    uint64_t n_chromosomes;
+
+} genome_cache_header_t;
+
+/*! Entry of a Chromosome in the table that follows the header. Offsets are
+ * counted from the start of the file.
+ */
+typedef struct
+{
+    uint64_t code_offset;
+    uint64_t code_size;
+    uint64_t length;
+    uint64_t landscape_offset;
+    uint64_t regions_offset;
+    uint64_t n_regions;
+    uint64_t origins_offset;
+    uint64_t n_origins;
+
+} genome_cache_entry_t;
+
+/*! The GenomeCache class reads a preprocessed organism: the length,
+ * probability landscape, transcription regions and constitutive origins of
+ * each Chromosome, stored in a binary file that is memory mapped, so that
+ * the landscapes are read straight from the page cache and shared by every
+ * process that opens the same file. Files are written by write and identified
+ * by a hash of the data they were made from.
+ */
+class GenomeCache
+{
+  private:
+    const char *mapping;
+    size_t mapping_size;
+
+    std::vector<std::string> codes;
+    std::unordered_map<std::string, const genome_cache_entry_t *> entries;
+
+    const genome_cache_header_t *header();
+    const genome_cache_entry_t *entry(std::string code);
+
+  public:
+    /*! The constructor. Maps the file and checks its layout.
+     * @param string path The path of the cache file.
+     * @throw runtime_error if the file can not be mapped or is not valid.
+     */
+    GenomeCache(std::string path);
+    ~GenomeCache();
+
+    GenomeCache(const GenomeCache &) = delete;
+    GenomeCache &operator=(const GenomeCache &) = delete;
+
+    /*! Writes the data of a provider to a cache file. The file is written
+     * under another name and then renamed, so readers never see it partly
+     * written.
+     * @param string path The path of the cache file.
+     * @param unsigned long long source_hash The hash of the source data.
+     * @param double uniform The uniform probability the landscapes were made
+     * with, 0 if none.
+     * @param DataProvider provider The provider of the data.
+     * @throw runtime_error if the file can not be written.
+     */
+    static void write(std::string path, unsigned long long source_hash,
+                      double uniform, DataProvider &provider);
+
+    /*! Computes a hash of the contents of the database and of the MFA-Seq
+     * files of some Chromosomes.
+     * @param string organism The organism.
+     * @param string database_path The path of the database file.
+     * @param string mfa_seq_data_path The folder of the MFA-Seq files.
+     * @param vector codes The codes of the Chromosomes.
+     * @return The hash.
+     * @throw runtime_error if a file can not be read.
+     */
+    static unsigned long long
+    source_hash(std::string organism, std::string database_path,
+                std::string mfa_seq_data_path,
+                const std::vector<std::string> &codes);
+
+    /*! Query the hash of the data the file was made from.
+     * @return The hash given to write.
+     */
+    unsigned long long get_source_hash();
+
+    /*! Query the uniform probability the landscapes were made with.
+     * @return The uniform probability given to write.
+     */
+    double get_uniform();
+
+    /*! Query the codes of the Chromosomes, in the order of the provider.
+     * @return The codes.
+     */
+    const std::vector<std::string> &get_codes();
+
+    /*! Query the length of a Chromosome.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    int get_length(std::string code);
+
+    /*! Gives the probability landscape of a Chromosome, which lives in the
+     * mapped file.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    landscape_view_t get_landscape(std::string code);
+
+    /*! Gives a copy of the transcription regions of a Chromosome.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    std::vector<transcription_region_t>
+    get_transcription_regions(std::string code);
+
+    /*! Gives a copy of the constitutive origins of a Chromosome.
+     * @throw out_of_range if there is no such Chromosome.
+     */
+    std::vector<constitutive_origin_t>
+    get_constitutive_origins(std::string code);
+};
+
+#endif
@@ -2,22 +2,25 @@
 #define __GENOMIC_LOCATION_HPP__
 
 #include "chromosome.hpp"
+#include "random_generator.hpp"
 #include "util.hpp"
 #include <random>
 
 /*! This class represents a base from a chromosome called a Genomic Location.
  * It stores a set of Chromosomes and has methods to check and query a base
- * from a Genome.
+ * from a Genome. It is a plain value that points to its Chromosome without
+ * owning it, so it is copied without allocating or counting references and
+ * must not outlive the Genome the Chromosome belongs to.
  */
 class GenomicLocation
 {
   private:
-    std::mt19937 *rand_generator;
+    RandomGenerator *rand_generator;
     static std::uniform_real_distribution<double> rand_distribution;
 
   public:
     uint base;
-    std::shared_ptr<Chromosome> chromosome;
+    Chromosome *chromosome;
 
   public:
     /*! The constructor.
@@ -27,8 +30,15 @@ class GenomicLocation
      * @throw invalid_argument If base doesn't belong to chromosome.
      * @see Chromosome
      */
-    GenomicLocation(uint base, std::shared_ptr<Chromosome> chromosome,
-                    std::mt19937 *rand_generator);
+    GenomicLocation(uint base, Chromosome *chromosome,
+                    RandomGenerator *rand_generator);
+
+    /*! The constructor from a shared Chromosome, which the location does not
+     * keep alive.
+     * @see GenomicLocation
+     */
+    GenomicLocation(uint base, const std::shared_ptr<Chromosome> &chromosome,
+                    RandomGenerator *rand_generator);
 
     /*! Queries if the genomic location base has been replicated.
      * @return True if the base is replicated.
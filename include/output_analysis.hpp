@@ -0,0 +1,92 @@
+/*! File output_analysis.hpp
+ *  Contains the analyses of the outputs of the simulator made by the analyze
+ *  tool: the distances between origins and collisions, and the aggregates of
+ *  the cells of a run.
+ */
+#ifndef __OUTPUT_ANALYSIS_HPP__
+#define __OUTPUT_ANALYSIS_HPP__
+
+#include "output_reader.hpp"
+#include "util.hpp"
+#include <string>
+#include <vector>
+
+/*! Median, mean and sample standard deviation of a set of distances.
+ */
+typedef struct
+{
+    double median;
+    double mean;
+    double sd;
+
+} distance_stats_t;
+
+/*! The cells of a run that share a number of forks and a speed, with the
+ * sums of their times and inter-origin distances and of their squares.
+ */
+typedef struct
+{
+    unsigned long long resources;
+    unsigned long long speed;
+    double time_sum;
+    double interorigin_distance_sum;
+    double time_squares;
+    double interorigin_distance_squares;
+    unsigned long long cells;
+
+} cell_aggregate_t;
+
+/*! Finds the streaks of a Chromosome in one direction: the bases from a
+ * local minimum of the replication times, an origin, up to a base after
+ * which the times jump by more than one, where the fork is taken to have
+ * collided with an RNAP. This is the detection of
+ * script/collision_distance_median.py, which is run on the times read in
+ * both directions.
+ * @param vector times The replication time of each base.
+ * @param vector distances Where the length of each streak is appended.
+ * @return The number of streaks found.
+ */
+uint find_streaks(const std::vector<int> &times, std::vector<uint> &distances);
+
+/*! Finds the streaks of a Chromosome in both directions.
+ * @param vector times The replication time of each base.
+ * @param vector distances Where the length of each streak is appended.
+ * @see find_streaks
+ */
+void collision_distances(const std::vector<int> &times,
+                         std::vector<uint> &distances);
+
+/*! Computes the statistics of a set of distances as Python's statistics
+ * module does: the median of an even count is the mean of the two middle
+ * values. With no distances everything is 0, and so is the standard
+ * deviation of a single one.
+ * @param vector distances The distances, reordered.
+ * @return The statistics.
+ */
+distance_stats_t distance_statistics(std::vector<uint> &distances);
+
+/*! Formats distance statistics as "median\tmean\tsd", each with one decimal,
+ * like script/collision_distance_median_parallel.py.
+ * @param distance_stats_t stats The statistics.
+ * @return The text, without line break.
+ */
+std::string to_string(const distance_stats_t &stats);
+
+/*! Gathers cells by number of forks and speed.
+ * @param vector cells The cells of a run.
+ * @return One aggregate per number of forks and speed, in the order they
+ * first appear among the cells.
+ */
+std::vector<cell_aggregate_t>
+aggregate_cells(const std::vector<cell_record_t> &cells);
+
+/*! Formats an aggregate like script/cell_output_aggregator.py: number of
+ * forks, speed, mean and standard deviation of the time, mean and standard
+ * deviation of the inter-origin distance, each with two decimals, and number
+ * of cells, separated by tabs.
+ * @param cell_aggregate_t aggregate The aggregate.
+ * @return The text, without the tab the script ends it with.
+ */
+std::string to_string(const cell_aggregate_t &aggregate);
+
+#endif
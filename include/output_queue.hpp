@@ -0,0 +1,63 @@
+/*! File output_queue.hpp
+ *  Contains the OutputQueue class.
+ */
+#ifndef __OUTPUT_QUEUE_HPP__
+#define __OUTPUT_QUEUE_HPP__
+
+#include "util.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! The OutputQueue class runs output jobs, such as encoding and writing the
+ * results of a cell, on dedicated writer threads, so that the threads that
+ * simulate can go on to the next cell. The queue is bounded: when it is full,
+ * push waits for a writer to take a job.
+ */
+class OutputQueue
+{
+  private:
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> writers;
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+    uint capacity;
+    bool closed;
+
+    // The first exception thrown by a job
+    std::exception_ptr error;
+
+    /*! The loop of a writer thread.
+     */
+    void run();
+
+  public:
+    /*! The constructor. Starts the writer threads.
+     * @param uint capacity The maximum number of jobs waiting in the queue.
+     * @param uint n_writers The number of writer threads.
+     * @throw invalid_argument if capacity or n_writers is 0.
+     */
+    OutputQueue(uint capacity, uint n_writers);
+
+    /*! The destructor. Waits for the jobs left, like close, but does not throw.
+     */
+    ~OutputQueue();
+
+    /*! Adds a job to the queue, waiting while the queue is full.
+     * @param function job The job.
+     * @throw runtime_error if the queue was closed.
+     */
+    void push(std::function<void()> job);
+
+    /*! Waits for all the jobs and stops the writer threads. No jobs can be
+     * pushed after this.
+     * @throw The first exception thrown by a job, if any.
+     */
+    void close();
+};
+
+#endif
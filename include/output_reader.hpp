@@ -0,0 +1,117 @@
+/*! File output_reader.hpp
+ *  Contains the MappedFile class and the functions that read the outputs of
+ *  the simulator, shared by the analysis tools.
+ */
+#ifndef __OUTPUT_READER_HPP__
+#define __OUTPUT_READER_HPP__
+
+#include "util.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*! The line of a cell.txt file: the number of forks and their speed, the
+ * time the S-phase took and the average inter-origin distance of the cell.
+ */
+typedef struct
+{
+    unsigned long long resources;
+    unsigned long long speed;
+    double time;
+    double interorigin_distance;
+
+} cell_record_t;
+
+/*! The MappedFile class maps a whole file in memory, read only, so that it
+ * can be parsed without copying it.
+ */
+class MappedFile
+{
+  private:
+    const char *bytes;
+    size_t length;
+
+  public:
+    /*! The constructor. Maps the file.
+     * @param string path The path of the file.
+     * @throw runtime_error if the file can not be opened or mapped.
+     */
+    MappedFile(std::string path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /*! Query the contents of the file.
+     * @return The first byte of the file, nullptr if it is empty.
+     */
+    const char *data() const;
+
+    /*! Query the size of the file.
+     * @return The number of bytes of the file.
+     */
+    size_t size() const;
+};
+
+/*! Parses replication times written one per line, as in the files of older
+ * versions of the simulator. Blank lines are skipped.
+ * @param char begin The first character of the text.
+ * @param char end The character after the last one.
+ * @return The time of each base.
+ * @throw runtime_error if a line is not an integer.
+ */
+std::vector<int> parse_base_times(const char *begin, const char *end);
+
+/*! Parses the records of a .cseq file and expands them.
+ * @param char begin The first character of the text.
+ * @param char end The character after the last one.
+ * @return The time of each base, -1 for unreplicated ones.
+ * @throw runtime_error if a line is not a record.
+ * @see to_string(const timing_record_t &)
+ */
+std::vector<int> parse_cseq(const char *begin, const char *end);
+
+/*! Reads the replication times of a Chromosome from any of the files the
+ * simulator writes them to, chosen by extension: .cseq, .cseq.zst, .events
+ * or .txt with one time per line.
+ * @param string path The path of the file.
+ * @return The time of each base, -1 for unreplicated ones.
+ * @throw invalid_argument if the extension is not one of those.
+ * @throw runtime_error if the file can not be read or is not valid.
+ */
+std::vector<int> read_replication_times(std::string path);
+
+/*! Reads the lines of a cell.txt file, up to the first empty one.
+ * @param string path The path of the file.
+ * @return The records of the file.
+ * @throw runtime_error if the file can not be read or a line is not valid.
+ */
+std::vector<cell_record_t> read_cell_file(std::string path);
+
+/*! Lists the simulation folders of a run, which are its subfolders.
+ * @param string run_folder The folder of the run.
+ * @return The paths of the simulation folders, sorted.
+ * @throw filesystem_error if run_folder can not be listed.
+ */
+std::vector<std::string> simulation_folders(std::string run_folder);
+
+/*! Lists the files of a simulation folder that hold the replication times
+ * of a Chromosome, in any format read_replication_times reads.
+ * @param string simulation_folder The folder of the simulation.
+ * @return The paths of the files, sorted.
+ * @throw filesystem_error if simulation_folder can not be listed.
+ */
+std::vector<std::string> timing_files(std::string simulation_folder);
+
+/*! Calls job with every index from 0 to n_jobs - 1, with each thread taking
+ * the next index when it is done with one.
+ * @param size_t n_jobs The number of jobs.
+ * @param uint n_threads The number of threads, at least 1.
+ * @param function job Called as job(index).
+ * @throw The first exception thrown by a job, once all threads stopped.
+ */
+void parallel_for(size_t n_jobs, uint n_threads,
+                  std::function<void(size_t)> job);
+
+#endif
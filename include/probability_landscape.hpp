@@ -0,0 +1,79 @@
+/*! File probability_landscape.hpp
+ *  Contains the ProbabilityLandscape class.
+ */
+#ifndef __PROBABILITY_LANDSCAPE_HPP__
+#define __PROBABILITY_LANDSCAPE_HPP__
+
+#include "buffer_pool.hpp"
+#include "util.hpp"
+#include <vector>
+
+// Number of bases in a copy-on-write page, as a power of two
+#define LANDSCAPE_PAGE_BITS 12
+
+/*! A read only array with the activation probability of each base, which
+ * may be stored in a vector or in a memory mapped file.
+ */
+typedef struct
+{
+    const double *data;
+    uint size;
+
+} landscape_view_t;
+
+/*! The ProbabilityLandscape class gives a Chromosome its own view of the
+ * activation probability of each base. The base landscape belongs to the
+ * DataProvider and is shared, read only, by every cell. Changes made by
+ * dormant origin activation go to private copies of the pages they touch.
+ */
+class ProbabilityLandscape
+{
+  private:
+    landscape_view_t shared_landscape;
+
+    // Private copy of each modified page, empty while the page is shared
+    std::vector<pool_vector<double>> pages;
+
+  public:
+    /*! The constructor.
+     * @param vector shared_landscape The base landscape. It must outlive this
+     * object and must not change while it is in use.
+     */
+    ProbabilityLandscape(const std::vector<double> &shared_landscape);
+
+    /*! The constructor.
+     * @param landscape_view_t shared_landscape The base landscape. It must
+     * outlive this object and must not change while it is in use.
+     */
+    ProbabilityLandscape(landscape_view_t shared_landscape);
+
+    /*! Query the number of bases of the landscape.
+     * @return The length of the landscape.
+     */
+    uint size();
+
+    /*! Query the activation probability of a base.
+     * @param uint base The index of the base.
+     * @return The probability, with local changes applied.
+     */
+    double operator[](uint base);
+
+    /*! Changes the activation probability of a base, copying its page from
+     * the shared landscape first if needed.
+     * @param uint base The index of the base.
+     * @param double probability The new probability.
+     */
+    void set(uint base, double probability);
+
+    /*! Query how many pages were copied from the shared landscape.
+     * @return The number of private pages.
+     */
+    uint n_copied_pages();
+
+    /*! Drops the changes, sharing every page again. The memory of the
+     * copied pages is kept for the next changes.
+     */
+    void reset();
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*! File quantile_sketch.hpp
+ *  Contains the QuantileSketch class.
+ */
+#ifndef __QUANTILE_SKETCH_HPP__
+#define __QUANTILE_SKETCH_HPP__
+
+#include "util.hpp"
+#include <utility>
+#include <vector>
+
+// Values below 2^(SKETCH_SUB_BITS + 1) are kept exactly, larger ones in
+// 2^SKETCH_SUB_BITS buckets per power of two
+#define SKETCH_SUB_BITS 6
+
+/*! The QuantileSketch class estimates quantiles of a stream of non negative
+ * integers from the counts of logarithmic buckets, each at most 1/64 of its
+ * values wide, so an estimate is at most about 1% off. Only the buckets that
+ * hold values are stored, which keeps it small when the values are close
+ * together. Sketches are merged by adding their counts, so the result does
+ * not depend on the order values were added or sketches merged in.
+ */
+class QuantileSketch
+{
+  private:
+    // Non empty buckets and their counts, sorted by bucket
+    std::vector<std::pair<uint, unsigned long long>> buckets;
+    unsigned long long n;
+
+    void add(uint bucket, unsigned long long count);
+
+  public:
+    /*! The constructor of an empty sketch.
+     */
+    QuantileSketch();
+
+    /*! Adds a value.
+     * @param unsigned long long value The value.
+     */
+    void add(unsigned long long value);
+
+    /*! Adds all the values of another sketch.
+     * @param QuantileSketch other The sketch to merge into this one.
+     */
+    void merge(const QuantileSketch &other);
+
+    /*! Query the number of values.
+     * @return How many values were added.
+     */
+    unsigned long long count() const;
+
+    /*! Estimates a quantile, as the middle of the bucket holding the value
+     * of rank q * (count() - 1).
+     * @param double q The quantile, between 0 and 1.
+     * @return The estimate, 0 if there are no values.
+     * @throw invalid_argument if q is not between 0 and 1.
+     */
+    double quantile(double q) const;
+
+    /*! Finds the bucket of a value, with the log-linear bins of
+     * SKETCH_SUB_BITS.
+     * @param unsigned long long value The value.
+     * @return The bucket the value falls in.
+     */
+    static uint bucket(unsigned long long value);
+
+    /*! Finds the smallest value of a bucket.
+     * @param uint bucket The bucket.
+     * @return The smallest value that falls in the bucket.
+     */
+    static unsigned long long bucket_lower_bound(uint bucket);
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*! File random_generator.hpp
+ *  Contains the RandomGenerator class.
+ */
+#ifndef __RANDOM_GENERATOR_HPP__
+#define __RANDOM_GENERATOR_HPP__
+
+#include "util.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+
+// Largest generation and stream a counter based generator can be keyed by
+#define RNG_MAX_GENERATION ((1ULL << 24) - 1)
+#define RNG_MAX_STREAM 255
+
+// Streams of a cell, so that each use draws its own numbers
+#define RNG_STREAM_GENOME 0
+
+/*! The RandomGenerator class is the random number generator of a cell. It is
+ * either a Mersenne Twister seeded with a single number, as it always was, or
+ * a counter based Philox4x32-10 generator keyed by the global seed, the cell,
+ * the generation and a stream. The n-th number of a counter based generator
+ * is a pure function of those coordinates and of n, so it holds only its key
+ * and counter, can jump to any position and gives the same cells no matter
+ * how they are spread among threads. The state of a Mersenne Twister is only
+ * allocated by the generators that use it.
+ */
+class RandomGenerator
+{
+  public:
+    typedef std::mt19937::result_type result_type;
+
+  private:
+    // Null for a counter based generator
+    std::unique_ptr<std::mt19937> twister;
+
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t block[4];
+    unsigned long long block_index;
+    unsigned long long position;
+
+    void generate_block();
+
+  public:
+    /*! Builds a Mersenne Twister generator.
+     * @param unsigned long long seed The seed of the generator.
+     */
+    RandomGenerator(unsigned long long seed = 0);
+
+    /*! Builds a counter based generator.
+     * @param unsigned long long seed The global seed.
+     * @param unsigned long long cell The number of the cell.
+     * @param unsigned long long generation The generation of an evolution,
+     * 0 otherwise.
+     * @param uint stream Which of the streams of the cell.
+     * @throw invalid_argument if the cell does not fit in 32 bits or the
+     * generation or stream are larger than RNG_MAX_GENERATION and
+     * RNG_MAX_STREAM.
+     */
+    RandomGenerator(unsigned long long seed, unsigned long long cell,
+                    unsigned long long generation, uint stream);
+
+    RandomGenerator(const RandomGenerator &other);
+    RandomGenerator(RandomGenerator &&other) = default;
+    RandomGenerator &operator=(const RandomGenerator &other);
+    RandomGenerator &operator=(RandomGenerator &&other) = default;
+
+    /*! Query if the generator is counter based.
+     * @return True for Philox, false for the Mersenne Twister.
+     */
+    bool is_counter_based() const;
+
+    /*! Skips numbers. A counter based generator jumps there in constant time.
+     * @param unsigned long long n How many numbers to skip.
+     */
+    void discard(unsigned long long n);
+
+    /*! Draws 64 bit words, each made of two consecutive numbers, the first
+     * one in the high half. A counter based generator computes whole blocks
+     * at once, which the compiler can vectorize.
+     * @param uint64_t* words Where the words are written.
+     * @param size_t n How many words to draw.
+     */
+    void fill(uint64_t *words, size_t n);
+
+    /*! Computes one Philox4x32-10 block.
+     * @param counter The 128 bit counter, lowest word first.
+     * @param key The 64 bit key, lowest word first.
+     * @param result Where the four random words are written.
+     */
+    static void philox(const uint32_t counter[4], const uint32_t key[2],
+                       uint32_t result[4]);
+
+    static constexpr result_type min() { return std::mt19937::min(); }
+    static constexpr result_type max() { return std::mt19937::max(); }
+
+    result_type operator()()
+    {
+        if (twister) return (*twister)();
+
+        if (position / 4 != block_index) generate_block();
+        return block[position++ % 4];
+    }
+};
+
+#endif
@@ -7,26 +7,23 @@
 // Forward declaration
 class ForkManager;
 
-/*! This class represents a replication fork.
+/*! This class represents a replication fork. It refers to a row of the fork
+ * table of a ForkManager, which holds the state of the fork, so it is cheap
+ * to copy and stays valid as long as the ForkManager.
  */
 class ReplicationFork
 {
   private:
-    std::shared_ptr<Genome> genome;
-    std::shared_ptr<Chromosome> chromosome;
     ForkManager *fork_manager;
-    uint speed;
-    int base, direction;
-    bool just_detached;
+    uint index;
 
   public:
     /*! The constructor.
-     * @param Genome genome The Genome to which this fork belongs to.
-     * @param int speed The speed, in bases per step, at which the
-     * fork replicates.
+     * @param ForkManager fork_manager The manager that owns the fork.
+     * @param uint index The index of the fork in the manager.
+     * @throw out_of_range if there is no such fork.
      */
-    ReplicationFork(std::shared_ptr<Genome> genome, ForkManager *fork_manager,
-                    uint speed);
+    ReplicationFork(ForkManager *fork_manager, uint index);
 
     /*! This function assigns the fork to a given base and chromosome
      * (genomic location) and replicates this base right away.
@@ -37,7 +34,7 @@ class ReplicationFork
      * @param int time The time when this attachment occurs in the simulation.
      * @throw invalid_argument if fork is already attached
      */
-    void attach(GenomicLocation &gen_loc, int direction, uint time);
+    void attach(const GenomicLocation &gen_loc, int direction, uint time);
 
     /*! direction getter.*/
     int get_direction();
@@ -62,6 +59,18 @@ class ReplicationFork
      */
     bool advance(uint time);
 
+    /*! Computes how many of the steps following time this fork can take
+     * without reaching a replicated base, the end of its Chromosome or a
+     * head-to-head RNAP. Another fork may be closing the same gap from the
+     * other side, so the gap is assumed to shrink twice as fast.
+     * @param int time The current simulation time.
+     * @param int period The period of the RNAP carousel, 0 without
+     * transcription.
+     * @param int limit The maximum number of steps that matter to the caller.
+     * @return The number of event free steps, at most limit.
+     */
+    uint idle_steps(uint time, uint period, uint limit);
+
     /*! This function queries the attachment status of the fork.
      * @return True if the fork is attached to some base in any chromosome.
      */
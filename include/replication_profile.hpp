@@ -0,0 +1,93 @@
+/*! File replication_profile.hpp
+ *  Contains the ReplicationProfile class.
+ */
+#ifndef __REPLICATION_PROFILE_HPP__
+#define __REPLICATION_PROFILE_HPP__
+
+#include "genome.hpp"
+#include "quantile_sketch.hpp"
+#include "strand.hpp"
+#include "summary_statistic.hpp"
+#include "util.hpp"
+#include <string>
+#include <vector>
+
+/*! The statistics of one bin of a ReplicationProfile, over the cells that
+ * replicated any of its bases.
+ */
+typedef struct
+{
+    // The sketch gives finer quantiles than a histogram
+    SummaryStatistic times = SummaryStatistic(false);
+    QuantileSketch sketch;
+} profile_bin_t;
+
+/*! The ReplicationProfile class gathers the replication timing of many cells
+ * along the genome, in bins of a fixed number of bases, as is done to compare
+ * simulations with MFA-Seq. The time of a bin in a cell is the mean time its
+ * replicated bases were replicated at, rounded to an iteration, and the
+ * profile keeps the mean, variance and a median sketch of those times over
+ * the cells. The moments are those of a SummaryStatistic, so profiles filled
+ * by different threads merge in any order to the same result.
+ */
+class ReplicationProfile
+{
+  private:
+    uint bin_size;
+    std::vector<std::string> codes;
+    std::vector<uint> lengths;
+    std::vector<std::vector<profile_bin_t>> bins;
+
+  public:
+    /*! The constructor of an empty profile. The Chromosomes are taken from
+     * the first Genome added.
+     * @param uint bin_size The number of bases of each bin.
+     * @throw invalid_argument if bin_size is 0.
+     */
+    ReplicationProfile(uint bin_size);
+
+    /*! Adds a replicated cell.
+     * @param Genome genome The Genome at the end of the S-phase.
+     * @throw invalid_argument if its Chromosomes are not those of the
+     * profile.
+     */
+    void add(Genome &genome);
+
+    /*! Adds all the cells of another profile.
+     * @param ReplicationProfile other The profile to merge into this one.
+     * @throw invalid_argument if the profiles have other bins.
+     */
+    void merge(const ReplicationProfile &other);
+
+    /*! Query the Chromosomes of the profile.
+     * @return The code of each Chromosome.
+     */
+    const std::vector<std::string> &get_codes() const;
+
+    /*! Query the bins of a Chromosome. The last one may be shorter.
+     * @param uint chromosome The index of the Chromosome.
+     * @return The statistics of each bin.
+     */
+    const std::vector<profile_bin_t> &get_bins(uint chromosome) const;
+
+    /*! Sums the replication times of the bases of a Strand in each bin, from
+     * its segments instead of base by base.
+     * @param Strand strand The Strand.
+     * @param uint bin_size The number of bases of each bin.
+     * @param vector sums Set to the sum of the times of each bin.
+     * @param vector counts Set to the number of replicated bases of each bin.
+     */
+    static void bin_times(const Strand &strand, uint bin_size,
+                          std::vector<unsigned long long> &sums,
+                          std::vector<uint> &counts);
+
+    /*! Writes one <code>.profile file per Chromosome to a folder, with one
+     * line per bin holding its first and last base, the number of cells
+     * that replicated it and the mean, standard deviation and median of
+     * their times.
+     * @param std::string folder The folder, which is created if needed.
+     */
+    void write(std::string folder) const;
+};
+
+#endif
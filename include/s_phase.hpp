@@ -4,8 +4,12 @@
 #include "chromosome.hpp"
 #include "configuration.hpp"
 #include "data_manager.hpp"
+#include "fork_event_log.hpp"
 #include "fork_manager.hpp"
 #include "genome.hpp"
+#include "output_queue.hpp"
+#include "replication_profile.hpp"
+#include "timing_file.hpp"
 #include "util.hpp"
 #include <vector>
 
@@ -14,8 +18,9 @@
  */
 typedef struct
 {
-    unsigned int collisions = 0;
-    unsigned int time       = 0;
+    unsigned int collisions           = 0;
+    unsigned int time                 = 0;
+    unsigned int interorigin_distance = 0;
 } simulation_stats;
 
 /*! This class represents the whole Synthsis(S) phase of the cell cycle.
@@ -34,36 +39,149 @@ class SPhase
     std::shared_ptr<DataProvider> data;
     std::shared_ptr<Genome> genome;
     std::shared_ptr<ForkManager> fork_manager;
+    std::shared_ptr<OutputQueue> output_queue;
+    std::shared_ptr<ReplicationProfile> profile;
+    std::shared_ptr<ForkEventLog> event_log;
     std::string organism;
     std::string output_folder;
     std::string name;
+    std::string engine;
+    std::string sampler;
+    std::string output_format;
+
+    // Reused by fire_batch from step to step
+    candidate_batch_t candidates;
 
     void initialize(int origins_range, int n_resources, int replication_speed,
                     int timeout, int transcription_period, bool has_dormant,
                     std::shared_ptr<DataProvider> data, std::string organism,
                     std::string name, std::string output_folder);
 
+    /*! Runs the S-phase one step at a time, making one firing attempt per
+     * free fork at every step. With the tree or gap samplers the attempts of
+     * a step are made by fire_attempts instead of one by one, and with the
+     * batch sampler by fire_batch. With constitutive origins every sampler
+     * makes the attempts one by one.
+     * @param time The simulation time, updated until the end of the S-phase.
+     * @param n_collisions The number of collisions, updated.
+     * @param constitutive_origins Number of constitutive origins left to fire.
+     */
+    void simulate_steps(int &time, int &n_collisions,
+                        int &constitutive_origins);
+
+    /*! Runs the S-phase jumping over the steps in which nothing can happen.
+     * Forks are moved in bulk up to the next fork event (fork meeting, end of
+     * chromosome or head-to-head RNAP) or the next successful firing attempt,
+     * whose time is drawn directly instead of attempt by attempt. The result
+     * follows the same distribution as simulate_steps.
+     * @see simulate_steps
+     */
+    void simulate_events(int &time, int &n_collisions,
+                         int &constitutive_origins);
+
+    /*! Makes a number of firing attempts at the current step.
+     * @param n_attempts How many attempts to make.
+     * @param time The current simulation time.
+     * @param constitutive_origins Number of constitutive origins left to fire.
+     */
+    void fire_attempts(int n_attempts, int time, int &constitutive_origins);
+
+    /*! Makes a number of firing attempts on the probability landscape at the
+     * current step, drawing and testing their candidates as one batch. The
+     * accepted candidates whose base is still unreplicated are fired.
+     * @param n_attempts How many attempts to make.
+     * @param time The current simulation time.
+     * @param constitutive_origins Number of constitutive origins left to fire.
+     * @see Genome::random_candidates
+     */
+    void fire_batch(int n_attempts, int time, int &constitutive_origins);
+
+    /*! Fires an origin, attaching two free forks to the given location.
+     * @param location Where the origin fires.
+     * @param time The current simulation time.
+     * @param constitutive_origins Number of constitutive origins left to fire.
+     */
+    void fire_origin(GenomicLocation &location, int time,
+                     int &constitutive_origins);
+
   public:
     SPhase(int origins_range, int n_resources, int replication_speed,
            int timeout, int transcription_period, bool has_dormant,
            std::shared_ptr<DataProvider> data, std::string organism,
            std::string name, std::string output_folder = "output",
-           unsigned long long seed = 0);
+           unsigned long long seed = 0, std::string engine = "step",
+           std::string sampler = "rejection",
+           std::string output_format = "text");
     SPhase(Configuration &configuration, std::shared_ptr<DataProvider> data,
            unsigned long long seed = 0);
     ~SPhase();
 
     simulation_stats get_stats();
 
+    /*! Makes output run as jobs of an OutputQueue instead of in the thread
+     * that simulates.
+     * @param output_queue The queue, or nullptr to output right away.
+     */
+    void set_output_queue(std::shared_ptr<OutputQueue> output_queue);
+
+    /*! Makes every simulated cell be added to a ReplicationProfile.
+     * @param profile The profile, or nullptr to add the cells to none.
+     */
+    void set_profile(std::shared_ptr<ReplicationProfile> profile);
+
+    /*! Saves the results of the cell to its simulation folder, creating it
+     * if needed. With an OutputQueue this only queues the job. The "summary"
+     * format saves nothing, the caller gathers the stats of the cells, and
+     * the "events" format saves the fork runs instead of the replication
+     * times. The cell is also added to the ReplicationProfile, if there is
+     * one.
+     * @param sim_number The number of the cell.
+     * @param time The time the S-phase took.
+     * @param iod The average inter-origin distance.
+     * @param genome The replicated Genome.
+     */
     void output(int sim_number, int time, int iod,
                 std::shared_ptr<Genome> genome);
 
-    void semantic_compression_output(int sim_number, int time, int iod,
-                                     std::shared_ptr<Genome> genome,
-                                     std::string path);
+    /*! Writes the replication times of every Chromosome of a Genome to a
+     * file in path.
+     * @param strands The code and Strand of each Chromosome of the Genome.
+     * @param path The simulation folder, ending with a slash.
+     * @param format "text" for .cseq files or "zst" for .cseq.zst files.
+     */
+    static void semantic_compression_output(
+        std::vector<std::pair<std::string, Strand>> &strands, std::string path,
+        std::string format);
+
+    /*! Writes the fork runs of a cell to a <code>.events file per
+     * Chromosome in path.
+     * @param runs The runs of the cell, reordered.
+     * @param chromosomes The code and length of each Chromosome, by id.
+     * @param speed The speed of the forks.
+     * @param path The simulation folder, ending with a slash.
+     * @see ForkEventLog::write
+     */
+    static void event_log_output(
+        std::vector<fork_run_t> &runs,
+        std::vector<std::pair<std::string, uint>> &chromosomes, uint speed,
+        std::string path);
 
     void simulate(int sim_number);
 
+    /*! Prepares the SPhase to simulate another cell, as if it was built
+     * again with another seed. The Genome, its Chromosomes and the forks are
+     * kept, only their state is cleared.
+     * @param seed The seed of the new cell.
+     */
+    void reset(unsigned long long seed);
+
+    /*! Prepares the SPhase to simulate another cell that draws from the given
+     * random generator, such as a counter based one.
+     * @param rand_generator The random generator of the new cell.
+     * @see reset
+     */
+    void reset(const RandomGenerator &rand_generator);
+
     const s_phase_checkpoints_t getTimes() const;
 };
 
@@ -0,0 +1,123 @@
+/*! File strand.hpp
+ *  Contains the Strand class.
+ */
+#ifndef __STRAND_HPP__
+#define __STRAND_HPP__
+
+#include "buffer_pool.hpp"
+#include "util.hpp"
+#include <vector>
+
+/*! A run of replicated bases written by a single fork, or by a single call
+ * that replicates a range at once. It covers the bases from first to last,
+ * and the base at anchor + direction * i was replicated at
+ * anchor_time + ceil(i / speed), or at anchor_time if speed is 0. The anchor
+ * is the base just before the run, so first or last grows with it.
+ */
+typedef struct
+{
+    int first;
+    int last;
+    int anchor;
+    int direction;
+    uint speed;
+    int anchor_time;
+
+} strand_segment_t;
+
+/*! The Strand class stores the time each base of a Chromosome was replicated
+ * at. Instead of one time per base, it keeps the sorted list of runs the
+ * forks replicated, so its size depends on the number of fired origins and
+ * not on the length of the Chromosome.
+ */
+class Strand
+{
+  private:
+    uint length;
+
+    // Disjoint segments sorted by position
+    pool_vector<strand_segment_t> segments;
+
+    // Index of the last segment found by find, as bases are often read in
+    // order
+    uint hint;
+
+    /*! Finds the first segment that ends at base or after it.
+     * @param uint base The base to look from.
+     * @return The index of the segment, or segments.size() if there is none.
+     */
+    uint first_ending_from(uint base);
+
+    /*! Finds the segment that holds a base.
+     * @param uint base The base to look for.
+     * @return The index of the segment, or segments.size() if the base is
+     * not replicated.
+     */
+    uint find(uint base);
+
+  public:
+    /*! The constructor.
+     * @param uint length The number of bases, all of them unreplicated.
+     */
+    Strand(uint length);
+
+    /*! Query the number of bases of the Strand.
+     * @return The length of the Strand.
+     */
+    uint size() const;
+
+    /*! Query the replication time of a base.
+     * @param uint base The index of the base.
+     * @return The time the base was replicated or -1 if it was not.
+     */
+    int operator[](uint base);
+
+    /*! Queries if a given base is already replicated.
+     * @param uint base The index of the base.
+     * @return True if the base was replicated.
+     */
+    bool is_replicated(uint base);
+
+    /*! Counts the unreplicated bases following a given base.
+     * @param int base The base to start from (not counted). It may be -1 or
+     * size() to count from the ends of the Strand.
+     * @param int direction The direction to walk (1 or -1).
+     * @param uint limit Maximum number of bases to count.
+     * @return The number of consecutive unreplicated bases after base, up to
+     * the first replicated base, the end of the Strand or limit.
+     */
+    uint unreplicated_run(int base, int direction, uint limit);
+
+    /*! Replicates the n_bases following anchor in the given direction. The
+     * i-th of them gets time anchor_time + ceil(i / speed), or anchor_time if
+     * speed is 0. The caller must make sure that all those bases are inside
+     * the Strand and not replicated yet. If the run continues the one that
+     * ends at anchor, that segment grows instead of adding a new one.
+     * @param int anchor The base before the run. It may be -1 or size().
+     * @param int direction The direction of the run (1 or -1).
+     * @param uint speed The number of bases that share each time, 0 for all.
+     * @param int anchor_time The time before the first base of the run.
+     * @param uint n_bases The number of bases to replicate.
+     */
+    void replicate(int anchor, int direction, uint speed, int anchor_time,
+                   uint n_bases);
+
+    /*! Query the replicated runs, sorted by position.
+     * @return The segments of the Strand.
+     */
+    const pool_vector<strand_segment_t> &get_segments() const;
+
+    /*! Makes every base unreplicated again, keeping the memory of the
+     * segments.
+     */
+    void clear();
+
+    /*! Replication time of a base inside a segment.
+     * @param segment_t segment The segment containing base.
+     * @param int base The index of the base.
+     * @return The time the base was replicated.
+     */
+    static int time_at(const strand_segment_t &segment, int base);
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*! File summary_statistic.hpp
+ *  Contains the SummaryStatistic class.
+ */
+#ifndef __SUMMARY_STATISTIC_HPP__
+#define __SUMMARY_STATISTIC_HPP__
+
+#include "util.hpp"
+#include <string>
+#include <vector>
+
+// Values below this have a histogram bin each, larger ones share 8 bins per
+// power of two
+#define SUMMARY_SUB_BITS 3
+#define SUMMARY_SUB_BINS (1U << SUMMARY_SUB_BITS)
+#define SUMMARY_EXACT_BINS (2 * SUMMARY_SUB_BINS)
+#define SUMMARY_BINS                                                           \
+    (SUMMARY_EXACT_BINS + (63 - SUMMARY_SUB_BITS) * SUMMARY_SUB_BINS)
+
+/*! The SummaryStatistic class accumulates the count, mean, variance, extremes
+ * and histogram of a stream of non negative integers, such as the durations
+ * of many cells, without keeping the values. The moments are kept as exact
+ * integer sums, so accumulators filled by different threads can be merged in
+ * any order and always give the same result. The histogram can be left out
+ * where many statistics are kept, such as one per bin of a profile.
+ */
+class SummaryStatistic
+{
+  private:
+    unsigned long long n;
+    unsigned __int128 sum;
+    unsigned __int128 sum_squares;
+    unsigned long long minimum;
+    unsigned long long maximum;
+    std::vector<unsigned long long> bins;
+
+  public:
+    /*! The constructor of an empty statistic.
+     * @param bool keep_histogram Whether to count the values in each bin.
+     */
+    explicit SummaryStatistic(bool keep_histogram = true);
+
+    /*! Adds a value.
+     * @param unsigned long long value The value.
+     */
+    void add(unsigned long long value);
+
+    /*! Adds all the values of another statistic.
+     * @param SummaryStatistic other The statistic to merge into this one.
+     * @throw invalid_argument if only one of them keeps a histogram.
+     */
+    void merge(const SummaryStatistic &other);
+
+    /*! Query the number of values.
+     * @return How many values were added.
+     */
+    unsigned long long count() const;
+
+    /*! Query the mean of the values.
+     * @return The mean, 0 if there are no values.
+     */
+    double mean() const;
+
+    /*! Query the sample variance of the values, with n - 1 as divisor.
+     * @return The variance, 0 if there are less than two values.
+     */
+    double variance() const;
+
+    /*! Query the sample standard deviation of the values.
+     * @return The square root of the variance.
+     */
+    double sd() const;
+
+    /*! Query the smallest value.
+     * @return The smallest value, 0 if there are no values.
+     */
+    unsigned long long min() const;
+
+    /*! Query the largest value.
+     * @return The largest value, 0 if there are no values.
+     */
+    unsigned long long max() const;
+
+    /*! Query the histogram of the values.
+     * @return The number of values in each bin, empty if it is not kept.
+     */
+    const std::vector<unsigned long long> &histogram() const;
+
+    /*! Finds the bin of a value, with the log-linear bins of
+     * SUMMARY_SUB_BITS, so no bin is wider than 1/8 of its values.
+     * @param unsigned long long value The value.
+     * @return The bin the value falls in.
+     */
+    static uint bin(unsigned long long value);
+
+    /*! Finds the smallest value of a bin.
+     * @param uint bin The bin.
+     * @return The smallest value that falls in the bin.
+     */
+    static unsigned long long bin_lower_bound(uint bin);
+
+    /*! Writes the statistic as tab separated count, mean, standard deviation,
+     * min and max, followed by the non empty bins of the histogram as comma
+     * separated lower_bound:count pairs.
+     * @return The statistic as text.
+     */
+    std::string to_string() const;
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*! File timing_file.hpp
+ *  Contains the TimingFileWriter and TimingFileReader classes, and the
+ *  semantic compression of the replication times of a Chromosome.
+ */
+#ifndef __TIMING_FILE_HPP__
+#define __TIMING_FILE_HPP__
+
+#include "buffer_pool.hpp"
+#include "chromosome.hpp"
+#include "util.hpp"
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <zstd.h>
+
+// Identifies the binary format and its version
+#define TIMING_FILE_MAGIC 0x43444552 // "REDC"
+#define TIMING_FILE_VERSION 1
+
+// Records per chunk in the binary format
+#define TIMING_FILE_CHUNK 4096
+
+// Minimum size of the buffers of the writer, in bytes
+#define TIMING_FILE_BUFFER (1 << 20)
+
+// Longest Chromosome code a reader accepts, in bytes
+#define TIMING_FILE_MAX_CODE 4096
+
+/*! A record of the semantic compression: length bases replicated at each
+ * time from start to end, stepping by one. For a single time end == start.
+ */
+typedef struct
+{
+    int32_t start;
+    int32_t end;
+    int32_t length;
+
+} timing_record_t;
+
+/*! Computes the records that describe the replication times of a Chromosome,
+ * -1 being the time of unreplicated bases, and calls visit with each of them
+ * in order.
+ * @param Chromosome chromosome The Chromosome, or its Strand.
+ * @param function visit Called as visit(const timing_record_t &).
+ */
+template <class Replicated, class Visitor>
+void compress_replication_times(Replicated &chromosome, Visitor visit);
+
+/*! Formats a record as a line of the text (.cseq) format: start, "-end" if
+ * the record covers several times, and "xlength" if length is not 1.
+ * @param timing_record_t record The record.
+ * @return The text, without line break.
+ */
+std::string to_string(const timing_record_t &record);
+
+/*! The TimingFileWriter class writes the records of a Chromosome to a binary
+ * file compressed with zstd as they are produced. The decompressed stream has
+ * a header with TIMING_FILE_MAGIC, TIMING_FILE_VERSION, the length of the
+ * Chromosome and its code (as its size and then its bytes), followed by
+ * chunks made of a record count and that many records. A chunk with no
+ * records ends the file. All numbers are 32 bit integers in the byte order
+ * of the machine that wrote the file.
+ */
+class TimingFileWriter
+{
+  private:
+    std::ofstream file;
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context;
+    pool_vector<char> in_buffer, out_buffer;
+    pool_vector<timing_record_t> chunk;
+
+    void write_bytes(const void *data, size_t size);
+    void write_chunk();
+    void compress(ZSTD_EndDirective directive);
+
+  public:
+    /*! The constructor. Creates the file and writes the header.
+     * @param string path The path of the file.
+     * @param string code The code of the Chromosome.
+     * @param uint length The number of bases of the Chromosome.
+     * @param int level The zstd compression level.
+     * @throw runtime_error if the file can not be written.
+     */
+    TimingFileWriter(std::string path, std::string code, uint length,
+                     int level = ZSTD_CLEVEL_DEFAULT);
+    ~TimingFileWriter();
+
+    /*! Adds a record to the file.
+     * @param timing_record_t record The record.
+     */
+    void write(const timing_record_t &record);
+
+    /*! Ends the file. Called by the destructor if it was not called before,
+     * which can not report errors, so a file must be closed explicitly to
+     * know it was written.
+     * @throw runtime_error if the file could not be written.
+     */
+    void close();
+};
+
+/*! The TimingFileReader class reads the files written by TimingFileWriter.
+ */
+class TimingFileReader
+{
+  private:
+    std::ifstream file;
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context;
+    std::vector<char> in_buffer, out_buffer;
+    ZSTD_inBuffer input;
+    size_t out_pos, out_size;
+
+    std::string code;
+    uint length;
+    uint chunk_left;
+    bool ended;
+
+    void read_bytes(void *data, size_t size);
+
+  public:
+    /*! The constructor. Opens the file and reads the header.
+     * @param string path The path of the file.
+     * @throw runtime_error if the file can not be read or is not valid.
+     */
+    TimingFileReader(std::string path);
+
+    /*! Query the code of the Chromosome in the file.
+     * @return The code of the Chromosome.
+     */
+    std::string get_code();
+
+    /*! Query the number of bases of the Chromosome in the file.
+     * @return The length of the Chromosome.
+     */
+    uint get_length();
+
+    /*! Reads the next record.
+     * @param timing_record_t record Set to the record read.
+     * @return False if there are no records left.
+     */
+    bool next(timing_record_t &record);
+
+    /*! Reads all the records left and expands them.
+     * @return The replication time of each base, -1 if it was not
+     * replicated.
+     */
+    std::vector<int> times();
+};
+
+template <class Replicated, class Visitor>
+void compress_replication_times(Replicated &chromosome, Visitor visit)
+{
+    // Current and last two number streaks
+    struct number_streak
+    {
+        int value   = INT32_MIN;
+        int length  = INT32_MIN;
+        bool in_seq = false;
+    } number_streaks[3];
+
+    // Sequence data
+    struct sequence_data
+    {
+        int start_value = INT32_MIN;
+        int direction   = 0;
+    } sequence, null_sequence;
+
+    // Cache chromosome size
+    const int chromosome_size = chromosome.size();
+
+    for (int bp = 0; bp < chromosome_size + 2; bp++)
+    {
+        // Retrieve value if in range
+        int value = INT32_MIN;
+        if (bp < chromosome_size) value = chromosome[bp];
+
+        // If a new number streak has started
+        if (value == INT32_MIN || value != number_streaks[0].value)
+        {
+            // Finalize sequence if unable to continue, like when streak
+            // changes size or step size
+            if (sequence.start_value != INT32_MIN &&
+                (number_streaks[0].length != number_streaks[1].length ||
+                 sequence.direction !=
+                     number_streaks[0].value - number_streaks[1].value))
+            {
+                // Write output for this sequence
+                visit(timing_record_t{sequence.start_value,
+                                      number_streaks[1].value,
+                                      number_streaks[1].length});
+
+                // Zero sequence data
+                sequence = null_sequence;
+
+                // Set as sequence
+                number_streaks[1].in_seq = true;
+            }
+            // Start sequence if not in sequence, current streak is valid,
+            // and start of sequence is valid
+            else if (sequence.start_value == INT32_MIN &&
+                     number_streaks[0].value != INT32_MIN &&
+                     number_streaks[0].length != INT32_MIN &&
+                     number_streaks[0].length == number_streaks[1].length &&
+                     abs(number_streaks[0].value - number_streaks[1].value) ==
+                         1)
+            {
+                // Create sequence
+                sequence.start_value = number_streaks[1].value;
+                sequence.direction =
+                    number_streaks[0].value - number_streaks[1].value;
+
+                // Set as sequence
+                number_streaks[1].in_seq = true;
+            }
+            // Set as sequence if in sequence
+            else if (sequence.start_value != INT32_MIN)
+                number_streaks[1].in_seq = true;
+
+            // If it's a unique value streak (not a sequence)
+            if (!number_streaks[1].in_seq &&
+                number_streaks[1].value != INT32_MIN)
+            {
+                // Write output for this value
+                visit(timing_record_t{number_streaks[1].value,
+                                      number_streaks[1].value,
+                                      number_streaks[1].length});
+            }
+
+            // Shift number streaks
+            number_streaks[2] = number_streaks[1];
+            number_streaks[1] = number_streaks[0];
+            number_streaks[0] = number_streak{value, 0, false};
+        }
+
+        if (value != INT32_MIN) number_streaks[0].length++;
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*! File transcription_region_index.hpp
+ *  Contains the TranscriptionRegionIndex class.
+ */
+#ifndef __TRANSCRIPTION_REGION_INDEX_HPP__
+#define __TRANSCRIPTION_REGION_INDEX_HPP__
+
+#include "util.hpp"
+#include <algorithm>
+#include <vector>
+
+/*! The TranscriptionRegionIndex class finds the transcription regions of a
+ * Chromosome that overlap a range of bases in logarithmic time. It never
+ * changes once built, so a single index is shared by every cell.
+ */
+class TranscriptionRegionIndex
+{
+  private:
+    // Regions sorted by their lowest base
+    std::vector<transcription_region_t> regions;
+
+    // Highest base reached by regions[0..i]
+    std::vector<int> reach;
+
+  public:
+    /*! The constructor.
+     * @param vector regions The transcription regions of a Chromosome, with
+     * start > end for regions transcribed backwards.
+     */
+    TranscriptionRegionIndex(const std::vector<transcription_region_t> &regions);
+
+    /*! Query the number of regions in the index.
+     * @return The number of regions.
+     */
+    uint size() const;
+
+    /*! Calls visit with every region that shares a base with [first, last],
+     * until visit returns true.
+     * @param int first The lowest base of the range.
+     * @param int last The highest base of the range.
+     * @param function visit Called as visit(const transcription_region_t &).
+     * @return True if some call to visit returned true.
+     */
+    template <class Visitor>
+    bool find_overlapping(int first, int last, Visitor visit) const;
+
+    /*! Calls visit with every region that contains base, until visit returns
+     * true.
+     * @see find_overlapping
+     */
+    template <class Visitor> bool find_containing(int base, Visitor visit) const
+    {
+        return find_overlapping(base, base, visit);
+    }
+};
+
+template <class Visitor>
+bool TranscriptionRegionIndex::find_overlapping(int first, int last,
+                                                Visitor visit) const
+{
+    // Last region that starts at last or before it
+    uint lo = 0, hi = regions.size();
+    while (lo < hi)
+    {
+        uint mid  = (lo + hi) / 2;
+        int start = std::min(regions[mid].start, regions[mid].end);
+        if (start <= last)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // Walk back while earlier regions can still reach first
+    for (int i = (int)lo - 1; i >= 0 && reach[i] >= first; i--)
+    {
+        if (std::max(regions[i].start, regions[i].end) >= first &&
+            visit(regions[i]))
+            return true;
+    }
+    return false;
+}
+
+#endif
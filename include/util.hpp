@@ -21,6 +21,22 @@ typedef struct
 
 bool operator==(const constitutive_origin_t &a, const constitutive_origin_t &b);
 
+/*! Finds the log-linear bin of a value. Values below 2^(sub_bits + 1) have
+ * their own bin and each larger power of two is split into 2^sub_bits bins of
+ * the same width, so no bin is wider than 2^-sub_bits of its values.
+ * @param unsigned long long value The value.
+ * @param uint sub_bits The log2 of the number of bins per power of two.
+ * @return The bin the value falls in.
+ */
+uint log_linear_bin(unsigned long long value, uint sub_bits);
+
+/*! Finds the smallest value of a log-linear bin.
+ * @param uint bin The bin.
+ * @param uint sub_bits The log2 of the number of bins per power of two.
+ * @return The smallest value that falls in the bin.
+ */
+unsigned long long log_linear_bin_lower_bound(uint bin, uint sub_bits);
+
 // S-Phase Checkpoint times for duration calculation
 typedef struct
 {
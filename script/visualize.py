@@ -3,39 +3,94 @@
 import sys
 import subprocess
 import os
+import re
+import struct
 from matplotlib import pyplot as plt
 
+# identifies the binary timing files written with --format zst
+TIMING_FILE_MAGIC = 0x43444552
+TIMING_FILE_VERSION = 1
+
 if len(sys.argv) < 2:
   print("File not specified")
   print("Usage: visualize.py FILE")
-  print("Example: visualize.py path/to/file.txt.zst")
+  print("Example: visualize.py path/to/file.cseq.zst")
   exit(0)
 
-compressed_file_name=os.path.abspath(sys.argv[1])
-uncompressed_file_name=compressed_file_name[:-4]
-
-subprocess.call('zstd -d -f ' + compressed_file_name + ' -o ' + uncompressed_file_name, shell=True)
-
-with open(uncompressed_file_name, "r") as file:
-  # step between points to be plotted. increase it to reduce time (will mess with y axis values)
-  step = 1
-  times=file.readlines()
-  count = 0
-  reduced = []
-
-  # plot one every step
-  for t in times:
-    if count >= step:
-      count = 0
-      reduced.append(t)
-    count = count + 1
-
-  # configure plot ticks to not bunch up
-  fig = plt.figure()
-  ax = fig.add_subplot(1, 1, 1)
-  max_yticks = 30
-  yloc = plt.MaxNLocator(max_yticks)
-  ax.yaxis.set_major_locator(yloc)
-
-  plt.plot(reduced, '.g', markersize=0.3)
-  plt.show()
+# expands the records of the semantic compression, start[-end][xlength]
+def expand(records):
+  times = []
+  for start, end, length in records:
+    step = -1 if end < start else 1
+    for time in range(start, end + step, step):
+      times.extend([time] * length)
+  return times
+
+# decodes a binary timing file: a header and chunks of records, all of them
+# 32 bit integers, compressed with zstd
+def read_timing_file(file_name):
+  data = subprocess.run(['zstd', '-d', '-c', '-q', file_name],
+                        check=True, stdout=subprocess.PIPE).stdout
+  magic, version, length, code_size = struct.unpack_from('=4i', data, 0)
+  if magic != TIMING_FILE_MAGIC or version != TIMING_FILE_VERSION:
+    sys.exit(file_name + " is not a timing file")
+
+  offset = 16 + code_size
+  records = []
+  while True:
+    n_records, = struct.unpack_from('=i', data, offset)
+    offset += 4
+    if n_records == 0:
+      break
+    records.extend(struct.iter_unpack('=3i', data[offset:offset + 12 * n_records]))
+    offset += 12 * n_records
+  return expand(records)
+
+def read_cseq(file_name):
+  records = []
+  with open(file_name, "r") as file:
+    for line in file:
+      match = re.fullmatch(r'(-?\d+)(?:-(-?\d+))?(?:x(\d+))?', line.strip())
+      if match is None:
+        continue
+      start = int(match[1])
+      end = int(match[2]) if match[2] else start
+      length = int(match[3]) if match[3] else 1
+      records.append((start, end, length))
+  return expand(records)
+
+file_name = os.path.abspath(sys.argv[1])
+if file_name.endswith(".cseq.zst"):
+  times = read_timing_file(file_name)
+elif file_name.endswith(".cseq"):
+  times = read_cseq(file_name)
+else:
+  if file_name.endswith(".zst"):
+    # per-base text files compressed by older versions of the simulator
+    uncompressed_file_name = file_name[:-4]
+    subprocess.call('zstd -d -f ' + file_name + ' -o ' + uncompressed_file_name, shell=True)
+    file_name = uncompressed_file_name
+  with open(file_name, "r") as file:
+    times = [int(line) for line in file if line.strip()]
+
+# step between points to be plotted. increase it to reduce time (will mess with y axis values)
+step = 1
+count = 0
+reduced = []
+
+# plot one every step
+for t in times:
+  if count >= step:
+    count = 0
+    reduced.append(t)
+  count = count + 1
+
+# configure plot ticks to not bunch up
+fig = plt.figure()
+ax = fig.add_subplot(1, 1, 1)
+max_yticks = 30
+yloc = plt.MaxNLocator(max_yticks)
+ax.yaxis.set_major_locator(yloc)
+
+plt.plot(reduced, '.g', markersize=0.3)
+plt.show()
@@ -0,0 +1,56 @@
+#include "alias_table.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+AliasTable::AliasTable() {}
+
+AliasTable::AliasTable(const std::vector<double> &weights)
+    : thresholds(weights.size(), UINT64_MAX), aliases(weights.size())
+{
+    if (weights.empty())
+        throw std::invalid_argument("An AliasTable needs at least one weight.");
+
+    double sum = 0;
+    for (double weight : weights)
+    {
+        if (weight < 0)
+            throw std::invalid_argument("AliasTable weights must not be "
+                                        "negative.");
+        sum += weight;
+    }
+    if (sum <= 0)
+        throw std::invalid_argument("AliasTable weights add up to 0.");
+
+    // Vose: pair each column below the mean with one above it
+    std::vector<double> scaled(weights.size());
+    std::vector<uint> small, large;
+    for (uint i = 0; i < weights.size(); i++)
+    {
+        aliases[i] = i;
+        scaled[i]  = weights[i] * weights.size() / sum;
+        (scaled[i] < 1 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint low  = small.back();
+        uint high = large.back();
+        small.pop_back();
+
+        thresholds[low] =
+            (uint64_t)std::ldexp(std::max(scaled[low], 0.0), 64);
+        aliases[low] = high;
+
+        scaled[high] -= 1 - scaled[low];
+        if (scaled[high] < 1)
+        {
+            large.pop_back();
+            small.push_back(high);
+        }
+    }
+
+    // What is left is 1 up to rounding, those columns are always kept
+}
+
+uint AliasTable::size() const { return thresholds.size(); }
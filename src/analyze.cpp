@@ -0,0 +1,117 @@
+#include "output_analysis.hpp"
+#include "output_reader.hpp"
+#include <algorithm>
+#include <getopt.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ANALYZE_USAGE                                                          \
+    "Usage: analyze [--threads number_of_threads] <cells|collisions|all> "     \
+    "run_folder"
+
+/*! Prints the aggregates of the cells of a run as
+ * script/cell_output_aggregator.py does, every line followed by a tab and
+ * no line break.
+ * @param string run_folder The folder of the run.
+ * @param uint n_threads The number of threads that read the files.
+ */
+static void analyze_cells(std::string run_folder, uint n_threads)
+{
+    std::vector<std::string> folders = simulation_folders(run_folder);
+    std::vector<std::vector<cell_record_t>> cells(folders.size());
+    parallel_for(folders.size(), n_threads, [&](size_t i) {
+        cells[i] = read_cell_file(folders[i] + "/cell.txt");
+    });
+
+    std::vector<cell_record_t> all_cells;
+    for (auto &folder_cells : cells)
+        all_cells.insert(all_cells.end(), folder_cells.begin(),
+                         folder_cells.end());
+
+    for (auto &aggregate : aggregate_cells(all_cells))
+        std::cout << to_string(aggregate) << "\t";
+    std::cout << std::flush;
+}
+
+/*! Prints the median, mean and standard deviation of the distances between
+ * origins and collisions of every Chromosome of every cell of a run, as
+ * script/collision_distance_median_parallel.py does.
+ * @param string run_folder The folder of the run.
+ * @param uint n_threads The number of threads that read the files.
+ */
+static void analyze_collisions(std::string run_folder, uint n_threads)
+{
+    std::vector<std::string> files;
+    for (auto &folder : simulation_folders(run_folder))
+        for (auto &file : timing_files(folder))
+            files.push_back(file);
+
+    std::vector<std::vector<uint>> distances(files.size());
+    parallel_for(files.size(), n_threads, [&](size_t i) {
+        collision_distances(read_replication_times(files[i]), distances[i]);
+    });
+
+    std::vector<uint> all_distances;
+    for (auto &file_distances : distances)
+        all_distances.insert(all_distances.end(), file_distances.begin(),
+                             file_distances.end());
+
+    std::cout << to_string(distance_statistics(all_distances)) << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    static struct option long_options[] = {
+        {"threads", required_argument, 0, 't'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}};
+
+    try
+    {
+        int c;
+        while ((c = getopt_long(argc, argv, "t:h", long_options, nullptr)) !=
+               -1)
+        {
+            switch (c)
+            {
+            case 't': n_threads = std::max(1, std::stoi(optarg)); break;
+            default: std::cout << ANALYZE_USAGE << std::endl; return 1;
+            }
+        }
+
+        if (argc - optind != 2)
+        {
+            std::cout << ANALYZE_USAGE << std::endl;
+            return 1;
+        }
+        std::string command    = argv[optind];
+        std::string run_folder = argv[optind + 1];
+
+        if (!command.compare("cells"))
+            analyze_cells(run_folder, n_threads);
+        else if (!command.compare("collisions"))
+            analyze_collisions(run_folder, n_threads);
+        else if (!command.compare("all"))
+        {
+            // The line the assays append to the file of a run
+            analyze_cells(run_folder, n_threads);
+            analyze_collisions(run_folder, n_threads);
+        }
+        else
+        {
+            std::cout << ANALYZE_USAGE << std::endl;
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
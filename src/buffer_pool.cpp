@@ -0,0 +1,97 @@
+#include "buffer_pool.hpp"
+#include <cstdlib>
+#include <sys/mman.h>
+
+BufferPool::BufferPool(bool huge_pages) : cached(0), huge_pages(huge_pages) {}
+
+BufferPool::~BufferPool()
+{
+    for (auto &size_class : classes)
+        for (void *block : size_class.blocks)
+            std::free(block);
+}
+
+BufferPool &BufferPool::shared()
+{
+    // Never destroyed, blocks may be given back while statics are destroyed
+    static BufferPool *pool = new BufferPool();
+    return *pool;
+}
+
+uint BufferPool::size_class(size_t size)
+{
+    uint bits = BUFFER_POOL_MIN_BITS;
+    while (bits <= BUFFER_POOL_MAX_BITS && (1ULL << bits) < size)
+        bits++;
+    return bits - BUFFER_POOL_MIN_BITS;
+}
+
+void *BufferPool::allocate_block(size_t size)
+{
+    bool huge        = huge_pages && size >= BUFFER_POOL_HUGE_PAGE;
+    size_t alignment = huge ? BUFFER_POOL_HUGE_PAGE : 64;
+
+    // aligned_alloc needs a multiple of the alignment
+    size        = (size + alignment - 1) & ~(alignment - 1);
+    void *block = std::aligned_alloc(alignment, size);
+    if (!block) throw std::bad_alloc();
+    if (huge) madvise(block, size, MADV_HUGEPAGE);
+    return block;
+}
+
+void *BufferPool::allocate(size_t size)
+{
+    uint index = size_class(size);
+    if (index >= sizeof(classes) / sizeof(classes[0]))
+        return allocate_block(size);
+
+    size_t class_size = 1ULL << (index + BUFFER_POOL_MIN_BITS);
+    {
+        std::lock_guard<std::mutex> guard(classes[index].mutex);
+        if (!classes[index].blocks.empty())
+        {
+            void *block = classes[index].blocks.back();
+            classes[index].blocks.pop_back();
+            cached.fetch_sub(class_size, std::memory_order_relaxed);
+            return block;
+        }
+    }
+    return allocate_block(class_size);
+}
+
+void BufferPool::deallocate(void *block, size_t size)
+{
+    if (!block) return;
+
+    uint index = size_class(size);
+    if (index >= sizeof(classes) / sizeof(classes[0]))
+    {
+        std::free(block);
+        return;
+    }
+
+    size_t class_size = 1ULL << (index + BUFFER_POOL_MIN_BITS);
+    unsigned long long previous = cached.load(std::memory_order_relaxed);
+    do
+    {
+        if (previous + class_size > BUFFER_POOL_MAX_CACHED)
+        {
+            std::free(block);
+            return;
+        }
+    } while (!cached.compare_exchange_weak(previous, previous + class_size,
+                                           std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> guard(classes[index].mutex);
+    classes[index].blocks.push_back(block);
+}
+
+void BufferPool::set_huge_pages(bool huge_pages)
+{
+    this->huge_pages = huge_pages;
+}
+
+unsigned long long BufferPool::cached_bytes()
+{
+    return cached.load(std::memory_order_relaxed);
+}
@@ -1,5 +1,4 @@
 #include "chromosome.hpp"
-#include "mem_manager.hpp"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,23 +6,62 @@
 #include <stdexcept>
 #include <string>
 
+// Activation probabilities are summed in fixed point so that adding and
+// removing bases over a whole S-phase never drifts.
+static const double activation_unit = 4294967296.0;
+
+static unsigned long long activation_units(double probability)
+{
+    if (probability <= 0) return 0;
+    if (probability >= 1) return (unsigned long long)activation_unit;
+    return (unsigned long long)std::llround(probability * activation_unit);
+}
+
 Chromosome::Chromosome(std::string code, std::shared_ptr<DataProvider> provider)
-    : probability_landscape(provider->get_probability_landscape(code)),
-      transcription_regions(provider->get_transcription_regions(code)),
-      constitutive_origins(provider->get_constitutive_origins(code)),
-      strand(provider->get_length(code), -1)
+    : Chromosome(provider->get_chromosome_id(code), provider)
 {
-    long long int length = provider->get_length(code);
+}
+
+Chromosome::Chromosome(uint id, std::shared_ptr<DataProvider> provider)
+    : Chromosome(provider->get_chromosome_data(id), provider)
+{
+    this->id = id;
+}
+
+Chromosome::Chromosome(std::shared_ptr<const chromosome_data_t> data,
+                       std::shared_ptr<DataProvider> provider)
+    : strand(data->length), provider(provider),
+      probability_landscape(data->probability_landscape),
+      transcription_regions(data->transcription_regions),
+      transcription_region_index(data->transcription_region_index),
+      constitutive_origins(data->constitutive_origins)
+{
+    long long int length = data->length;
 
     if (length <= 0)
         throw std::invalid_argument("Given length is not a positive number.");
-    this->code               = code;
+    this->code               = data->code;
+    this->id                 = 0;
+    this->index              = 0;
     this->length             = length;
     this->n_replicated_bases = 0;
     this->n_fired_origins    = 0;
+    this->activation_mass    = 0;
+    this->gap_sampling       = false;
+    this->landscape_blocks.assign(
+        ((this->length - 1) >> ACTIVATION_BLOCK_BITS) + 1, 0);
+    for (uint base = 0; base < this->length; base++)
+    {
+        unsigned long long units = activation_units(probability_landscape[base]);
+        activation_mass += units;
+        landscape_blocks[base >> ACTIVATION_BLOCK_BITS] += units;
+    }
+    this->landscape_mass = activation_mass;
     this->fired_constitutive_origins =
         std::make_shared<std::vector<constitutive_origin_t>>(
             std::vector<constitutive_origin_t>(0));
+    this->constitutive_origin_index =
+        ConstitutiveOriginIndex(*constitutive_origins);
 }
 
 uint Chromosome::size() { return this->length; }
@@ -31,9 +69,18 @@ uint Chromosome::size() { return this->length; }
 std::string Chromosome::to_string()
 {
     std::string chromosome_string = "";
+    auto segment = strand.get_segments().begin();
     for (uint base = 0; base < length; base += CHRM_OUTPUT_STEP)
     {
-        chromosome_string += std::to_string(strand[base]);
+        // Bases are visited in order, so are the segments that hold them
+        while (segment != strand.get_segments().end() &&
+               segment->last < (int)base)
+            segment++;
+        int time = -1;
+        if (segment != strand.get_segments().end() &&
+            segment->first <= (int)base)
+            time = Strand::time_at(*segment, base);
+        chromosome_string += std::to_string(time);
         chromosome_string += "\n";
     }
     return chromosome_string;
@@ -43,7 +90,7 @@ bool Chromosome::base_is_replicated(uint base)
 {
     if (base < 0 || base >= this->length)
         throw std::out_of_range("Given base is outside Chromosome length.");
-    return this->strand[base] != -1;
+    return this->strand.is_replicated(base);
 }
 
 double Chromosome::activation_probability(uint base)
@@ -64,16 +111,65 @@ void Chromosome::set_dormant_activation_probability(uint base)
     right_base =
         right_base > (int)this->length ? (int)this->length : right_base;
 
+    long long block_delta = 0;
     for (int curr_base = left_base; curr_base < right_base; curr_base++)
     {
         int offset            = curr_base - base;
         double gaussian_value = exp(-pow(offset, 2) / (2 * pow(c, 2)));
-        probability_landscape[curr_base] += gaussian_value;
-        if (probability_landscape[curr_base] > 1)
-            probability_landscape[curr_base] = 1;
+        double old_value      = probability_landscape[curr_base];
+        double new_value      = old_value + gaussian_value;
+        if (new_value > 1) new_value = 1;
+        probability_landscape.set(curr_base, new_value);
+        if (!strand.is_replicated(curr_base))
+            block_delta +=
+                activation_units(new_value) - activation_units(old_value);
+
+        // Flush the change at the end of each sampler block
+        if (curr_base + 1 == right_base ||
+            ((curr_base + 1) & ((1 << ACTIVATION_BLOCK_BITS) - 1)) == 0)
+        {
+            add_activation(curr_base, block_delta);
+            block_delta = 0;
+        }
+    }
+}
+
+void Chromosome::add_activation(uint base, long long delta)
+{
+    activation_mass += delta;
+    if (delta != 0 && activation_blocks.size() > 0)
+        activation_blocks.add(base >> ACTIVATION_BLOCK_BITS, delta);
+}
+
+void Chromosome::remove_activation(int anchor, int direction, uint n_bases)
+{
+    long long block_delta = 0;
+    for (uint offset = 1; offset <= n_bases; offset++)
+    {
+        uint curr_base = anchor + direction * (int)offset;
+        block_delta -= activation_units(probability_landscape[curr_base]);
+
+        // Flush the change when the run leaves a sampler block
+        uint next_base = curr_base + direction;
+        if (offset == n_bases ||
+            next_base >> ACTIVATION_BLOCK_BITS !=
+                curr_base >> ACTIVATION_BLOCK_BITS)
+        {
+            add_activation(curr_base, block_delta);
+            block_delta = 0;
+        }
     }
 }
 
+void Chromosome::remove_gap(int anchor, int direction, uint n_bases)
+{
+    if (!gap_sampling || n_bases == 0) return;
+    if (direction == 1)
+        unreplicated_gaps.remove(anchor + 1, anchor + n_bases);
+    else
+        unreplicated_gaps.remove(anchor - n_bases, anchor - 1);
+}
+
 bool Chromosome::replicate(int start, int end, int time)
 {
     if (start < 0 || start > (int)this->length)
@@ -87,34 +183,184 @@ bool Chromosome::replicate(int start, int end, int time)
     // than zero or greater than the Chromosome itself).
     bool normal_replication = true;
 
-    if (end < 0 || end >= (int)strand.size())
+    if (end < 0 || end >= (int)this->length)
     {
         // limit the end to the strand size
         end = end < 0 ? 0 : end;
-        end = end >= (int)strand.size() ? (int)strand.size() - 1 : end;
+        end = end >= (int)this->length ? (int)this->length - 1 : end;
         normal_replication = false;
     }
 
-    bool inverted = end < start;
-    for (int base = start; inverted ? base > end - 1 : base < end + 1;
-         inverted ? base-- : base++)
+    // Bases from start to end, except start if it is already replicated,
+    // up to the first replicated one
+    int direction  = end < start ? -1 : 1;
+    uint n_bases   = (end - start) * direction + 1;
+    int anchor     = start - direction;
+    uint speed     = 0;
+    int start_time = time;
+    if (strand.is_replicated(start))
     {
-        if (strand[base] == -1)
-        {
-            strand[base] = time;
-            n_replicated_bases++;
-        }
-        // if the base was already replicated
-        else if (base != start)
-        {
-            normal_replication = false;
-            break;
-        }
+        anchor     = start;
+        speed      = n_bases - 1;
+        start_time = time - 1;
+        n_bases--;
     }
 
+    uint run = strand.unreplicated_run(anchor, direction, n_bases);
+    if (run < n_bases) normal_replication = false;
+
+    strand.replicate(anchor, direction, speed, start_time, run);
+    remove_activation(anchor, direction, run);
+    remove_gap(anchor, direction, run);
+    add_replicated(run);
+
     return normal_replication;
 }
 
+void Chromosome::replicate_run(uint base, int direction, uint speed,
+                               uint time, uint n_steps)
+{
+    long long last_base =
+        (long long)base + (long long)direction * speed * n_steps;
+    if (base >= this->length || last_base < 0 ||
+        last_base >= (long long)this->length)
+        throw std::out_of_range("The run is not inside the Chromosome");
+
+    uint n_bases = speed * n_steps;
+    strand.replicate(base, direction, speed, time - 1, n_bases);
+    remove_activation(base, direction, n_bases);
+    remove_gap(base, direction, n_bases);
+    add_replicated(n_bases);
+}
+
+void Chromosome::add_replicated(uint n_bases)
+{
+    n_replicated_bases += n_bases;
+    if (genome_unreplicated_bases) *genome_unreplicated_bases -= n_bases;
+}
+
+uint Chromosome::unreplicated_run(uint base, int direction, uint limit)
+{
+    return strand.unreplicated_run(base, direction, limit);
+}
+
+double Chromosome::unreplicated_activation_mass()
+{
+    return activation_mass / activation_unit;
+}
+
+unsigned long long Chromosome::unreplicated_activation_units()
+{
+    return activation_mass;
+}
+
+void Chromosome::enable_activation_sampling()
+{
+    uint n_blocks = ((this->length - 1) >> ACTIVATION_BLOCK_BITS) + 1;
+    std::vector<unsigned long long> blocks(n_blocks, 0);
+    // Walk the unreplicated runs instead of testing every base, base being
+    // the replicated base (or -1) before each run
+    int base = -1;
+    while (base + 1 < (int)this->length)
+    {
+        uint run = strand.unreplicated_run(base, 1, this->length);
+        for (uint offset = 1; offset <= run; offset++)
+            blocks[(base + offset) >> ACTIVATION_BLOCK_BITS] +=
+                activation_units(probability_landscape[base + offset]);
+        base += run + 1;
+        while (base + 1 < (int)this->length && strand.is_replicated(base + 1))
+            base++;
+    }
+    activation_blocks = FenwickTree(blocks);
+}
+
+uint Chromosome::random_activation_base(unsigned long long target)
+{
+    if (activation_blocks.size() == 0)
+        throw std::runtime_error("Activation sampling is not enabled.");
+
+    uint block = activation_blocks.find(target);
+    uint first = block << ACTIVATION_BLOCK_BITS;
+    uint last  = std::min(first + (1 << ACTIVATION_BLOCK_BITS), this->length);
+    for (uint base = first; base < last; base++)
+    {
+        if (strand.is_replicated(base)) continue;
+        unsigned long long units = activation_units(probability_landscape[base]);
+        if (target < units) return base;
+        target -= units;
+    }
+    throw std::runtime_error("Activation sampler is out of sync.");
+}
+
+void Chromosome::enable_gap_sampling()
+{
+    // The gaps are what lies between the replicated segments
+    std::vector<std::pair<uint, uint>> gaps;
+    int next = 0;
+    for (auto segment : strand.get_segments())
+    {
+        if (segment.first > next)
+            gaps.push_back(std::make_pair(next, segment.first - 1));
+        next = segment.last + 1;
+    }
+    if (next < (int)this->length)
+        gaps.push_back(std::make_pair(next, this->length - 1));
+
+    unreplicated_gaps = GapIndex(gaps);
+    gap_sampling      = true;
+}
+
+void Chromosome::reset()
+{
+    strand.clear();
+    probability_landscape.reset();
+    if (genome_unreplicated_bases)
+        *genome_unreplicated_bases += n_replicated_bases;
+    n_replicated_bases = 0;
+    n_fired_origins    = 0;
+    activation_mass    = landscape_mass;
+    if (activation_blocks.size() > 0)
+        activation_blocks = FenwickTree(landscape_blocks);
+    if (gap_sampling) unreplicated_gaps = GapIndex(this->length);
+    fired_constitutive_origins->clear();
+    constitutive_origin_index.reset();
+}
+
+const Strand &Chromosome::get_strand() const { return strand; }
+
+uint Chromosome::random_unreplicated_base(unsigned long long rank)
+{
+    if (!gap_sampling)
+        throw std::runtime_error("Gap sampling is not enabled.");
+    return unreplicated_gaps.find(rank);
+}
+
+std::vector<std::pair<uint, uint>>
+Chromosome::unfired_origin_windows(uint origins_range)
+{
+    // Unfired origins come sorted by base, and so do their windows
+    std::vector<std::pair<uint, uint>> windows;
+    for (auto origin : constitutive_origin_index.unfired())
+    {
+        // Same (unsigned) bounds used by GenomicLocation::will_activate
+        uint first = origin.base - origins_range / 2;
+        uint last  = origin.base + origins_range / 2;
+        if (first > last || first >= this->length) continue;
+        if (last >= this->length) last = this->length - 1;
+        windows.push_back(std::make_pair(first, last));
+    }
+
+    std::vector<std::pair<uint, uint>> merged;
+    for (auto window : windows)
+    {
+        if (!merged.empty() && window.first <= merged.back().second + 1)
+            merged.back().second = std::max(merged.back().second, window.second);
+        else
+            merged.push_back(window);
+    }
+    return merged;
+}
+
 bool Chromosome::is_replicated()
 {
     return this->n_replicated_bases == this->length;
@@ -122,6 +368,10 @@ bool Chromosome::is_replicated()
 
 std::string Chromosome::get_code() { return this->code; }
 
+uint Chromosome::get_id() { return this->id; }
+
+uint Chromosome::get_index() { return this->index; }
+
 uint Chromosome::n_constitutive_origins()
 {
     return this->constitutive_origins->size();
@@ -133,12 +383,18 @@ uint Chromosome::get_n_fired_origins() { return n_fired_origins; }
 
 void Chromosome::add_fired_origin() { n_fired_origins++; }
 
-const std::shared_ptr<std::vector<transcription_region_t>>
+const std::shared_ptr<const std::vector<transcription_region_t>>
 Chromosome::get_transcription_regions() const
 {
     return transcription_regions;
 }
 
+const TranscriptionRegionIndex &
+Chromosome::get_transcription_region_index() const
+{
+    return *transcription_region_index;
+}
+
 bool Chromosome::operator==(Chromosome &other)
 {
     return this->code == other.get_code();
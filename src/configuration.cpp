@@ -1,8 +1,10 @@
 #include "configuration.hpp"
 
 #include <c4/yml/std/string.hpp>
+#include <cctype>
 #include <fstream>
 #include <random>
+#include <sstream>
 
 conf_function_map cl_evolution_mutations_genes_move_functions = {
     PUSH_D(evolution.mutations.genes.move.prob),
@@ -80,6 +82,15 @@ conf_function_map cl_evolution_functions = {
     PUSH_FUNCS(evolution.fitness, cl_evolution_fitness_functions),
 };
 
+conf_function_map cl_sweep_functions = {
+    PUSH_LIST(sweep.resources, parse_ull_list),
+    PUSH_LIST(sweep.period, parse_ull_list),
+    PUSH_LIST(sweep.speed, parse_ull_list),
+    PUSH_LIST(sweep.constitutive, parse_ull_list),
+    PUSH_LIST(sweep.dormant, parse_bool_list),
+    PUSH_STR(sweep.order),
+};
+
 conf_function_map cl_configuration_functions = {
     PUSH_ULL(cells),
     PUSH_STR(organism),
@@ -95,7 +106,15 @@ conf_function_map cl_configuration_functions = {
     PUSH_STR(output),
     PUSH_ULL(threads),
     PUSH_ULL(seed),
-    PUSH_FUNCS(evolution, cl_evolution_functions)};
+    PUSH_STR(engine),
+    PUSH_STR(sampler),
+    PUSH_STR(format),
+    PUSH_STR(cache_dir),
+    PUSH_BOOL(huge_pages),
+    PUSH_STR(rng),
+    PUSH_ULL(profile_bin),
+    PUSH_FUNCS(evolution, cl_evolution_functions),
+    PUSH_FUNCS(sweep, cl_sweep_functions)};
 
 void read_conf_yml(ryml::NodeRef &base, cl_configuration_data &arguments,
                    conf_function_map &function_map,
@@ -117,6 +136,164 @@ void read_conf_yml(ryml::NodeRef &base, cl_configuration_data &arguments,
     }
 }
 
+std::vector<std::string> read_yml_list(ryml::NodeRef &base, std::string key)
+{
+    std::vector<std::string> items;
+    for (ryml::NodeRef c : base.children())
+    {
+        if (c.key().compare(key.c_str(), key.size())) continue;
+
+        if (c.has_val())
+        {
+            // A single value, possibly with comma separated items
+            std::string val;
+            c4::from_chars(c.val(), &val);
+            std::stringstream stream(val);
+            std::string item;
+            while (std::getline(stream, item, ','))
+                items.push_back(item);
+        }
+        else
+            for (ryml::NodeRef item : c.children())
+            {
+                std::string val;
+                c4::from_chars(item.val(), &val);
+                items.push_back(val);
+            }
+        break;
+    }
+    return items;
+}
+
+// Parses a whole item as a number, ignoring the spaces around it
+static unsigned long long parse_ull(std::string item)
+{
+    std::size_t begin = item.find_first_not_of(" \t");
+    std::size_t end   = item.find_last_not_of(" \t");
+    if (begin == std::string::npos || !isdigit(item[begin]))
+        throw std::invalid_argument("Not a number in list: \"" + item + "\"");
+
+    item             = item.substr(begin, end - begin + 1);
+    std::size_t read = 0;
+    unsigned long long value = std::stoull(item, &read);
+    if (read != item.size())
+        throw std::invalid_argument("Not a number in list: \"" + item + "\"");
+    return value;
+}
+
+std::vector<unsigned long long>
+parse_ull_list(const std::vector<std::string> &items)
+{
+    std::vector<unsigned long long> values;
+    for (const std::string &item : items)
+    {
+        std::vector<std::string> bounds;
+        std::stringstream stream(item);
+        std::string bound;
+        while (std::getline(stream, bound, ':'))
+            bounds.push_back(bound);
+
+        if (bounds.size() !=
+            static_cast<size_t>(std::count(item.begin(), item.end(), ':')) + 1)
+            throw std::invalid_argument("Invalid range in list: \"" + item +
+                                        "\"");
+        if (bounds.size() == 1)
+        {
+            values.push_back(parse_ull(bounds[0]));
+            continue;
+        }
+        if (bounds.size() > 3)
+            throw std::invalid_argument("Invalid range in list: \"" + item +
+                                        "\"");
+
+        unsigned long long from = parse_ull(bounds[0]);
+        unsigned long long to   = parse_ull(bounds[1]);
+        unsigned long long step = bounds.size() == 3 ? parse_ull(bounds[2]) : 1;
+        if (!step || to < from)
+            throw std::invalid_argument("Invalid range in list: \"" + item +
+                                        "\"");
+
+        for (unsigned long long value = from; value <= to; value += step)
+        {
+            values.push_back(value);
+            if (to - value < step) break;
+        }
+    }
+    return values;
+}
+
+std::vector<bool> parse_bool_list(const std::vector<std::string> &items)
+{
+    std::vector<bool> values;
+    for (std::string item : items)
+    {
+        item.erase(std::remove_if(item.begin(), item.end(), isspace),
+                   item.end());
+        if (item != "true" && item != "false")
+            throw std::invalid_argument("Not a boolean in list: \"" + item +
+                                        "\"");
+        values.push_back(item == "true");
+    }
+    return values;
+}
+
+std::vector<cl_configuration_data>
+sweep_points(const cl_configuration_data &arguments)
+{
+    const cl_sweep_data &sweep = arguments.sweep;
+
+    // Unswept parameters take their single value
+    auto values = [](const std::vector<unsigned long long> &swept,
+                     unsigned long long value) {
+        return swept.empty() ? std::vector<unsigned long long>{value} : swept;
+    };
+    std::vector<unsigned long long> resources =
+        values(sweep.resources, arguments.resources);
+    std::vector<unsigned long long> period =
+        values(sweep.period, arguments.period);
+    std::vector<unsigned long long> speed = values(sweep.speed, arguments.speed);
+    std::vector<unsigned long long> constitutive =
+        values(sweep.constitutive, arguments.constitutive);
+    std::vector<bool> dormant = sweep.dormant.empty()
+                                    ? std::vector<bool>{arguments.dormant}
+                                    : sweep.dormant;
+
+    std::vector<cl_configuration_data> points;
+    for (bool d : dormant)
+        for (unsigned long long r : resources)
+            for (unsigned long long p : period)
+                for (unsigned long long s : speed)
+                    for (unsigned long long k : constitutive)
+                    {
+                        cl_configuration_data point = arguments;
+                        point.mode                  = "basic";
+                        point.sweep                 = cl_sweep_data();
+                        point.dormant               = d;
+                        point.resources             = r;
+                        point.period                = p;
+                        point.speed                 = s;
+                        point.constitutive          = k;
+
+                        // The output folder is only named by the dormant
+                        // flag, resources and period
+                        if (speed.size() > 1)
+                            point.name += "_speed" + std::to_string(s);
+                        if (constitutive.size() > 1)
+                            point.name += "_constitutive" + std::to_string(k);
+
+                        points.push_back(point);
+                    }
+
+    if (!sweep.order.compare("longest"))
+        std::stable_sort(points.begin(), points.end(),
+                         [](const cl_configuration_data &a,
+                            const cl_configuration_data &b) {
+                             return a.resources * a.speed <
+                                    b.resources * b.speed;
+                         });
+    return points;
+}
+
 /**
  * Class definitions
  */
@@ -136,12 +313,14 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
 
     int dormant = -1;
     int summary = 0;
+    int huge_pages = -1;
 
     std::string config;
 
     while (1)
     {
-        static struct option long_options[] = {
+        // Not static, the flags point to the variables of this call
+        struct option long_options[] = {
             {"help", no_argument, 0, 'h'},
             {"gpu", no_argument, 0, 'g'},
             {"cells", required_argument, 0, 'c'},
@@ -161,14 +340,21 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
             {"probability", required_argument, 0, 'p'},
             {"output", required_argument, 0, 'O'},
             {"threads", required_argument, 0, 't'},
+            {"engine", required_argument, 0, 'e'},
+            {"sampler", required_argument, 0, 'S'},
+            {"format", required_argument, 0, 'F'},
+            {"cache-dir", required_argument, 0, 'K'},
+            {"huge-pages", no_argument, &huge_pages, 1},
+            {"rng", required_argument, 0, 'R'},
+            {"profile-bin", required_argument, 0, 'B'},
             {NULL, 0, NULL, 0}};
 
         /* getopt_long stores the option index here. */
         int option_index = 0;
 
         c = getopt_long(argc, argv,
-                        "h:g:c:o:r:s:T:DP:n:C:d:p:O:t:x:", long_options,
-                        &option_index);
+                        "h:g:c:o:r:s:T:DP:n:C:d:p:O:t:x:e:S:F:K:R:B:",
+                        long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
@@ -177,8 +363,19 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
         {
         case 0: break;
         case 'h':
-            // TODO: add help
-            throw std::invalid_argument("Usage: ");
+            throw std::invalid_argument(
+                "Usage: simulator --cells number_of_cells --organism "
+                "organism_name --resources number_of_forks --speed "
+                "speed_value --timeout timeout_value [--dormant] "
+                "[--constitutive range] [--period period_value] [--data-dir "
+                "directory_with_data] [--output output_directory] [--engine "
+                "step|event] [--sampler rejection|tree|gap|batch] [--format "
+                "text|zst|events|summary] [--cache-dir cache_directory] "
+                "[--huge-pages] [--rng mt19937|philox] [--profile-bin "
+                "bin_size] [--config config_file]\n"
+                "  --cache-dir  Folder of the memory mapped genome cache, "
+                "none by default, which disables it. \"output/cache\" keeps "
+                "it with the results.");
             break;
         case 'g':
             std::cout << "GPU Processing is broken for now. Ignoring option..."
@@ -199,6 +396,12 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
         case 'p': arguments.probability = std::stod(optarg); break;
         case 'O': arguments.output = std::string(optarg); break;
         case 't': arguments.threads = std::stoull(optarg); break;
+        case 'e': arguments.engine = std::string(optarg); break;
+        case 'S': arguments.sampler = std::string(optarg); break;
+        case 'F': arguments.format = std::string(optarg); break;
+        case 'K': arguments.cache_dir = std::string(optarg); break;
+        case 'R': arguments.rng = std::string(optarg); break;
+        case 'B': arguments.profile_bin = std::stoull(optarg); break;
 
         case '?':
             /* getopt_long already printed an error message. */
@@ -212,6 +415,7 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
     if (config.length() > 0) read_configuration_file(config, arguments);
 
     if (dormant >= 0) arguments.dormant = !!dormant;
+    if (huge_pages >= 0) arguments.huge_pages = !!huge_pages;
 
     if (!arguments.cells)
     {
@@ -223,7 +427,23 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
         throw std::invalid_argument("Argument \"organism\" (o) is mandatory!");
     }
 
-    if (!arguments.resources)
+    if (!arguments.mode.compare("sweep"))
+    {
+        for (unsigned long long value : arguments.sweep.resources)
+            if (!value)
+                throw std::invalid_argument(
+                    "Swept \"resources\" must be positive!");
+        for (unsigned long long value : arguments.sweep.speed)
+            if (!value)
+                throw std::invalid_argument(
+                    "Swept \"speed\" must be positive!");
+        if (arguments.sweep.order.compare("config") &&
+            arguments.sweep.order.compare("longest"))
+            throw std::invalid_argument(
+                "Sweep \"order\" must be \"config\" or \"longest\"!");
+    }
+
+    if (!arguments.resources && arguments.sweep.resources.empty())
     {
         throw std::invalid_argument("Argument \"resources\" (r) is mandatory!");
     }
@@ -233,6 +453,41 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
         throw std::invalid_argument("Argument \"timeout\" (T) is mandatory!");
     }
 
+    if (arguments.engine.compare("step") && arguments.engine.compare("event"))
+    {
+        throw std::invalid_argument(
+            "Argument \"engine\" (e) must be \"step\" or \"event\"!");
+    }
+
+    if (arguments.sampler.compare("rejection") &&
+        arguments.sampler.compare("tree") && arguments.sampler.compare("gap") &&
+        arguments.sampler.compare("batch"))
+    {
+        throw std::invalid_argument(
+            "Argument \"sampler\" (S) must be \"rejection\", \"tree\", "
+            "\"gap\" or \"batch\"!");
+    }
+
+    if (arguments.format.compare("text") && arguments.format.compare("zst") &&
+        arguments.format.compare("events") &&
+        arguments.format.compare("summary"))
+    {
+        throw std::invalid_argument("Argument \"format\" (F) must be \"text\", "
+                                    "\"zst\", \"events\" or \"summary\"!");
+    }
+
+    if (arguments.rng.compare("mt19937") && arguments.rng.compare("philox"))
+    {
+        throw std::invalid_argument(
+            "Argument \"rng\" (R) must be \"mt19937\" or \"philox\"!");
+    }
+
+    if (arguments.profile_bin > UINT32_MAX)
+    {
+        throw std::invalid_argument(
+            "Argument \"profile-bin\" (B) must fit in 32 bits!");
+    }
+
     // Set a GLOBAL seed based on a random device (possibly true random number)
     if (!arguments.seed)
     {
@@ -286,6 +541,36 @@ cl_configuration_data Configuration::configure_cmd_options(int argc,
                   << std::flush;
         std::cout << "Seed for the RNG        : " << arguments.seed << std::endl
                   << std::flush;
+        std::cout << "Simulation engine       : " << arguments.engine
+                  << std::endl
+                  << std::flush;
+        std::cout << "Origin sampler          : " << arguments.sampler
+                  << std::endl
+                  << std::flush;
+        std::cout << "Output format           : " << arguments.format
+                  << std::endl
+                  << std::flush;
+        std::cout << "Genome cache directory  : "
+                  << (arguments.cache_dir.empty() ? std::string("None")
+                                                  : arguments.cache_dir)
+                  << std::endl
+                  << std::flush;
+        std::cout << "Use huge pages          : "
+                  << (arguments.huge_pages ? "Yes" : "No") << std::endl
+                  << std::flush;
+        std::cout << "Random generator        : " << arguments.rng
+                  << std::endl
+                  << std::flush;
+        if (arguments.profile_bin)
+            std::cout << "Profile bin size        : " << arguments.profile_bin
+                      << std::endl
+                      << std::flush;
+        if (!arguments.mode.compare("sweep"))
+            std::cout << "Sweep points            : "
+                      << sweep_points(arguments).size() << std::endl
+                      << "Sweep order             : "
+                      << arguments.sweep.order << std::endl
+                      << std::flush;
     }
 
     return arguments;
@@ -351,6 +636,13 @@ bool operator==(const cl_evolution_data &a, const cl_evolution_data &b)
            a.fitness.min_coll.weight == b.fitness.min_coll.weight;
 }
 
+bool operator==(const cl_sweep_data &a, const cl_sweep_data &b)
+{
+    return a.resources == b.resources && a.period == b.period &&
+           a.speed == b.speed && a.constitutive == b.constitutive &&
+           a.dormant == b.dormant && a.order == b.order;
+}
+
 bool operator==(const cl_configuration_data &a, const cl_configuration_data &b)
 {
     return a.mode == b.mode && a.cells == b.cells && a.organism == b.organism &&
@@ -359,5 +651,10 @@ bool operator==(const cl_configuration_data &a, const cl_configuration_data &b)
            a.seed == b.seed && a.name == b.name && a.period == b.period &&
            a.constitutive == b.constitutive && a.data_dir == b.data_dir &&
            a.probability == b.probability && a.output == b.output &&
-           a.threads == b.threads && a.evolution == b.evolution;
+           a.threads == b.threads && a.engine == b.engine &&
+           a.sampler == b.sampler && a.format == b.format &&
+           a.cache_dir == b.cache_dir && a.huge_pages == b.huge_pages &&
+           a.rng == b.rng && a.profile_bin == b.profile_bin &&
+           a.evolution == b.evolution &&
+           a.sweep == b.sweep;
 }
@@ -0,0 +1,108 @@
+#include "constitutive_origin_index.hpp"
+#include <algorithm>
+#include <numeric>
+
+ConstitutiveOriginIndex::ConstitutiveOriginIndex() : next_unfired(1, 0) {}
+
+ConstitutiveOriginIndex::ConstitutiveOriginIndex(
+    const std::vector<constitutive_origin_t> &origins)
+    : order(origins.size()), fired(origins.size(), false),
+      next_unfired(origins.size() + 1)
+{
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint a, uint b) {
+        return origins[a].base < origins[b].base;
+    });
+    for (uint i : order)
+        this->origins.push_back(origins[i]);
+    std::iota(next_unfired.begin(), next_unfired.end(), 0);
+}
+
+uint ConstitutiveOriginIndex::first_unfired_from(uint i)
+{
+    uint root = i;
+    while (next_unfired[root] != root)
+        root = next_unfired[root];
+
+    // Point the whole path to the result, so later calls skip it
+    while (next_unfired[i] != root)
+    {
+        uint next       = next_unfired[i];
+        next_unfired[i] = root;
+        i               = next;
+    }
+    return root;
+}
+
+uint ConstitutiveOriginIndex::lower_bound(long long base) const
+{
+    return std::lower_bound(origins.begin(), origins.end(), base,
+                            [](const constitutive_origin_t &origin,
+                               long long base) { return origin.base < base; }) -
+           origins.begin();
+}
+
+uint ConstitutiveOriginIndex::size() const { return origins.size(); }
+
+bool ConstitutiveOriginIndex::fire(int base)
+{
+    bool fired_any = false;
+    for (uint i = lower_bound(base); i < size() && origins[i].base == base;
+         i++)
+    {
+        if (fired[i]) continue;
+        fired[i]        = true;
+        next_unfired[i] = i + 1;
+        fired_any       = true;
+    }
+    return fired_any;
+}
+
+bool ConstitutiveOriginIndex::is_fired(int base) const
+{
+    uint i = lower_bound(base);
+    return i < size() && origins[i].base == base && fired[i];
+}
+
+bool ConstitutiveOriginIndex::has_unfired(long long first, long long last)
+{
+    if (first > last) return false;
+    uint i = first_unfired_from(lower_bound(first));
+    return i < size() && origins[i].base <= last;
+}
+
+constitutive_origin_t ConstitutiveOriginIndex::first_unfired(long long first,
+                                                             long long last)
+{
+    constitutive_origin_t found;
+    found.base = -1;
+    if (first > last) return found;
+
+    uint found_order = order.size();
+    for (uint i = first_unfired_from(lower_bound(first));
+         i < size() && origins[i].base <= last;
+         i = first_unfired_from(i + 1))
+    {
+        if (order[i] < found_order)
+        {
+            found       = origins[i];
+            found_order = order[i];
+        }
+    }
+    return found;
+}
+
+std::vector<constitutive_origin_t> ConstitutiveOriginIndex::unfired()
+{
+    std::vector<constitutive_origin_t> unfired_origins;
+    for (uint i = first_unfired_from(0); i < size();
+         i = first_unfired_from(i + 1))
+        unfired_origins.push_back(origins[i]);
+    return unfired_origins;
+}
+
+void ConstitutiveOriginIndex::reset()
+{
+    std::fill(fired.begin(), fired.end(), false);
+    std::iota(next_unfired.begin(), next_unfired.end(), 0);
+}
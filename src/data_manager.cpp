@@ -2,21 +2,76 @@
 #include "chromosome.hpp"
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
 #include <cmath>
+#include <exception>
+#include <filesystem>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #undef __UNIFORM_LANDSCAPE__
 
+// Reads the whitespace separated scores of an MFA-Seq file
+static bool read_scores(std::string path, std::vector<double> &scores)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    std::string text(file.tellg(), '\0');
+    file.seekg(0);
+    file.read(&text[0], text.size());
+
+    const char *position = text.data();
+    const char *end      = position + text.size();
+    while (true)
+    {
+        while (position < end && std::isspace((unsigned char)*position))
+            position++;
+        if (position == end) return true;
+
+        double score;
+        auto result = std::from_chars(position, end, score);
+        if (result.ec != std::errc()) return false;
+
+        scores.push_back(score);
+        position = result.ptr;
+    }
+}
+
+// Shortest text that reads back as exactly p, so that every probability has
+// its own cache
+static std::string probability_text(double p)
+{
+    char text[64];
+    auto result = std::to_chars(text, text + sizeof(text), p);
+    return std::string(text, result.ptr);
+}
+
 DataManager::DataManager(std::string organism, std::string database_path,
-                         std::string mfa_seq_data_path, double p)
+                         std::string mfa_seq_data_path, double p,
+                         std::string cache_dir)
     : database_path(database_path), mfa_seq_data_path(mfa_seq_data_path),
       uniform(p)
 {
+    std::string cache_path;
+    if (!cache_dir.empty())
+    {
+        cache_path =
+            cache_dir + "/" + organism + "_" + probability_text(p) + ".cache";
+        if (load_cache(cache_path, organism))
+        {
+            freeze();
+            return;
+        }
+    }
+
     SQLite::Database db(database_path, SQLite::OPEN_READONLY);
     SQLite::Statement query(db, "select * from Chromosome where organism = ?");
     query.bind(1, organism);
@@ -26,22 +81,55 @@ DataManager::DataManager(std::string organism, std::string database_path,
         std::string code = query.getColumn("code").getString();
         int length       = query.getColumn("length").getInt();
 
-        lengths.insert(std::pair<std::string, int>(code, length));
-
+        ids[code] = codes.size();
         codes.push_back(code);
+        lengths.push_back(length);
 
-        try
-        {
-            generate_prob_landscape(code, length);
-            generate_constitutive_origins(code);
-            generate_transcription_regions(code);
-        }
-        catch (std::out_of_range &e)
-        {
-            std::cerr << e.what() << std::endl;
-            exit(-1);
-        }
+        // Every entry is created here, so that they can be filled in parallel
+        probability_landscape.emplace_back(length, 0.0);
+    }
+
+    try
+    {
+        generate_transcription_regions(db, organism);
+        generate_constitutive_origins(db, organism);
     }
+    catch (std::out_of_range &e)
+    {
+        std::cerr << e.what() << std::endl;
+        exit(-1);
+    }
+
+    // Parse the MFA-Seq files in parallel, one chromosome at a time. A
+    // failure is only reported once every worker has stopped
+    std::atomic<uint> next_id(0);
+    std::vector<std::exception_ptr> errors(codes.size());
+    std::vector<std::thread> workers;
+    uint n_workers = std::min<uint>(
+        codes.size(), std::max(1u, std::thread::hardware_concurrency()));
+    for (uint worker = 0; worker < n_workers; worker++)
+        workers.emplace_back([&] {
+            for (uint id = next_id++; id < codes.size(); id = next_id++)
+            {
+                try
+                {
+                    generate_prob_landscape(id);
+                }
+                catch (...)
+                {
+                    errors[id] = std::current_exception();
+                }
+            }
+        });
+    for (auto &worker : workers)
+        worker.join();
+
+    for (auto &error : errors)
+        if (error) std::rethrow_exception(error);
+
+    // The cache is written from the snapshot
+    freeze();
+    if (!cache_path.empty()) save_cache(cache_path, organism);
 }
 
 DataManager::~DataManager()
@@ -51,101 +139,165 @@ DataManager::~DataManager()
 
 const std::vector<std::string> &DataManager::get_codes() { return codes; }
 
-void DataManager::generate_transcription_regions(std::string code)
+void DataManager::freeze()
 {
-    try
+    std::vector<std::shared_ptr<const chromosome_data_t>> chromosomes;
+    for (uint id = 0; id < codes.size(); id++)
     {
-        SQLite::Database db(database_path, SQLite::OPEN_READONLY);
-        SQLite::Statement query(
-            db, "SELECT * FROM TranscriptionRegion WHERE chromosome_code = ?");
-        query.bind(1, code);
+        // Read straight from the vectors, callers may hold
+        // prob_landscape_mutex
+        landscape_view_t landscape;
+        if (cache)
+            landscape = cache->get_landscape(codes[id]);
+        else
+            landscape = landscape_view_t{probability_landscape[id].data(),
+                                         (uint)probability_landscape[id].size()};
+
+        auto data                        = std::make_shared<chromosome_data_t>();
+        data->code                       = codes[id];
+        data->length                     = lengths[id];
+        data->probability_landscape      = landscape;
+        data->transcription_regions      = transcription_regions[id];
+        data->transcription_region_index =
+            std::make_shared<const TranscriptionRegionIndex>(
+                *transcription_regions[id]);
+        data->constitutive_origins = constitutive_origins[id];
+
+        chromosomes.push_back(data);
+    }
+    snapshot = std::move(chromosomes);
+}
 
-        transcription_regions.insert(
-            std::pair<std::string, std::vector<transcription_region_t>>(
-                code, std::vector<transcription_region_t>()));
+uint DataManager::get_chromosome_id(std::string code)
+{
+    auto found = ids.find(code);
+    if (found == ids.end())
+        throw std::out_of_range("Chromosome " + code +
+                                " is not in the organism.");
+    return found->second;
+}
 
-        auto &regions = transcription_regions.at(code);
+std::shared_ptr<const chromosome_data_t>
+DataManager::get_chromosome_data(uint id)
+{
+    return snapshot.at(id);
+}
 
-        while (query.executeStep())
+bool DataManager::load_cache(std::string path, std::string organism)
+{
+    try
+    {
+        auto file = std::make_unique<GenomeCache>(path);
+        if (file->get_uniform() != uniform ||
+            file->get_source_hash() !=
+                GenomeCache::source_hash(organism, database_path,
+                                         mfa_seq_data_path, file->get_codes()))
+            return false;
+
+        for (auto code : file->get_codes())
         {
-            transcription_region_t region;
-            region.start = query.getColumn("start").getInt();
-            region.end   = query.getColumn("end").getInt();
-
-            regions.push_back(region);
+            ids[code] = codes.size();
+            codes.push_back(code);
+            lengths.push_back(file->get_length(code));
+            transcription_regions.push_back(
+                std::make_shared<const std::vector<transcription_region_t>>(
+                    file->get_transcription_regions(code)));
+            constitutive_origins.push_back(
+                std::make_shared<const std::vector<constitutive_origin_t>>(
+                    file->get_constitutive_origins(code)));
+            // Only copied from the cache when asked for
+            probability_landscape.emplace_back();
         }
+        cache = std::move(file);
+        return true;
     }
-    catch (int e)
+    catch (std::runtime_error &e)
     {
-        std::cout << "An error ocurred while loading database data. Error " << e
-                  << std::endl
-                  << std::fflush(nullptr);
-        exit(1);
+        // Missing or invalid, it is made again
+        return false;
     }
 }
 
-void DataManager::generate_constitutive_origins(std::string code)
+void DataManager::save_cache(std::string path, std::string organism)
 {
     try
     {
-        SQLite::Database db(database_path, SQLite::OPEN_READONLY);
-        SQLite::Statement query(
-            db, "SELECT * FROM ReplicationOrigin WHERE chromosome_code = ?");
-        query.bind(1, code);
-
-        constitutive_origins.insert(
-            std::pair<std::string, std::vector<constitutive_origin_t>>(
-                code, std::vector<constitutive_origin_t>()));
-
-        auto &origins = constitutive_origins.at(code);
-
-        while (query.executeStep())
-        {
-            constitutive_origin_t origin;
-            origin.base = query.getColumn("position").getInt();
-            origins.push_back(origin);
-        }
+        std::filesystem::create_directories(
+            std::filesystem::path(path).parent_path());
+        GenomeCache::write(path,
+                           GenomeCache::source_hash(organism, database_path,
+                                                    mfa_seq_data_path, codes),
+                           uniform, *this);
     }
-    catch (int e)
+    catch (std::exception &e)
     {
-        std::cout << "An error ocurred while loading database data. Error " << e
-                  << std::endl
-                  << std::fflush(nullptr);
-        exit(1);
+        std::cout << "[WARN] Could not write the genome cache " << path << ": "
+                  << e.what() << std::endl;
     }
 }
 
-void DataManager::generate_prob_landscape(std::string code, uint length)
+void DataManager::generate_transcription_regions(SQLite::Database &db,
+                                                 std::string organism)
 {
-    std::ifstream mfa_file;
-    std::vector<double> scores;
-    probability_landscape.insert(std::pair<std::string, std::vector<double>>(
-        code, std::vector<double>(length, 0.0)));
-
-    auto &landscape = probability_landscape.at(code);
-    double curr_score;
+    // Rows come in table order, as the chromosomes read them before
+    SQLite::Statement query(
+        db, "SELECT chromosome_code, start, \"end\" FROM TranscriptionRegion "
+            "WHERE chromosome_code IN "
+            "(SELECT code FROM Chromosome WHERE organism = ?) ORDER BY rowid");
+    query.bind(1, organism);
 
-    try
-    {
-        mfa_file.open(mfa_seq_data_path + code + ".txt");
-        if (!mfa_file.is_open()) { throw 1; }
-    }
-    catch (int e)
+    std::vector<std::vector<transcription_region_t>> regions(codes.size());
+    while (query.executeStep())
     {
-        std::cout << "An error ocurred while loading MFA_Seq["
-                  << mfa_seq_data_path + code + ".txt"
-                  << "] data. Error " << e << std::endl
-                  << std::fflush(nullptr);
-        exit(1);
+        transcription_region_t region;
+        region.start = query.getColumn(1).getInt();
+        region.end   = query.getColumn(2).getInt();
+
+        regions[ids.at(query.getColumn(0).getString())].push_back(region);
     }
 
-    while (!mfa_file.eof())
+    for (auto &chromosome_regions : regions)
+        transcription_regions.push_back(
+            std::make_shared<const std::vector<transcription_region_t>>(
+                std::move(chromosome_regions)));
+}
+
+void DataManager::generate_constitutive_origins(SQLite::Database &db,
+                                                std::string organism)
+{
+    // Rows come in table order, as the chromosomes read them before
+    SQLite::Statement query(
+        db, "SELECT chromosome_code, position FROM ReplicationOrigin "
+            "WHERE chromosome_code IN "
+            "(SELECT code FROM Chromosome WHERE organism = ?) ORDER BY rowid");
+    query.bind(1, organism);
+
+    std::vector<std::vector<constitutive_origin_t>> origins(codes.size());
+    while (query.executeStep())
     {
-        mfa_file >> curr_score;
-        if (curr_score != EOF) scores.push_back(curr_score);
-        curr_score = EOF;
+        constitutive_origin_t origin;
+        origin.base = query.getColumn(1).getInt();
+
+        origins[ids.at(query.getColumn(0).getString())].push_back(origin);
     }
-    mfa_file.close();
+
+    for (auto &chromosome_origins : origins)
+        constitutive_origins.push_back(
+            std::make_shared<const std::vector<constitutive_origin_t>>(
+                std::move(chromosome_origins)));
+}
+
+void DataManager::generate_prob_landscape(uint id)
+{
+    std::vector<double> scores;
+
+    const std::string &code = codes[id];
+    uint length             = lengths[id];
+    auto &landscape         = probability_landscape[id];
+
+    if (!read_scores(mfa_seq_data_path + code + ".txt", scores))
+        throw std::runtime_error("An error ocurred while loading MFA_Seq[" +
+                                 mfa_seq_data_path + code + ".txt] data.");
 
     int step = (int)(std::ceil(length / (float)(scores.size())));
 
@@ -160,15 +312,12 @@ void DataManager::generate_prob_landscape(std::string code, uint length)
         double mean = 0;
     #endif
 
-    std::ofstream probs_file;
-    probs_file.open(mfa_seq_data_path + code + "_probability.txt");
     for (int i = 0; i < (int)scores.size(); i++)
     {
         double prob = a * scores[i] + b;
 
         if (uniform) prob = uniform;
 
-        probs_file << std::fixed << std::setprecision(17) << prob << std::endl;
         for (int j = i * step; j < (i + 1) * step; j++)
         {
             landscape[j] = prob;
@@ -177,7 +326,6 @@ void DataManager::generate_prob_landscape(std::string code, uint length)
             #endif
             if (j == (int)length - 1)
             {
-                probs_file.close();
                 #ifdef __UNIFORM_LANDSCAPE__
                     mean = sum / landscape.size();
                     for (int k = 0; k < landscape.size(); k++)
@@ -191,78 +339,44 @@ void DataManager::generate_prob_landscape(std::string code, uint length)
     }
 }
 
-int DataManager::get_length(std::string code)
-{
-    std::lock_guard<std::mutex> guard(lengths_mutex);
-    try
-    {
-        return lengths.at(code);
-    }
-    catch (std::out_of_range &e)
-    {
-        std::cerr << code << ": " << e.what() << std::endl;
-        exit(-1);
-    }
-}
+int DataManager::get_length(uint id) { return lengths.at(id); }
 
-const std::vector<double> &
-DataManager::get_probability_landscape(std::string code)
+const std::vector<double> &DataManager::get_probability_landscape(uint id)
 {
     std::lock_guard<std::mutex> guard(prob_landscape_mutex);
 
-    try
+    // Landscapes in the cache are only copied to a vector when asked for
+    if (cache && probability_landscape.at(id).empty())
     {
-        return probability_landscape.at(code);
-    }
-    catch (std::out_of_range &e)
-    {
-        auto codes = get_codes();
-        for (auto code = codes.begin(); code != codes.end(); code++)
-            std::cerr << *code << std::endl << std::flush;
-
-        std::cerr << code << "[P]: " << e.what()
-                  << " - size: " << probability_landscape.size() << std::endl;
-        exit(-1);
+        landscape_view_t landscape = snapshot.at(id)->probability_landscape;
+        probability_landscape[id]  = std::vector<double>(
+            landscape.data, landscape.data + landscape.size);
     }
+    return probability_landscape.at(id);
 }
 
-const std::shared_ptr<std::vector<transcription_region_t>>
-DataManager::get_transcription_regions(std::string code)
+landscape_view_t DataManager::get_landscape_view(uint id)
 {
-    std::lock_guard<std::mutex> guard(transcription_regions_mutex);
-    try
-    {
-        return std::make_shared<std::vector<transcription_region_t>>(
-            transcription_regions.at(code));
-    }
-    catch (std::out_of_range &e)
-    {
-        auto codes = get_codes();
-        for (auto code = codes.begin(); code != codes.end(); code++)
-            std::cerr << *code << std::endl << std::flush;
+    if (!cache) return DataProvider::get_landscape_view(id);
 
-        std::cerr << code << "[T]: " << e.what() << std::endl;
-        exit(-1);
-    }
+    // The snapshot points into the mapped file
+    return snapshot.at(id)->probability_landscape;
 }
 
-const std::shared_ptr<std::vector<constitutive_origin_t>>
-DataManager::get_constitutive_origins(std::string code)
+std::shared_ptr<const std::vector<transcription_region_t>>
+DataManager::get_transcription_regions(uint id)
 {
-    std::lock_guard<std::mutex> guard(constitutive_origins_mutex);
-    try
-    {
-        return std::make_shared<std::vector<constitutive_origin_t>>(
-            constitutive_origins.at(code));
-    }
-    catch (std::out_of_range &e)
-    {
+    return snapshot.at(id)->transcription_regions;
+}
 
-        auto codes = get_codes();
-        for (auto code = codes.begin(); code != codes.end(); code++)
-            std::cerr << *code << std::endl << std::flush;
+std::shared_ptr<const std::vector<constitutive_origin_t>>
+DataManager::get_constitutive_origins(uint id)
+{
+    return snapshot.at(id)->constitutive_origins;
+}
 
-        std::cerr << code << "[C]: " << test << std::endl;
-        exit(-1);
-    }
+const std::shared_ptr<const TranscriptionRegionIndex>
+DataManager::get_transcription_region_index(uint id)
+{
+    return snapshot.at(id)->transcription_region_index;
 }
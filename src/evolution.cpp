@@ -160,14 +160,19 @@ void EvolutionManager::reproduce()
 
 void EvolutionManager::simulate()
 {
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 1)
     for (int i = 0; i < arguments.cells * arguments.evolution.population; i++)
     {
         int instance = i % arguments.evolution.population;
         int cell     = i / arguments.cells;
 
+        // Kept so that the Mersenne Twister runs give the same results as
+        // before
         SPhase s_phase(configuration, data_providers[cell],
-                       i ^ seed + current_generation);
+                       i ^ (seed + current_generation));
+        if (arguments.rng == "philox")
+            s_phase.reset(RandomGenerator(seed, i, current_generation,
+                                          RNG_STREAM_GENOME));
         s_phase.simulate(i);
 
         population[cell][instance] = s_phase.get_stats();
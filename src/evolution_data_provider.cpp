@@ -31,16 +31,14 @@ void EvolutionDataProvider::clone(EvolutionDataProvider &provider)
     probability_landscape = provider.probability_landscape;
     constitutive_origins  = provider.constitutive_origins;
     transcription_regions = provider.transcription_regions;
+    freeze();
 }
 
 void EvolutionDataProvider::mutate(cl_configuration_data config)
 {
     std::lock_guard<std::mutex> prob_guard(prob_landscape_mutex);
-    std::lock_guard<std::mutex> transcription_guard(
-        transcription_regions_mutex);
-    std::lock_guard<std::mutex> origins_guard(constitutive_origins_mutex);
 
-    auto codes = get_codes();
+    uint n_chromosomes = get_codes().size();
 
     std::uniform_real_distribution<double> uniform1(0, 1);
 
@@ -58,7 +56,8 @@ void EvolutionDataProvider::mutate(cl_configuration_data config)
                        .std);
 
             curve.location.base += normal(rand_generator);
-            auto length = get_length(curve.location.chromosome);
+            auto length =
+                get_chromosome_data(curve.location.chromosome)->length;
 
             if (curve.location.base < 0)
                 curve.location.base = 0;
@@ -78,18 +77,18 @@ void EvolutionDataProvider::mutate(cl_configuration_data config)
     }
 
     // Bell Curve Global Mutations
-    for (auto code = codes.begin(); code != codes.end(); code++)
+    for (uint id = 0; id < n_chromosomes; id++)
     {
 
         if (config.evolution.mutations.probability_landscape.add >
             uniform1(rand_generator))
         {
             auto curve  = BellCurve();
-            auto length = get_length(*code);
+            auto length = get_chromosome_data(id)->length;
             std::uniform_int_distribution<> distribution(length);
 
             curve.sigma               = 1;
-            curve.location.chromosome = *code;
+            curve.location.chromosome = id;
             curve.location.base       = distribution(rand_generator);
 
             bell_curves.push_back(curve);
@@ -106,12 +105,12 @@ void EvolutionDataProvider::mutate(cl_configuration_data config)
     }
 
     // Generate modified landscape
-    for (auto code = codes.begin(); code != codes.end(); code++)
+    for (uint id = 0; id < n_chromosomes; id++)
     {
-        auto length = get_length(*code);
+        auto length = get_chromosome_data(id)->length;
 
-        std::vector<double> &landscape      = probability_landscape[*code];
-        std::vector<double> &orig_landscape = original_landscape[*code];
+        std::vector<double> &landscape      = probability_landscape[id];
+        std::vector<double> &orig_landscape = original_landscape[id];
 
         for (int i = 0; i < length; i++)
         {
@@ -122,7 +121,7 @@ void EvolutionDataProvider::mutate(cl_configuration_data config)
         for (auto curve = bell_curves.begin(); curve != bell_curves.end();
              curve++)
         {
-            if (!code->compare(curve->location.chromosome))
+            if (curve->location.chromosome == id)
             {
                 for (int i = 0; i < length; i++)
                 {
@@ -148,6 +147,8 @@ void EvolutionDataProvider::mutate(cl_configuration_data config)
     }
 
     // TODO: Gene replacement and moving
+
+    freeze();
 }
 void EvolutionDataProvider::snapshot(std::string folder)
 {
@@ -0,0 +1,53 @@
+#include "fenwick_tree.hpp"
+#include <stdexcept>
+
+FenwickTree::FenwickTree() : sum(0) {}
+
+FenwickTree::FenwickTree(const std::vector<unsigned long long> &weights)
+    : tree(weights.size() + 1, 0), sum(0)
+{
+    // Linear construction: push each partial sum to its parent
+    for (uint i = 1; i <= weights.size(); i++)
+    {
+        tree[i] += weights[i - 1];
+        sum += weights[i - 1];
+        uint parent = i + (i & -i);
+        if (parent <= weights.size()) tree[parent] += tree[i];
+    }
+}
+
+uint FenwickTree::size() { return tree.empty() ? 0 : tree.size() - 1; }
+
+unsigned long long FenwickTree::total() { return sum; }
+
+void FenwickTree::add(uint index, long long delta)
+{
+    if (index >= size())
+        throw std::out_of_range("Given index is outside the FenwickTree.");
+
+    // Unsigned wrap around makes negative deltas work
+    sum += delta;
+    for (uint i = index + 1; i < tree.size(); i += i & -i)
+        tree[i] += delta;
+}
+
+uint FenwickTree::find(unsigned long long &target)
+{
+    if (target >= sum)
+        throw std::out_of_range("Given target is not below the total weight.");
+
+    uint index = 0;
+    uint step  = 1;
+    while (step * 2 < tree.size())
+        step *= 2;
+
+    for (; step > 0; step /= 2)
+    {
+        if (index + step < tree.size() && tree[index + step] <= target)
+        {
+            index += step;
+            target -= tree[index];
+        }
+    }
+    return index;
+}
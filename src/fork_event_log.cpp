@@ -0,0 +1,185 @@
+#include "fork_event_log.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Lowest and highest bases of a run
+static int run_low(const fork_run_t &run)
+{
+    return std::min(run.origin, run.last);
+}
+
+static int run_high(const fork_run_t &run)
+{
+    return std::max(run.origin, run.last);
+}
+
+// Orders runs by position. Of the runs that start at an origin, the longest
+// comes last.
+static bool run_before(const fork_run_t &a, const fork_run_t &b)
+{
+    return run_low(a) < run_low(b) ||
+           (run_low(a) == run_low(b) && run_high(a) < run_high(b));
+}
+
+std::string to_string(const fork_run_t &run)
+{
+    return std::to_string(run.origin) + "\t" + std::to_string(run.direction) +
+           "\t" + std::to_string(run.start_time) + "\t" +
+           std::to_string(run.last) + "\t" + std::string(1, run.end);
+}
+
+void ForkEventLog::attach(uint fork, uint chromosome, int origin,
+                          int direction, int time)
+{
+    if (fork >= open.size()) open.resize(fork + 1);
+    open[fork] = fork_run_t{chromosome, origin, direction, time, origin, 0};
+}
+
+void ForkEventLog::detach(uint fork, int last, char end)
+{
+    if (fork >= open.size() || open[fork].direction == 0)
+        throw std::runtime_error("This fork has no run started.");
+
+    fork_run_t run = open[fork];
+    run.last       = last;
+    run.end        = end;
+    runs.push_back(run);
+    open[fork].direction = 0;
+}
+
+const pool_vector<fork_run_t> &ForkEventLog::get_runs() const { return runs; }
+
+void ForkEventLog::clear()
+{
+    for (auto &run : open)
+        run.direction = 0;
+    runs.clear();
+}
+
+void ForkEventLog::write(std::string path, std::string code, uint length,
+                         uint speed, std::vector<fork_run_t> &runs)
+{
+    std::sort(runs.begin(), runs.end(), run_before);
+
+    std::ofstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Could not create file " + path);
+
+    file << "# " << code << " " << length << " " << speed << '\n';
+    for (auto &run : runs)
+        file << to_string(run) << '\n';
+    file.close();
+}
+
+ForkEventReader::ForkEventReader(std::string path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file " + path);
+
+    std::string line, mark;
+    std::getline(file, line);
+    std::istringstream header(line);
+    if (!(header >> mark >> code >> length >> speed) || mark != "#" ||
+        speed == 0)
+        throw std::runtime_error(path + " is not a fork event file.");
+
+    while (std::getline(file, line))
+    {
+        if (line.empty()) continue;
+
+        std::istringstream fields(line);
+        fork_run_t run{0, 0, 0, 0, 0, 0};
+        if (!(fields >> run.origin >> run.direction >> run.start_time >>
+              run.last >> run.end) ||
+            (run.direction != 1 && run.direction != -1) ||
+            run_low(run) < 0 || run_high(run) >= (int)length ||
+            (run.last - run.origin) * run.direction < 0)
+            throw std::runtime_error("Invalid fork run in " + path + ": " +
+                                     line);
+        runs.push_back(run);
+    }
+
+    std::sort(runs.begin(), runs.end(), run_before);
+}
+
+std::string ForkEventReader::get_code() const { return code; }
+
+uint ForkEventReader::get_length() const { return length; }
+
+uint ForkEventReader::get_speed() const { return speed; }
+
+const std::vector<fork_run_t> &ForkEventReader::get_runs() const
+{
+    return runs;
+}
+
+uint ForkEventReader::find(uint base) const
+{
+    // Runs only share origins, so if a run holds base the last one starting
+    // at base or before it does
+    auto next = std::upper_bound(
+        runs.begin(), runs.end(), (int)base,
+        [](int base, const fork_run_t &run) { return base < run_low(run); });
+    if (next == runs.begin()) return runs.size();
+
+    uint i = next - runs.begin() - 1;
+    return run_high(runs[i]) >= (int)base ? i : runs.size();
+}
+
+int ForkEventReader::time(uint base) const
+{
+    if (base >= length)
+        throw std::out_of_range("The base is not inside the Chromosome");
+
+    uint i = find(base);
+    return i < runs.size() ? time_at(runs[i], speed, base) : -1;
+}
+
+std::vector<int> ForkEventReader::times(uint first, uint last) const
+{
+    if (first > last || last >= length)
+        throw std::out_of_range("The range is not inside the Chromosome");
+
+    std::vector<int> result(last - first + 1, -1);
+
+    // Runs from the one holding first, or the first one after it
+    uint i = find(first);
+    if (i == runs.size())
+        i = std::upper_bound(runs.begin(), runs.end(), (int)first,
+                             [](int base, const fork_run_t &run) {
+                                 return base < run_low(run);
+                             }) -
+            runs.begin();
+
+    for (; i < runs.size() && run_low(runs[i]) <= (int)last; i++)
+    {
+        int from = std::max<int>(run_low(runs[i]), first);
+        int to   = std::min<int>(run_high(runs[i]), last);
+        for (int base = from; base <= to; base++)
+            result[base - first] = time_at(runs[i], speed, base);
+    }
+    return result;
+}
+
+Strand ForkEventReader::strand() const
+{
+    Strand strand(length);
+    for (auto &run : runs)
+    {
+        if (!strand.is_replicated(run.origin))
+            strand.replicate(run.origin - run.direction, run.direction, 0,
+                             run.start_time, 1);
+        strand.replicate(run.origin, run.direction, speed, run.start_time,
+                         (run.last - run.origin) * run.direction);
+    }
+    return strand;
+}
+
+int ForkEventReader::time_at(const fork_run_t &run, uint speed, int base)
+{
+    uint distance = (base - run.origin) * run.direction;
+    return run.start_time + (int)((distance + speed - 1) / speed);
+}
@@ -1,77 +1,294 @@
 #include "fork_manager.hpp"
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <stdexcept>
+
+// Extended Euclid: returns gcd(a, b) and x, y such that a * x + b * y = gcd.
+static long long extended_gcd(long long a, long long b, long long &x,
+                              long long &y)
+{
+    if (b == 0)
+    {
+        x = 1;
+        y = 0;
+        return a;
+    }
+    long long x1, y1;
+    long long gcd = extended_gcd(b, a % b, x1, y1);
+    x             = y1;
+    y             = x1 - (a / b) * y1;
+    return gcd;
+}
+
+// Smallest k in [k_min, k_max] with a * k = c (mod m), or -1 if none.
+static long long solve_congruence(long long a, long long c, long long m,
+                                  long long k_min, long long k_max)
+{
+    if (k_min > k_max) return -1;
+    a = a % m;
+    c = ((c % m) + m) % m;
+
+    long long x, y;
+    long long gcd = extended_gcd(a, m, x, y);
+    if (c % gcd != 0) return -1;
+
+    long long step = m / gcd;
+    long long k0   = ((c / gcd) % step * (x % step)) % step;
+    long long k    = k_min + (((k0 - k_min) % step) + step) % step;
+    return k <= k_max ? k : -1;
+}
 
 ForkManager::ForkManager(uint n_forks, std::shared_ptr<Genome> genome,
                          uint speed)
+    : genome(genome), speed(speed), fork_base(n_forks, -1),
+      fork_direction(n_forks, 0), fork_chromosome(n_forks, 0),
+      fork_flags(n_forks, 0), fork_idle_until(n_forks, 0),
+      fork_idle_path_end(n_forks, -1)
 {
-    this->n_forks                         = n_forks;
+    this->n_forks = n_forks;
+    for (auto chromosome : genome->chromosomes)
+        chromosomes.push_back(chromosome.get());
+    reset();
+}
+
+void ForkManager::reset()
+{
+    std::fill(fork_base.begin(), fork_base.end(), -1);
+    std::fill(fork_direction.begin(), fork_direction.end(), 0);
+    std::fill(fork_chromosome.begin(), fork_chromosome.end(), 0);
+    std::fill(fork_flags.begin(), fork_flags.end(), 0);
+    std::fill(fork_idle_until.begin(), fork_idle_until.end(), 0);
+    std::fill(fork_idle_path_end.begin(), fork_idle_path_end.end(), -1);
+
     this->n_free_forks                    = n_forks;
     this->metric_times_attached           = 0;
     this->metric_times_detached_normal    = 0;
     this->metric_times_detached_collision = 0;
-    for (int i = 0; i < (int)n_forks; i++)
+    free_forks.clear();
+    for (uint fork = n_forks; fork > 0; fork--)
+        free_forks.push_back(fork - 1);
+    if (event_log) event_log->clear();
+}
+
+void ForkManager::set_event_log(std::shared_ptr<ForkEventLog> event_log)
+{
+    this->event_log = event_log;
+}
+
+void ForkManager::log_attached_forks()
+{
+    if (!event_log) return;
+    for (uint fork = 0; fork < n_forks; fork++)
+        if (fork_direction[fork] != 0)
+            event_log->detach(fork, fork_base[fork], FORK_RUN_ATTACHED);
+}
+
+ReplicationFork ForkManager::get_fork(uint index)
+{
+    return ReplicationFork(this, index);
+}
+
+void ForkManager::push_free_fork(uint fork)
+{
+    auto position = std::lower_bound(free_forks.begin(), free_forks.end(),
+                                     fork, std::greater<uint>());
+    if (position == free_forks.end() || *position != fork)
+        free_forks.insert(position, fork);
+}
+
+void ForkManager::attach_fork(uint fork, const GenomicLocation &location,
+                              int direction, uint time)
+{
+    if (fork_direction[fork] != 0)
+        throw std::runtime_error("This fork is already attached.");
+    if (fork_flags[fork] & FORK_JUST_DETACHED)
+        throw std::runtime_error(
+            "This fork has just detached and cannot be used right now.");
+
+    uint chromosome = location.chromosome->get_index();
+    if (chromosome >= chromosomes.size() ||
+        chromosomes[chromosome] != location.chromosome)
+        throw std::invalid_argument("The location is not in the Genome.");
+
+    fork_base[fork]       = location.base;
+    fork_direction[fork]  = direction;
+    fork_chromosome[fork] = chromosome;
+    fork_flags[fork] &= ~FORK_IDLE_CACHED;
+    free_forks.erase(std::remove(free_forks.begin(), free_forks.end(), fork),
+                     free_forks.end());
+    chromosomes[chromosome]->replicate(location.base, location.base, time);
+    if (event_log)
+        event_log->attach(fork, chromosome, location.base, direction, time);
+}
+
+void ForkManager::detach_fork(uint fork, bool problem)
+{
+    if (event_log)
     {
-        replication_forks.push_back(
-            std::make_shared<ReplicationFork>(genome, this, speed));
+        int last  = fork_base[fork];
+        char end  = FORK_RUN_COLLISION;
+        uint size = chromosomes[fork_chromosome[fork]]->size();
+        if (problem)
+            end = last == (fork_direction[fork] == 1 ? (int)size - 1 : 0)
+                      ? FORK_RUN_END
+                      : FORK_RUN_MET;
+        event_log->detach(fork, last, end);
     }
+
+    fork_base[fork]      = -1;
+    fork_direction[fork] = 0;
+    fork_flags[fork] &= ~FORK_IDLE_CACHED;
+    if (problem)
+        fork_flags[fork] |= FORK_JUST_DETACHED;
+    else
+        push_free_fork(fork);
+    // increment metrics of detachment
+    // TODO: compare with the actual number of collisions
+    if (problem)
+        metric_times_detached_normal++;
+    else
+        metric_times_detached_collision++;
 }
 
-uint ForkManager::check_replication_transcription_conflicts(uint time,
-                                                            uint period,
-                                                            bool has_dormant)
+bool ForkManager::advance_fork(uint fork, uint time)
 {
-    uint n_collisions = 0;
+    int end_base = fork_base[fork] + (int)speed * fork_direction[fork];
 
-    uint RNAP_position = time % period;
-    for (auto fork : replication_forks)
+    // A fork that fails stops short of end_base, the log needs where
+    uint run = event_log ? chromosomes[fork_chromosome[fork]]->unreplicated_run(
+                               fork_base[fork], fork_direction[fork], speed)
+                         : 0;
+    if (!chromosomes[fork_chromosome[fork]]->replicate(fork_base[fork],
+                                                       end_base, time))
     {
-        if (fork->is_attached())
-        {
-            std::shared_ptr<Chromosome> chromosome = fork->get_chromosome();
-            for (auto region : *chromosome->get_transcription_regions())
-            {
-                uint replisome_position_within_region = 0;
-                int RNAP_direction                    = 0;
+        fork_base[fork] += fork_direction[fork] * (int)run;
+        detach_fork(fork, true);
+        return false;
+    }
+
+    fork_base[fork] = end_base;
+    return true;
+}
 
+uint ForkManager::fork_idle_steps(uint fork, uint time, uint period,
+                                  uint limit)
+{
+    if ((fork_flags[fork] & FORK_IDLE_CACHED) &&
+        fork_idle_until[fork] > time + 1)
+        return std::min(fork_idle_until[fork] - time - 1, limit);
+
+    Chromosome *chromosome = chromosomes[fork_chromosome[fork]];
+    int base               = fork_base[fork];
+    int direction          = fork_direction[fork];
+
+    // Free path ahead of the fork
+    uint max_run = (uint)std::min<unsigned long long>(
+        2ULL * speed * limit, chromosome->size());
+    uint run          = chromosome->unreplicated_run(base, direction, max_run);
+    int idle_path_end = base + direction * (int)(run + 1);
+    fork_idle_path_end[fork] = idle_path_end;
+
+    bool reaches_end =
+        idle_path_end < 0 || idle_path_end >= (int)chromosome->size();
+    uint steps = reaches_end ? run / speed : run / (2 * speed);
+    steps      = std::min(steps, limit);
+
+    // First head-to-head collision with an RNAP. The fork is at base
+    // + direction * speed * k at time + k, so the position within the region
+    // must satisfy k * (speed + 1) = c (mod period).
+    if (period > 0)
+    {
+        // Only regions on the path of the fork in the next steps + 1 steps
+        long long path_end = base + (long long)direction * speed * (steps + 1);
+        chromosome->get_transcription_region_index().find_overlapping(
+            std::min<long long>(base, path_end),
+            std::max<long long>(base, path_end),
+            [&](const transcription_region_t &region) {
+                long long k_min, k_max, c;
                 if (region.start < region.end)
                 {
-                    if (fork->get_base() < (int)region.start ||
-                        fork->get_base() > (int)region.end)
-                        continue;
-
-                    replisome_position_within_region =
-                        fork->get_base() - region.start;
-                    RNAP_direction = 1;
+                    if (direction != -1) return false;
+                    long long to_end = (long long)base - region.end;
+                    k_min = to_end > 0 ? (to_end + speed - 1) / speed : 1;
+                    k_max = ((long long)base - region.start) >= 0
+                                ? ((long long)base - region.start) / speed
+                                : 0;
+                    c     = (long long)base - region.start - time;
                 }
                 else
                 {
-                    if (fork->get_base() > (int)region.start ||
-                        fork->get_base() < (int)region.end)
-                        continue;
-                    replisome_position_within_region =
-                        region.start - fork->get_base();
-
-                    RNAP_direction = -1;
+                    if (direction != 1) return false;
+                    long long to_end = (long long)region.end - base;
+                    k_min = to_end > 0 ? (to_end + speed - 1) / speed : 1;
+                    k_max = ((long long)region.start - base) >= 0
+                                ? ((long long)region.start - base) / speed
+                                : 0;
+                    c     = (long long)region.start - base - time;
                 }
+                k_max = std::min<long long>(k_max, (long long)steps + 1);
 
-                // Head to head collision!
-                if (replisome_position_within_region % period ==
-                        RNAP_position &&
-                    fork->get_direction() != RNAP_direction)
-                {
-                    if (has_dormant)
+                long long k =
+                    solve_congruence(speed + 1, c, period,
+                                     std::max<long long>(k_min, 1), k_max);
+                if (k > 0) steps = std::min<uint>(steps, k - 1);
+                return false;
+            });
+    }
+
+    fork_flags[fork] |= FORK_IDLE_CACHED;
+    fork_idle_until[fork] = time + steps + 1;
+    return steps;
+}
+
+uint ForkManager::check_replication_transcription_conflicts(uint time,
+                                                            uint period,
+                                                            bool has_dormant)
+{
+    uint n_collisions = 0;
+
+    uint RNAP_position = time % period;
+    for (uint fork = 0; fork < n_forks; fork++)
+    {
+        if (fork_direction[fork] == 0) continue;
+
+        Chromosome *chromosome = chromosomes[fork_chromosome[fork]];
+        int base               = fork_base[fork];
+        int direction          = fork_direction[fork];
+
+        // Only the regions that contain the fork can collide with it
+        bool collided =
+            chromosome->get_transcription_region_index().find_containing(
+                base, [&](const transcription_region_t &region) {
+                    uint replisome_position_within_region = 0;
+                    int RNAP_direction                    = 0;
+
+                    if (region.start < region.end)
                     {
-                        chromosome->set_dormant_activation_probability(
-                            fork->get_base());
+                        replisome_position_within_region = base - region.start;
+                        RNAP_direction                   = 1;
                     }
-                    fork->detach();
-                    n_free_forks++;
-                    n_collisions++;
-                    // This fork collided, so there is no need to check other
-                    // regions with it
-                    break;
-                }
+                    else
+                    {
+                        replisome_position_within_region = region.start - base;
+                        RNAP_direction                   = -1;
+                    }
+
+                    // Head to head collision!
+                    return replisome_position_within_region % period ==
+                               RNAP_position &&
+                           direction != RNAP_direction;
+                });
+
+        if (collided)
+        {
+            if (has_dormant)
+            {
+                chromosome->set_dormant_activation_probability(base);
             }
+            detach_fork(fork, false);
+            n_free_forks++;
+            n_collisions++;
         }
     }
     return n_collisions;
@@ -79,36 +296,63 @@ uint ForkManager::check_replication_transcription_conflicts(uint time,
 
 void ForkManager::advance_attached_forks(uint time)
 {
-    for (auto fork : replication_forks)
+    for (uint fork = 0; fork < n_forks; fork++)
     {
-        if (fork->get_just_detached())
+        if (fork_flags[fork] & FORK_JUST_DETACHED)
         {
-            fork->set_just_detached(false);
+            fork_flags[fork] &= ~FORK_JUST_DETACHED;
+            push_free_fork(fork);
             n_free_forks++;
         }
-        else if (fork->is_attached())
-            fork->advance(time);
+        else if (fork_direction[fork] != 0)
+            advance_fork(fork, time);
+    }
+}
+
+void ForkManager::advance_attached_forks(uint time, uint n_steps)
+{
+    for (uint fork = 0; fork < n_forks; fork++)
+    {
+        if (fork_direction[fork] == 0) continue;
+        chromosomes[fork_chromosome[fork]]->replicate_run(
+            fork_base[fork], fork_direction[fork], speed, time, n_steps);
+        fork_base[fork] += fork_direction[fork] * (int)(speed * n_steps);
     }
 }
 
-void ForkManager::attach_forks(GenomicLocation &location, uint time)
+uint ForkManager::idle_steps(uint time, uint period, uint limit)
 {
-    if (n_free_forks < 2) return;
+    uint idle = limit;
+    for (uint fork = 0; fork < n_forks; fork++)
+    {
+        if (fork_flags[fork] & FORK_JUST_DETACHED) return 0;
+        if (fork_direction[fork] != 0)
+            idle = std::min(idle, fork_idle_steps(fork, time, period, idle));
+    }
+    return idle;
+}
+
+void ForkManager::attach_forks(const GenomicLocation &location, uint time)
+{
+    if (n_free_forks < 2 || free_forks.size() < 2) return;
 
-    uint n_forks_attached = 0;
-    int direction         = 1;
+    // The two free forks with the lowest indexes
+    uint first_fork  = free_forks[free_forks.size() - 1];
+    uint second_fork = free_forks[free_forks.size() - 2];
+    attach_fork(first_fork, location, 1, time);
+    attach_fork(second_fork, location, -1, time);
+    location.chromosome->add_fired_origin();
 
-    for (auto fork : replication_forks)
+    // The new origin may lie on the free path other forks were counting on
+    uint chromosome = fork_chromosome[first_fork];
+    int base        = location.base;
+    for (uint fork = 0; fork < n_forks; fork++)
     {
-        if (!fork->is_attached() && !fork->get_just_detached())
-        {
-            fork->attach(location, direction, time);
-            n_forks_attached++;
-            direction = -direction;
-            if (n_forks_attached == 2) break;
-        }
+        if (fork_direction[fork] != 0 && fork_chromosome[fork] == chromosome &&
+            base >= std::min(fork_base[fork], fork_idle_path_end[fork]) &&
+            base <= std::max(fork_base[fork], fork_idle_path_end[fork]))
+            fork_flags[fork] &= ~FORK_IDLE_CACHED;
     }
-    if (n_forks_attached == 2) location.chromosome->add_fired_origin();
-    metric_times_attached += n_forks_attached;
-    n_free_forks -= n_forks_attached;
+    metric_times_attached += 2;
+    n_free_forks -= 2;
 }
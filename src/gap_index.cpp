@@ -0,0 +1,195 @@
+#include "gap_index.hpp"
+#include <stdexcept>
+
+GapIndex::GapIndex() : root(-1), priority_state(2463534242u) {}
+
+GapIndex::GapIndex(uint length) : GapIndex()
+{
+    if (length > 0) insert(0, length - 1);
+}
+
+GapIndex::GapIndex(const std::vector<std::pair<uint, uint>> &gaps)
+    : GapIndex()
+{
+    for (auto gap : gaps)
+        insert(gap.first, gap.second);
+}
+
+unsigned long long GapIndex::total_of(int node) const
+{
+    return node < 0 ? 0 : nodes[node].total;
+}
+
+void GapIndex::update(int node)
+{
+    gap_node_t &gap = nodes[node];
+    gap.total       = total_of(gap.left) + total_of(gap.right) +
+                (gap.last - gap.first + 1);
+}
+
+int GapIndex::new_node(uint first, uint last)
+{
+    // Xorshift, enough to keep the treap balanced
+    priority_state ^= priority_state << 13;
+    priority_state ^= priority_state >> 17;
+    priority_state ^= priority_state << 5;
+
+    gap_node_t gap;
+    gap.first    = first;
+    gap.last     = last;
+    gap.total    = last - first + 1;
+    gap.priority = priority_state;
+    gap.left     = -1;
+    gap.right    = -1;
+
+    if (free_nodes.empty())
+    {
+        nodes.push_back(gap);
+        return nodes.size() - 1;
+    }
+    int node = free_nodes.back();
+    free_nodes.pop_back();
+    nodes[node] = gap;
+    return node;
+}
+
+void GapIndex::split(int node, uint key, int &left, int &right)
+{
+    if (node < 0)
+    {
+        left = right = -1;
+        return;
+    }
+    if (nodes[node].first < key)
+    {
+        split(nodes[node].right, key, nodes[node].right, right);
+        left = node;
+    }
+    else
+    {
+        split(nodes[node].left, key, left, nodes[node].left);
+        right = node;
+    }
+    update(node);
+}
+
+int GapIndex::merge(int left, int right)
+{
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (nodes[left].priority > nodes[right].priority)
+    {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
+
+void GapIndex::insert(uint first, uint last)
+{
+    int left, right;
+    split(root, first, left, right);
+    root = merge(merge(left, new_node(first, last)), right);
+}
+
+void GapIndex::erase(uint first)
+{
+    int left, middle, right;
+    split(root, first, left, right);
+    split(right, first + 1, middle, right);
+    if (middle >= 0) free_nodes.push_back(middle);
+    root = merge(left, right);
+}
+
+uint GapIndex::size() const { return nodes.size() - free_nodes.size(); }
+
+unsigned long long GapIndex::total() const { return total_of(root); }
+
+void GapIndex::remove(uint first, uint last)
+{
+    if (first > last) return;
+
+    // The gap that starts at first or before it
+    int node = -1;
+    for (int curr = root; curr >= 0;)
+    {
+        if (nodes[curr].first <= first)
+        {
+            node = curr;
+            curr = nodes[curr].right;
+        }
+        else
+            curr = nodes[curr].left;
+    }
+    if (node < 0 || nodes[node].last < last)
+        throw std::out_of_range("Given run is not inside a single gap.");
+
+    uint gap_first = nodes[node].first;
+    uint gap_last  = nodes[node].last;
+    if (gap_first == first && gap_last == last)
+    {
+        erase(first);
+        return;
+    }
+
+    // Cut the gap at first, keeping it in place so that only the totals on
+    // the path to it change, and add back what is left after last
+    uint n_bases = gap_first == first ? last - first + 1 : gap_last - first + 1;
+    for (int curr = root;; curr = nodes[curr].first < gap_first
+                                     ? nodes[curr].right
+                                     : nodes[curr].left)
+    {
+        nodes[curr].total -= n_bases;
+        if (curr == node) break;
+    }
+    if (gap_first == first)
+        nodes[node].first = last + 1;
+    else
+        nodes[node].last = first - 1;
+    if (gap_first < first && gap_last > last) insert(last + 1, gap_last);
+}
+
+uint GapIndex::find(unsigned long long rank) const
+{
+    if (rank >= total())
+        throw std::out_of_range("Given rank is not below the total of bases.");
+
+    int node = root;
+    while (true)
+    {
+        const gap_node_t &gap = nodes[node];
+        if (rank < total_of(gap.left))
+        {
+            node = gap.left;
+            continue;
+        }
+        rank -= total_of(gap.left);
+        if (rank <= gap.last - gap.first) return gap.first + rank;
+        rank -= gap.last - gap.first + 1;
+        node = gap.right;
+    }
+}
+
+std::vector<std::pair<uint, uint>> GapIndex::get_gaps() const
+{
+    // In-order walk with an explicit stack
+    std::vector<std::pair<uint, uint>> gaps;
+    std::vector<int> stack;
+    int node = root;
+    while (node >= 0 || !stack.empty())
+    {
+        while (node >= 0)
+        {
+            stack.push_back(node);
+            node = nodes[node].left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        gaps.push_back(std::make_pair(nodes[node].first, nodes[node].last));
+        node = nodes[node].right;
+    }
+    return gaps;
+}
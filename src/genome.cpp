@@ -7,9 +7,10 @@
 
 Genome::Genome(std::vector<std::shared_ptr<Chromosome>> &chromosomes,
                unsigned long long seed)
-    : seed(seed)
+    : activation_sampling(false), gap_sampling(false),
+      n_unreplicated_bases(std::make_shared<unsigned long long>(0)), seed(seed)
 {
-    this->rand_generator = std::mt19937(seed);
+    this->rand_generator = RandomGenerator(seed);
     initialize(chromosomes);
 }
 
@@ -19,23 +20,31 @@ void Genome::initialize(std::vector<std::shared_ptr<Chromosome>> &chromosomes)
 
     for (auto chromosome = 0; chromosome < chromosomes.size(); chromosome++)
     {
+        chromosomes[chromosome]->index = this->chromosomes.size();
+        chromosomes[chromosome]->genome_unreplicated_bases =
+            n_unreplicated_bases;
+        *n_unreplicated_bases += chromosomes[chromosome]->size() -
+                                 chromosomes[chromosome]->n_replicated_bases;
         this->chromosomes.push_back(chromosomes[chromosome]);
         chromosome_sizes.push_back(chromosomes[chromosome]->size());
     }
 
     this->chromosome_distribution = std::discrete_distribution<int>(
         chromosome_sizes.begin(), chromosome_sizes.end());
+    if (!this->chromosomes.empty())
+        this->chromosome_table =
+            AliasTable(this->chromosome_distribution.probabilities());
 }
 
 uint Genome::size()
 {
     uint tot_length = 0;
-    for (auto chromosome : chromosomes)
+    for (auto &chromosome : chromosomes)
         tot_length += chromosome->size();
     return tot_length;
 }
 
-std::shared_ptr<GenomicLocation> Genome::random_genomic_location()
+GenomicLocation Genome::random_genomic_location()
 {
     uint rand_chromosome = chromosome_distribution(rand_generator);
 
@@ -46,12 +55,50 @@ std::shared_ptr<GenomicLocation> Genome::random_genomic_location()
     base_distribution.param(bases_dist);
 
     uint rand_base = base_distribution(rand_generator);
-    return std::make_shared<GenomicLocation>(
+    return GenomicLocation(
         rand_base, chromosomes[rand_chromosome], &this->rand_generator);
 }
 
+void Genome::random_candidates(uint n, candidate_batch_t &batch)
+{
+    batch.chromosomes.resize(n);
+    batch.bases.resize(n);
+    batch.thresholds.resize(n);
+    batch.probabilities.resize(n);
+    batch.accepted.resize(n);
+    batch.words.resize(3 * (size_t)n);
+
+    // One word for the Chromosome, one for the base and one for the threshold
+    rand_generator.fill(batch.words.data(), batch.words.size());
+    const uint64_t *chromosome_words = batch.words.data();
+    const uint64_t *base_words       = chromosome_words + n;
+    const uint64_t *threshold_words  = base_words + n;
+
+    for (uint i = 0; i < n; i++)
+        batch.chromosomes[i] = chromosome_table.sample(chromosome_words[i]);
+    for (uint i = 0; i < n; i++)
+        batch.bases[i] = (uint)(((unsigned __int128)base_words[i] *
+                                 chromosomes[batch.chromosomes[i]]->size()) >>
+                                64);
+    for (uint i = 0; i < n; i++)
+        batch.thresholds[i] = (threshold_words[i] >> 11) * 0x1.0p-53;
+
+    for (uint i = 0; i < n; i++)
+        batch.probabilities[i] =
+            chromosomes[batch.chromosomes[i]]->activation_probability(
+                batch.bases[i]);
+    for (uint i = 0; i < n; i++)
+        batch.accepted[i] = batch.thresholds[i] < batch.probabilities[i];
+}
+
+GenomicLocation Genome::location(uint chromosome, uint base)
+{
+    return GenomicLocation(base, chromosomes[chromosome],
+                           &this->rand_generator);
+}
+
 // Actually never used, still here for eventual future use
-std::shared_ptr<GenomicLocation> Genome::random_unreplicated_genomic_location()
+GenomicLocation Genome::random_unreplicated_genomic_location()
 {
     if (this->is_replicated())
         throw std::runtime_error("There are no unreplicated bases available.");
@@ -66,23 +113,164 @@ std::shared_ptr<GenomicLocation> Genome::random_unreplicated_genomic_location()
         rand_base = rand() % chromosomes[rand_chromosome]->size();
     while (chromosomes[rand_chromosome]->base_is_replicated(rand_base));
 
-    return std::make_shared<GenomicLocation>(
+    return GenomicLocation(
         rand_base, chromosomes[rand_chromosome], &this->rand_generator);
 }
 
-bool Genome::is_replicated()
+double Genome::activation_bound(bool use_constitutive_origins,
+                                uint origins_range)
 {
-    bool replicated = true;
-    for (auto chromosome : chromosomes)
-        if (!chromosome->is_replicated()) replicated = false;
+    double bound = 0;
+    for (auto &chromosome : chromosomes)
+    {
+        if (!use_constitutive_origins)
+        {
+            bound += chromosome->unreplicated_activation_mass();
+            continue;
+        }
+        for (auto window : chromosome->unfired_origin_windows(origins_range))
+            bound += window.second - window.first + 1;
+    }
+    return bound;
+}
 
-    return replicated;
+void Genome::enable_activation_sampling()
+{
+    for (auto &chromosome : chromosomes)
+        chromosome->enable_activation_sampling();
+    activation_sampling = true;
+}
+
+void Genome::enable_gap_sampling()
+{
+    for (auto &chromosome : chromosomes)
+        chromosome->enable_gap_sampling();
+    gap_sampling = true;
 }
 
+void Genome::reset(unsigned long long seed)
+{
+    this->seed = seed;
+    reset(RandomGenerator(seed));
+}
+
+void Genome::reset(const RandomGenerator &rand_generator)
+{
+    this->rand_generator = rand_generator;
+    chromosome_distribution.reset();
+    base_distribution.reset();
+    for (auto &chromosome : chromosomes)
+        chromosome->reset();
+}
+
+GenomicLocation
+Genome::random_activation_candidate(bool use_constitutive_origins,
+                                    uint origins_range)
+{
+    // Without activation mass the rejection loops below would never end
+    unsigned long long total = 0;
+    if (!use_constitutive_origins)
+    {
+        for (auto &chromosome : chromosomes)
+            total += chromosome->unreplicated_activation_units();
+        if (total == 0)
+            throw std::runtime_error("There are no bases able to activate.");
+    }
+
+    if (!use_constitutive_origins && activation_sampling)
+    {
+        std::uniform_int_distribution<unsigned long long> mass_distribution(
+            0, total - 1);
+        unsigned long long target = mass_distribution(rand_generator);
+        for (auto &chromosome : chromosomes)
+        {
+            unsigned long long units = chromosome->unreplicated_activation_units();
+            if (target < units)
+                return GenomicLocation(
+                    chromosome->random_activation_base(target), chromosome,
+                    &this->rand_generator);
+            target -= units;
+        }
+    }
+
+    if (!use_constitutive_origins && gap_sampling)
+    {
+        unsigned long long total_unreplicated = 0;
+        for (auto &chromosome : chromosomes)
+            total_unreplicated +=
+                chromosome->size() - chromosome->get_n_replicated_bases();
+
+        // Same rejection as below, without trying replicated bases
+        std::uniform_int_distribution<unsigned long long> rank_distribution(
+            0, total_unreplicated - 1);
+        while (true)
+        {
+            unsigned long long rank = rank_distribution(rand_generator);
+            for (auto &chromosome : chromosomes)
+            {
+                unsigned long long n_unreplicated =
+                    chromosome->size() - chromosome->get_n_replicated_bases();
+                if (rank >= n_unreplicated)
+                {
+                    rank -= n_unreplicated;
+                    continue;
+                }
+                GenomicLocation location(
+                    chromosome->random_unreplicated_base(rank), chromosome,
+                    &this->rand_generator);
+                if (location.will_activate(false, origins_range))
+                    return location;
+                break;
+            }
+        }
+    }
+
+    if (!use_constitutive_origins)
+    {
+        // Rejection sampling gives each unreplicated base a chance
+        // proportional to its activation probability
+        while (true)
+        {
+            GenomicLocation location = random_genomic_location();
+            if (!location.is_replicated() &&
+                location.will_activate(false, origins_range))
+                return location;
+        }
+    }
+
+    // Uniform base around the unfired constitutive origins
+    std::uniform_int_distribution<unsigned long long> bound_distribution(
+        0, (unsigned long long)activation_bound(true, origins_range) - 1);
+    unsigned long long offset = bound_distribution(rand_generator);
+
+    for (auto &chromosome : chromosomes)
+    {
+        for (auto window : chromosome->unfired_origin_windows(origins_range))
+        {
+            unsigned long long window_size = window.second - window.first + 1;
+            if (offset < window_size)
+                return GenomicLocation(
+                    window.first + offset, chromosome, &this->rand_generator);
+            offset -= window_size;
+        }
+    }
+    throw std::runtime_error("There are no constitutive origins to fire.");
+}
+
+unsigned long long Genome::random_failed_attempts(double success_probability)
+{
+    if (success_probability >= 1) return 0;
+    std::geometric_distribution<unsigned long long> failures(
+        success_probability);
+    return failures(rand_generator);
+}
+
+bool Genome::is_replicated() { return *n_unreplicated_bases == 0; }
+
 double Genome::average_interorigin_distance()
 {
     uint n_interorigin_spaces = 0;
-    for (auto chromosome : chromosomes)
+    for (auto &chromosome : chromosomes)
     {
         // TODO: this +1 should always be added, or only whe there are fired
         // origins
@@ -95,7 +283,7 @@ double Genome::average_interorigin_distance()
 uint Genome::n_constitutive_origins()
 {
     uint n_origins = 0;
-    for (auto chromosome : chromosomes)
+    for (auto &chromosome : chromosomes)
     {
         n_origins += chromosome->n_constitutive_origins();
     }
@@ -0,0 +1,247 @@
+#include "genome_cache.hpp"
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Sections of the file start at multiples of 8 bytes
+static uint64_t aligned(uint64_t offset) { return (offset + 7) & ~7ULL; }
+
+// FNV-1a
+static void hash_bytes(unsigned long long &hash, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+}
+
+static void hash_file(unsigned long long &hash, std::string path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file " + path);
+
+    std::vector<char> buffer(1 << 16);
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        hash_bytes(hash, buffer.data(), file.gcount());
+    }
+}
+
+GenomeCache::GenomeCache(std::string path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Could not open file " + path);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 ||
+        (size_t)status.st_size < sizeof(genome_cache_header_t))
+    {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a genome cache.");
+    }
+
+    mapping_size = status.st_size;
+    void *address =
+        mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Could not map file " + path);
+    mapping = (const char *)address;
+
+    try
+    {
+        if (header()->magic != GENOME_CACHE_MAGIC)
+            throw std::runtime_error(path + " is not a genome cache.");
+        if (header()->version != GENOME_CACHE_VERSION)
+            throw std::runtime_error("Unsupported genome cache version " +
+                                     std::to_string(header()->version) + ".");
+
+        uint64_t n_chromosomes = header()->n_chromosomes;
+        if (n_chromosomes > (mapping_size - sizeof(genome_cache_header_t)) /
+                                sizeof(genome_cache_entry_t))
+            throw std::runtime_error(path + " is truncated.");
+
+        auto table = (const genome_cache_entry_t *)(mapping +
+                                                    sizeof(genome_cache_header_t));
+        for (uint64_t i = 0; i < n_chromosomes; i++)
+        {
+            const genome_cache_entry_t &chromosome = table[i];
+            if (chromosome.code_offset + chromosome.code_size > mapping_size ||
+                chromosome.landscape_offset +
+                        chromosome.length * sizeof(double) >
+                    mapping_size ||
+                chromosome.regions_offset +
+                        chromosome.n_regions * sizeof(transcription_region_t) >
+                    mapping_size ||
+                chromosome.origins_offset +
+                        chromosome.n_origins * sizeof(constitutive_origin_t) >
+                    mapping_size)
+                throw std::runtime_error(path + " is truncated.");
+
+            std::string code(mapping + chromosome.code_offset,
+                             chromosome.code_size);
+            codes.push_back(code);
+            entries[code] = &chromosome;
+        }
+    }
+    catch (std::runtime_error &e)
+    {
+        munmap((void *)mapping, mapping_size);
+        throw;
+    }
+}
+
+GenomeCache::~GenomeCache() { munmap((void *)mapping, mapping_size); }
+
+const genome_cache_header_t *GenomeCache::header()
+{
+    return (const genome_cache_header_t *)mapping;
+}
+
+const genome_cache_entry_t *GenomeCache::entry(std::string code)
+{
+    auto found = entries.find(code);
+    if (found == entries.end())
+        throw std::out_of_range("Chromosome " + code +
+                                " is not in the genome cache.");
+    return found->second;
+}
+
+void GenomeCache::write(std::string path, unsigned long long source_hash,
+                        double uniform, DataProvider &provider)
+{
+    const std::vector<std::string> &codes = provider.get_codes();
+
+    // Lay out the file: header, table, then the data of each Chromosome
+    genome_cache_header_t file_header = {GENOME_CACHE_MAGIC,
+                                         GENOME_CACHE_VERSION, source_hash,
+                                         uniform, codes.size()};
+    std::vector<genome_cache_entry_t> table(codes.size());
+    std::vector<std::shared_ptr<const std::vector<transcription_region_t>>>
+        regions;
+    std::vector<std::shared_ptr<const std::vector<constitutive_origin_t>>>
+        origins;
+
+    uint64_t offset = sizeof(genome_cache_header_t) +
+                      codes.size() * sizeof(genome_cache_entry_t);
+    for (uint i = 0; i < codes.size(); i++)
+    {
+        regions.push_back(provider.get_transcription_regions(i));
+        origins.push_back(provider.get_constitutive_origins(i));
+
+        genome_cache_entry_t &chromosome = table[i];
+        chromosome.code_offset           = offset;
+        chromosome.code_size             = codes[i].size();
+        chromosome.length = provider.get_landscape_view(i).size;
+        chromosome.landscape_offset =
+            aligned(chromosome.code_offset + chromosome.code_size);
+        chromosome.regions_offset = aligned(
+            chromosome.landscape_offset + chromosome.length * sizeof(double));
+        chromosome.n_regions      = regions[i]->size();
+        chromosome.origins_offset = aligned(
+            chromosome.regions_offset +
+            chromosome.n_regions * sizeof(transcription_region_t));
+        chromosome.n_origins = origins[i]->size();
+        offset               = aligned(chromosome.origins_offset +
+                         chromosome.n_origins * sizeof(constitutive_origin_t));
+    }
+
+    std::string temporary_path =
+        path + ".tmp" + std::to_string((long long)getpid());
+    std::ofstream file(temporary_path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file " + temporary_path);
+
+    uint64_t position = 0;
+    auto write_at = [&](uint64_t at, const void *data, size_t size) {
+        static const char zeros[8] = {0};
+        file.write(zeros, at - position);
+        file.write((const char *)data, size);
+        position = at + size;
+    };
+
+    write_at(0, &file_header, sizeof(file_header));
+    write_at(position, table.data(),
+             table.size() * sizeof(genome_cache_entry_t));
+    for (uint i = 0; i < codes.size(); i++)
+    {
+        const genome_cache_entry_t &chromosome = table[i];
+        landscape_view_t landscape = provider.get_landscape_view(i);
+
+        write_at(chromosome.code_offset, codes[i].data(), codes[i].size());
+        write_at(chromosome.landscape_offset, landscape.data,
+                 landscape.size * sizeof(double));
+        write_at(chromosome.regions_offset, regions[i]->data(),
+                 regions[i]->size() * sizeof(transcription_region_t));
+        write_at(chromosome.origins_offset, origins[i]->data(),
+                 origins[i]->size() * sizeof(constitutive_origin_t));
+    }
+    write_at(offset, nullptr, 0);
+    file.close();
+
+    if (!file.good())
+    {
+        std::filesystem::remove(temporary_path);
+        throw std::runtime_error("Could not write file " + temporary_path);
+    }
+    std::filesystem::rename(temporary_path, path);
+}
+
+unsigned long long
+GenomeCache::source_hash(std::string organism, std::string database_path,
+                         std::string mfa_seq_data_path,
+                         const std::vector<std::string> &codes)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    hash_bytes(hash, organism.data(), organism.size() + 1);
+    hash_file(hash, database_path);
+    for (auto code : codes)
+    {
+        hash_bytes(hash, code.data(), code.size() + 1);
+        hash_file(hash, mfa_seq_data_path + code + ".txt");
+    }
+    return hash;
+}
+
+unsigned long long GenomeCache::get_source_hash()
+{
+    return header()->source_hash;
+}
+
+double GenomeCache::get_uniform() { return header()->uniform; }
+
+const std::vector<std::string> &GenomeCache::get_codes() { return codes; }
+
+int GenomeCache::get_length(std::string code) { return entry(code)->length; }
+
+landscape_view_t GenomeCache::get_landscape(std::string code)
+{
+    const genome_cache_entry_t *chromosome = entry(code);
+    return landscape_view_t{
+        (const double *)(mapping + chromosome->landscape_offset),
+        (uint)chromosome->length};
+}
+
+std::vector<transcription_region_t>
+GenomeCache::get_transcription_regions(std::string code)
+{
+    const genome_cache_entry_t *chromosome = entry(code);
+    auto first =
+        (const transcription_region_t *)(mapping + chromosome->regions_offset);
+    return std::vector<transcription_region_t>(first,
+                                               first + chromosome->n_regions);
+}
+
+std::vector<constitutive_origin_t>
+GenomeCache::get_constitutive_origins(std::string code)
+{
+    const genome_cache_entry_t *chromosome = entry(code);
+    auto first =
+        (const constitutive_origin_t *)(mapping + chromosome->origins_offset);
+    return std::vector<constitutive_origin_t>(first,
+                                              first + chromosome->n_origins);
+}
@@ -9,9 +9,8 @@
 std::uniform_real_distribution<double> GenomicLocation::rand_distribution =
     std::uniform_real_distribution<double>(0, 1);
 
-GenomicLocation::GenomicLocation(uint base,
-                                 std::shared_ptr<Chromosome> chromosome,
-                                 std::mt19937 *rand_generator)
+GenomicLocation::GenomicLocation(uint base, Chromosome *chromosome,
+                                 RandomGenerator *rand_generator)
     : chromosome(chromosome), rand_generator(rand_generator)
 {
     if (base >= chromosome->size())
@@ -20,6 +19,13 @@ GenomicLocation::GenomicLocation(uint base,
     this->base = base;
 }
 
+GenomicLocation::GenomicLocation(uint base,
+                                 const std::shared_ptr<Chromosome> &chromosome,
+                                 RandomGenerator *rand_generator)
+    : GenomicLocation(base, chromosome.get(), rand_generator)
+{
+}
+
 bool GenomicLocation::is_replicated()
 {
     return this->chromosome->base_is_replicated(this->base);
@@ -33,71 +39,33 @@ bool GenomicLocation::will_activate(bool use_constitutive_origin,
         double chance = rand_distribution(*rand_generator);
         return chance < this->chromosome->activation_probability(this->base);
     }
-    std::vector<constitutive_origin_t> not_fired_origins;
-
-    for (auto origin : *chromosome->constitutive_origins)
-    {
-        bool fired = false;
-        for (auto fired_origin : *chromosome->fired_constitutive_origins)
-        {
-            if (fired_origin.base == origin.base) fired = true;
-        }
-        if (!fired) not_fired_origins.push_back(origin);
-    }
 
-    for (auto origin : not_fired_origins)
-        if (this->base >= (origin.base - origins_range / 2) &&
-            this->base <= (origin.base + origins_range / 2))
-            return true;
-
-    return false;
+    // An origin matches if base is within origins_range / 2 of it, with the
+    // bounds computed unsigned, which leaves out origins closer than that to
+    // the start of the Chromosome
+    long long half = origins_range / 2;
+    return chromosome->constitutive_origin_index.has_unfired(
+        std::max<long long>((long long)this->base - half, half),
+        (long long)this->base + half);
 }
 
 constitutive_origin_t
 GenomicLocation::get_constitutive_origin(int origins_range)
 {
-    constitutive_origin_t ret_origin;
-    std::vector<constitutive_origin_t> not_fired_origins;
+    // The first unfired origin of the list within range, or base -1
     origins_range /= 2;
-
-    for (auto origin : *chromosome->constitutive_origins)
-    {
-        bool fired = false;
-        for (auto fired_origin : *chromosome->fired_constitutive_origins)
-        {
-            if (fired_origin.base == origin.base) fired = true;
-        }
-        if (!fired) not_fired_origins.push_back(origin);
-    }
-    for (auto origin : not_fired_origins)
-    {
-        if ((int)this->base >= ((int)origin.base - origins_range) &&
-            (int)this->base <= ((int)origin.base + origins_range))
-        {
-            ret_origin = origin;
-            return ret_origin;
-        }
-    }
-    // If code reaches here, no nonfired origin was found
-    // throw std::range_error("There are no origins within range.");
-    ret_origin.base = -1;
-    return ret_origin;
+    return chromosome->constitutive_origin_index.first_unfired(
+        (long long)this->base - origins_range,
+        (long long)this->base + origins_range);
 }
 
 bool GenomicLocation::put_fired_constitutive_origin(
     constitutive_origin_t origin)
 {
-    for (auto curr_origin : *chromosome->constitutive_origins)
-    {
-        if (curr_origin == origin)
-        {
-            for (auto fired_origin : *chromosome->fired_constitutive_origins)
-                if (fired_origin == origin) return false;
-            chromosome->fired_constitutive_origins->push_back(origin);
-            return true;
-        }
-    }
-    return false;
+    // Fails if the origin does not exist or already fired
+    if (!chromosome->constitutive_origin_index.fire(origin.base)) return false;
+    chromosome->fired_constitutive_origins->push_back(origin);
+    return true;
 }
 
 GenomicLocation &GenomicLocation::operator+=(int bases)
@@ -1,20 +1,270 @@
 // #define GPU_ENABLED
 
+#include "buffer_pool.hpp"
 #include "configuration.hpp"
 #include "evolution.hpp"
 //#include "gpu_s_phase.hpp"
 #include "s_phase.hpp"
+#include "summary_statistic.hpp"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <c4/yml/std/string.hpp>
 #include <chrono>
 #include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <getopt.h>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <omp.h>
 #include <ryml.hpp>
 #include <sstream>
 
+/*! Gives the folder the cells of a parameter point are saved to.
+ * @param cl_configuration_data point The configuration of the point.
+ * @return The folder, ending with a slash.
+ */
+static std::string point_folder(const cl_configuration_data &point)
+{
+    return point.output + "/" + point.name + "_" +
+           (point.dormant ? "true" : "false") + "_" +
+           std::to_string(point.resources) + "_" +
+           std::to_string(point.period) + "/";
+}
+
+/*! Simulates the cells of one or more parameter points with a single team of
+ * threads and prints the average times of each point. The jobs are made of
+ * the cells of each point in turn and threads take the next one when they
+ * are done, so the points should come longest first.
+ * With the summary format the time, inter-origin distance and collisions
+ * of the cells are gathered by each thread instead, and written to a single
+ * <output>/<name>_summary.txt file with one line per point and quantity.
+ * With a profile bin size the cells of each point are also gathered into a
+ * ReplicationProfile, which is written to the folder of the point once its
+ * last cell is done.
+ * @param vector points The configuration of each point.
+ * @param std::shared_ptr<DataManager> data The data of the organism.
+ * @param cl_configuration_data arguments The configuration of the run.
+ */
+static void simulate_points(const std::vector<cl_configuration_data> &points,
+                            std::shared_ptr<DataManager> data,
+                            const cl_configuration_data &arguments)
+{
+    bool labelled = !arguments.mode.compare("sweep");
+    bool summary  = !arguments.format.compare("summary");
+
+    std::vector<std::pair<uint, unsigned long long>> jobs;
+    for (uint p = 0; p < points.size(); p++)
+        for (unsigned long long i = 0; i < points[p].cells; i++)
+            jobs.push_back(std::make_pair(p, i));
+
+    // Each thread keeps the times of its own cells, they are merged once all
+    // cells are simulated
+    std::vector<std::vector<std::pair<uint, s_phase_checkpoints_t>>>
+        thread_checkpoint_times(omp_get_max_threads());
+
+    // The same goes for the statistics of the summary format, one set per
+    // point and quantity
+    std::vector<std::vector<std::array<SummaryStatistic, 3>>>
+        thread_summaries(omp_get_max_threads());
+    if (summary)
+        for (auto &summaries : thread_summaries)
+            summaries.resize(points.size());
+
+    // And for the replication profiles, which only exist while the cells of
+    // their point run, as they are large
+    std::vector<std::vector<std::shared_ptr<ReplicationProfile>>>
+        thread_profiles(omp_get_max_threads(),
+                        std::vector<std::shared_ptr<ReplicationProfile>>(
+                            points.size()));
+    std::vector<std::atomic<unsigned long long>> cells_left(points.size());
+    for (uint p = 0; p < points.size(); p++)
+        cells_left[p] = points[p].cells;
+
+    unsigned long long threads = points[0].threads;
+
+    // Cells are written by their own threads while the next ones are
+    // simulated. A few cells per thread can wait to be written before the
+    // simulation threads have to wait.
+    auto output_queue = std::make_shared<OutputQueue>(
+        2 * threads, std::max(1ULL, threads / 4));
+
+    // Each thread builds one SPhase and resets it for its next cells of the
+    // same point, instead of building their Genomes again
+    std::vector<std::unique_ptr<SPhase>> s_phases(omp_get_max_threads());
+    std::vector<long long> s_phase_points(omp_get_max_threads(), -1);
+
+    // After an error the threads skip the cells left
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+
+    // Cell durations vary a lot with the seed, so threads take the next cell
+    // when they are done instead of a fixed share
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long long unsigned int j = 0; j < jobs.size(); j++)
+    {
+        if (failed) continue;
+
+        try
+        {
+            uint p                          = jobs[j].first;
+            unsigned long long i            = jobs[j].second;
+            const cl_configuration_data &pt = points[p];
+            unsigned long long seed         = pt.seed;
+
+            // Run all simulations with the same parameters, except for seed,
+            // otherwise it would be exactly the same simulation every time.
+            auto &s_phase = s_phases[omp_get_thread_num()];
+            bool reused =
+                s_phase && s_phase_points[omp_get_thread_num()] == p;
+            if (!reused)
+            {
+                s_phase = std::make_unique<SPhase>(
+                    pt.constitutive, pt.resources, pt.speed, pt.timeout,
+                    pt.period, pt.dormant, data, pt.organism, pt.name,
+                    pt.output, i ^ seed, pt.engine, pt.sampler, pt.format);
+                s_phase->set_output_queue(output_queue);
+                s_phase_points[omp_get_thread_num()] = p;
+
+                if (pt.profile_bin)
+                {
+                    auto &profile = thread_profiles[omp_get_thread_num()][p];
+                    if (!profile)
+                        profile = std::make_shared<ReplicationProfile>(
+                            pt.profile_bin);
+                    s_phase->set_profile(profile);
+                }
+            }
+
+            // A counter based generator is keyed by the cell itself
+            if (pt.rng == "philox")
+                s_phase->reset(RandomGenerator(seed, i, 0, RNG_STREAM_GENOME));
+            else if (reused)
+                s_phase->reset(i ^ seed);
+            s_phase->simulate(i);
+
+            thread_checkpoint_times[omp_get_thread_num()].push_back(
+                std::pair<uint, s_phase_checkpoints_t>(p, s_phase->getTimes()));
+
+            if (summary)
+            {
+                simulation_stats stats = s_phase->get_stats();
+                auto &statistics = thread_summaries[omp_get_thread_num()][p];
+                statistics[0].add(stats.time);
+                statistics[1].add(stats.interorigin_distance);
+                statistics[2].add(stats.collisions);
+            }
+
+            // The thread that does the last cell of a point writes its profile,
+            // the cells of the other threads were all added by then
+            if (pt.profile_bin && !--cells_left[p])
+            {
+                ReplicationProfile profile(pt.profile_bin);
+                for (auto &profiles : thread_profiles)
+                    if (profiles[p])
+                    {
+                        profile.merge(*profiles[p]);
+                        profiles[p].reset();
+                    }
+                profile.write(point_folder(pt));
+            }
+        }
+        catch (...)
+        {
+            // Exceptions cannot leave the parallel region, the first one is
+            // thrown again once all threads are done
+            #pragma omp critical
+            if (!error) error = std::current_exception();
+            failed = true;
+        }
+    }
+
+    s_phases.clear();
+    try
+    {
+        output_queue->close();
+    }
+    catch (...)
+    {
+        if (!error) error = std::current_exception();
+    }
+    if (error) std::rethrow_exception(error);
+
+    if (summary)
+    {
+        const char *quantities[] = {"time", "interorigin_distance",
+                                    "collisions"};
+
+        std::filesystem::create_directories(arguments.output);
+        std::ofstream summary_file(arguments.output + "/" + arguments.name +
+                                   "_summary.txt");
+        summary_file << "# dormant\tresources\tspeed\tperiod\tconstitutive"
+                        "\tquantity\tcells\tmean\tsd\tmin\tmax\thistogram\n";
+        for (uint p = 0; p < points.size(); p++)
+            for (uint q = 0; q < 3; q++)
+            {
+                SummaryStatistic statistic;
+                for (auto &summaries : thread_summaries)
+                    statistic.merge(summaries[p][q]);
+
+                summary_file << (points[p].dormant ? "true" : "false") << "\t"
+                             << points[p].resources << "\t" << points[p].speed
+                             << "\t" << points[p].period << "\t"
+                             << points[p].constitutive << "\t" << quantities[q]
+                             << "\t" << statistic.to_string() << "\n";
+            }
+    }
+
+    // Calculate time statistics
+    // Total milliseconds spent in the creation, simulation and saving phases
+    // of the cells of each point
+    std::vector<double> created_sum(points.size(), 0);
+    std::vector<double> sim_sum(points.size(), 0);
+    std::vector<double> saved_sum(points.size(), 0);
+
+    for (auto &times : thread_checkpoint_times)
+        for (auto checkpoint : times)
+        {
+            uint p                     = checkpoint.first;
+            s_phase_checkpoints_t time = checkpoint.second;
+
+            created_sum[p] +=
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    time.end_create - time.start_create)
+                    .count();
+            sim_sum[p] += std::chrono::duration_cast<std::chrono::milliseconds>(
+                              time.end_sim - time.start_sim)
+                              .count();
+            saved_sum[p] +=
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    time.end_save - time.start_save)
+                    .count();
+        }
+
+    for (uint p = 0; p < points.size(); p++)
+    {
+        // Calculate averages
+        double created_avg = created_sum[p] / points[p].cells;
+        double sim_avg     = sim_sum[p] / points[p].cells;
+        double saved_avg   = saved_sum[p] / points[p].cells;
+
+        if (labelled)
+            std::cout << "[STAT] Parameter point              : "
+                      << point_folder(points[p]) << std::endl;
+        std::cout << "[STAT] Average creation time   [ms] : " << created_avg
+                  << std::endl;
+        std::cout << "[STAT] Average simulation time [ms] : " << sim_avg
+                  << std::endl;
+        std::cout << "[STAT] Average saving time     [ms] : " << saved_avg
+                  << std::endl;
+        std::cout << "[STAT] Average s-phase time    [ms] : "
+                  << created_avg + sim_avg + saved_avg << std::endl;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     try
@@ -27,13 +277,15 @@ int main(int argc, char *argv[])
 
         omp_set_num_threads(arg_values.threads);
 
+        BufferPool::shared().set_huge_pages(arg_values.huge_pages);
+
         if (!arg_values.mode.compare("basic"))
         {
 
             std::shared_ptr<DataManager> data = std::make_shared<DataManager>(
                 arg_values.organism, arg_values.data_dir + "/database.sqlite",
                 arg_values.data_dir + "/MFA-Seq_" + arg_values.organism + "/",
-                arg_values.probability);
+                arg_values.probability, arg_values.cache_dir);
             bool gpu = false;
 
             if (gpu)
@@ -103,72 +355,24 @@ int main(int argc, char *argv[])
             }
             else
             {
-                std::vector<std::pair<int, s_phase_checkpoints_t>>
-                    checkpoint_times;
-
-                unsigned long long seed = arg_values.seed;
-
-                #pragma omp parallel for
-                for (long long unsigned int i = 0; i < arg_values.cells; i++)
-                {
-                    // Run all simulations with the same parameters, except for
-                    // seed, otherwise it would be exactly the same simulation
-                    // every time.
-                    SPhase *s_phase = new SPhase(
-                        arg_values.constitutive, arg_values.resources,
-                        arg_values.speed, arg_values.timeout, arg_values.period,
-                        arg_values.dormant, data, arg_values.organism,
-                        arg_values.name, arg_values.output, i ^ seed);
-                    s_phase->simulate(i);
-
-                    checkpoint_times.push_back(
-                        std::pair<int, s_phase_checkpoints_t>(
-                            i, s_phase->getTimes()));
-
-                    delete s_phase;
-                }
-
-                // Calculate time statistics
-
-                double created_sum =
-                    0; // Total microseconds spent in creation phase
-                double sim_sum =
-                    0; // Total microseconds spent in simulation phase
-                double saved_sum =
-                    0; // Total microseconds spent in saving phase
+                std::vector<cl_configuration_data> points = {arg_values};
+                simulate_points(points, data, arg_values);
+            }
+        }
+        else if (!arg_values.mode.compare("sweep"))
+        {
+            // All points share the organism, so its data is loaded once
+            std::shared_ptr<DataManager> data = std::make_shared<DataManager>(
+                arg_values.organism, arg_values.data_dir + "/database.sqlite",
+                arg_values.data_dir + "/MFA-Seq_" + arg_values.organism + "/",
+                arg_values.probability, arg_values.cache_dir);
 
-                for (auto checkpoint : checkpoint_times)
-                {
-                    s_phase_checkpoints_t times = checkpoint.second;
-
-                    created_sum +=
-                        std::chrono::duration_cast<std::chrono::milliseconds>(
-                            times.end_create - times.start_create)
-                            .count();
-                    sim_sum +=
-                        std::chrono::duration_cast<std::chrono::milliseconds>(
-                            times.end_sim - times.start_sim)
-                            .count();
-                    saved_sum +=
-                        std::chrono::duration_cast<std::chrono::milliseconds>(
-                            times.end_save - times.start_save)
-                            .count();
-                }
+            // With order "longest" the long points come first so that the
+            // short ones fill the threads in the end
+            std::vector<cl_configuration_data> points =
+                sweep_points(arg_values);
 
-                // Calculate averages
-                double created_avg = created_sum / arg_values.cells;
-                double sim_avg     = sim_sum / arg_values.cells;
-                double saved_avg   = saved_sum / arg_values.cells;
-
-                std::cout << "[STAT] Average creation time   [ms] : "
-                          << created_avg << std::endl;
-                std::cout << "[STAT] Average simulation time [ms] : " << sim_avg
-                          << std::endl;
-                std::cout << "[STAT] Average saving time     [ms] : "
-                          << saved_avg << std::endl;
-                std::cout << "[STAT] Average s-phase time    [ms] : "
-                          << created_avg + sim_avg + saved_avg << std::endl;
-            }
+            simulate_points(points, data, arg_values);
         }
         else if (!arg_values.mode.compare("evolution"))
         {
@@ -183,4 +387,10 @@ int main(int argc, char *argv[])
         // This is how we recieve the messages from the argument parsing
         std::cout << e.what() << std::endl;
     }
+    catch (std::exception &e)
+    {
+        // Such as an output that could not be written
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
 }
@@ -0,0 +1,130 @@
+#include "output_analysis.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// The streaks found walking the times from begin to end
+template <class Iterator>
+static uint streaks(Iterator begin, Iterator end, std::vector<uint> &distances)
+{
+    uint n_streaks = 0;
+    bool streak    = false;
+    long long start = -1;
+
+    // As in the script, the first base is never the one behind
+    long long n = end - begin;
+    for (long long i = 1; i + 2 < n; i++)
+    {
+        long long back   = begin[i];
+        long long middle = begin[i + 1];
+        long long front  = begin[i + 2];
+
+        if (back - middle == 1 && front - middle == 1)
+        {
+            streak = true;
+            start  = i + 1;
+        }
+        else if (middle - back == 1 && front - middle > 1 && streak)
+        {
+            streak = false;
+            n_streaks++;
+            distances.push_back(i + 1 - start);
+        }
+    }
+    return n_streaks;
+}
+
+uint find_streaks(const std::vector<int> &times, std::vector<uint> &distances)
+{
+    return streaks(times.begin(), times.end(), distances);
+}
+
+void collision_distances(const std::vector<int> &times,
+                         std::vector<uint> &distances)
+{
+    streaks(times.begin(), times.end(), distances);
+    streaks(times.rbegin(), times.rend(), distances);
+}
+
+distance_stats_t distance_statistics(std::vector<uint> &distances)
+{
+    distance_stats_t stats{0, 0, 0};
+    size_t n = distances.size();
+    if (n == 0) return stats;
+
+    std::sort(distances.begin(), distances.end());
+    stats.median = n % 2 ? distances[n / 2]
+                         : ((double)distances[n / 2 - 1] + distances[n / 2]) / 2;
+
+    // Exact sums, so that only the last divisions round
+    unsigned __int128 sum = 0, sum_squares = 0;
+    for (uint distance : distances)
+    {
+        sum += distance;
+        sum_squares += (unsigned __int128)distance * distance;
+    }
+    stats.mean = (double)sum / n;
+    if (n > 1)
+        stats.sd = std::sqrt((double)(sum_squares * n - sum * sum) /
+                             ((double)n * (n - 1)));
+    return stats;
+}
+
+std::string to_string(const distance_stats_t &stats)
+{
+    char text[128];
+    std::snprintf(text, sizeof(text), "%.1f\t%.1f\t%.1f", stats.median,
+                  stats.mean, stats.sd);
+    return text;
+}
+
+std::vector<cell_aggregate_t>
+aggregate_cells(const std::vector<cell_record_t> &cells)
+{
+    std::vector<cell_aggregate_t> aggregates;
+    for (auto &cell : cells)
+    {
+        auto aggregate = std::find_if(
+            aggregates.begin(), aggregates.end(),
+            [&](const cell_aggregate_t &a) {
+                return a.resources == cell.resources && a.speed == cell.speed;
+            });
+        if (aggregate == aggregates.end())
+            aggregate = aggregates.insert(
+                aggregates.end(),
+                cell_aggregate_t{cell.resources, cell.speed, 0, 0, 0, 0, 0});
+
+        aggregate->time_sum += cell.time;
+        aggregate->interorigin_distance_sum += cell.interorigin_distance;
+        aggregate->time_squares += cell.time * cell.time;
+        aggregate->interorigin_distance_squares +=
+            cell.interorigin_distance * cell.interorigin_distance;
+        aggregate->cells++;
+    }
+    return aggregates;
+}
+
+// Standard deviation computed with the same floating point operations as
+// the script, so that they round alike
+static double script_sd(double sum, double squares, unsigned long long n)
+{
+    if (n == 1) return 0;
+    return std::pow((squares / n - std::pow(sum / n, 2.0)) *
+                        ((double)n / (n - 1)),
+                    0.5);
+}
+
+std::string to_string(const cell_aggregate_t &aggregate)
+{
+    unsigned long long n = aggregate.cells;
+    char text[256];
+    std::snprintf(
+        text, sizeof(text), "%llu\t%llu\t%.2f\t%.2f\t%.2f\t%.2f\t%llu",
+        aggregate.resources, aggregate.speed, aggregate.time_sum / n,
+        script_sd(aggregate.time_sum, aggregate.time_squares, n),
+        aggregate.interorigin_distance_sum / n,
+        script_sd(aggregate.interorigin_distance_sum,
+                  aggregate.interorigin_distance_squares, n),
+        n);
+    return text;
+}
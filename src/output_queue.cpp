@@ -0,0 +1,87 @@
+#include "output_queue.hpp"
+#include <stdexcept>
+
+OutputQueue::OutputQueue(uint capacity, uint n_writers)
+    : capacity(capacity), closed(false)
+{
+    if (capacity == 0)
+        throw std::invalid_argument("The output queue needs some capacity.");
+    if (n_writers == 0)
+        throw std::invalid_argument("The output queue needs some writer.");
+
+    for (uint i = 0; i < n_writers; i++)
+        writers.emplace_back(&OutputQueue::run, this);
+}
+
+OutputQueue::~OutputQueue()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void OutputQueue::run()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_empty.wait(lock, [this] { return closed || !jobs.empty(); });
+            if (jobs.empty()) return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        not_full.notify_one();
+
+        try
+        {
+            job();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+    }
+}
+
+void OutputQueue::push(std::function<void()> job)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock,
+                      [this] { return closed || jobs.size() < capacity; });
+        if (closed)
+            throw std::runtime_error("The output queue is closed.");
+
+        jobs.push_back(std::move(job));
+    }
+    not_empty.notify_one();
+}
+
+void OutputQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    not_empty.notify_all();
+    not_full.notify_all();
+
+    for (auto &writer : writers)
+        if (writer.joinable()) writer.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error)
+    {
+        std::exception_ptr thrown = error;
+        error                     = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
@@ -0,0 +1,269 @@
+#include "output_reader.hpp"
+#include "fork_event_log.hpp"
+#include "timing_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fcntl.h>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+MappedFile::MappedFile(std::string path) : bytes(nullptr), length(0)
+{
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) throw std::runtime_error("Could not open file " + path);
+
+    struct stat status;
+    if (fstat(descriptor, &status) < 0)
+    {
+        close(descriptor);
+        throw std::runtime_error("Could not read the size of " + path);
+    }
+
+    length = status.st_size;
+    if (length > 0)
+    {
+        void *mapping =
+            mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(descriptor);
+            throw std::runtime_error("Could not map file " + path);
+        }
+        // The file is read once, from start to end
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        bytes = (const char *)mapping;
+    }
+    close(descriptor);
+}
+
+MappedFile::~MappedFile()
+{
+    if (bytes) munmap((void *)bytes, length);
+}
+
+const char *MappedFile::data() const { return bytes; }
+
+size_t MappedFile::size() const { return length; }
+
+// Reads an integer with an optional minus sign at p and moves p past it.
+// Returns false if there are no digits.
+static bool parse_int(const char *&p, const char *end, long long &value)
+{
+    bool negative = p < end && *p == '-';
+    const char *digits = negative ? p + 1 : p;
+    if (digits == end || *digits < '0' || *digits > '9') return false;
+
+    value = 0;
+    for (p = digits; p < end && *p >= '0' && *p <= '9'; p++)
+        value = value * 10 + (*p - '0');
+    if (negative) value = -value;
+    return true;
+}
+
+static bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Moves p past the blanks and the line break that end a line. Returns false
+// if there is anything else before the line break.
+static bool end_line(const char *&p, const char *end)
+{
+    while (p < end && is_blank(*p))
+        p++;
+    if (p == end) return true;
+    if (*p != '\n') return false;
+    p++;
+    return true;
+}
+
+// The line that starts at p, for error messages
+static std::string line_at(const char *p, const char *end)
+{
+    return std::string(p, std::find(p, end, '\n'));
+}
+
+std::vector<int> parse_base_times(const char *begin, const char *end)
+{
+    std::vector<int> times;
+    times.reserve((end - begin) / 4);
+
+    const char *p = begin;
+    while (p < end)
+    {
+        while (p < end && (is_blank(*p) || *p == '\n'))
+            p++;
+        if (p == end) break;
+
+        const char *line = p;
+        long long time;
+        if (!parse_int(p, end, time) || !end_line(p, end))
+            throw std::runtime_error("Invalid replication time: " +
+                                     line_at(line, end));
+        times.push_back((int)time);
+    }
+    return times;
+}
+
+std::vector<int> parse_cseq(const char *begin, const char *end)
+{
+    std::vector<int> times;
+
+    const char *p = begin;
+    while (p < end)
+    {
+        while (p < end && (is_blank(*p) || *p == '\n'))
+            p++;
+        if (p == end) break;
+
+        // start[-end][xlength]
+        const char *line = p;
+        long long first, last, length = 1;
+        bool valid = parse_int(p, end, first);
+        last       = first;
+        if (valid && p < end && *p == '-')
+        {
+            p++;
+            valid = parse_int(p, end, last);
+        }
+        if (valid && p < end && *p == 'x')
+        {
+            p++;
+            valid = parse_int(p, end, length) && length > 0;
+        }
+        if (!valid || !end_line(p, end))
+            throw std::runtime_error("Invalid record: " + line_at(line, end));
+
+        int step = last < first ? -1 : 1;
+        for (long long time = first;; time += step)
+        {
+            times.insert(times.end(), length, (int)time);
+            if (time == last) break;
+        }
+    }
+    return times;
+}
+
+static bool ends_with(const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() &&
+           !text.compare(text.size() - suffix.size(), suffix.size(), suffix);
+}
+
+std::vector<int> read_replication_times(std::string path)
+{
+    if (ends_with(path, ".cseq.zst")) return TimingFileReader(path).times();
+
+    if (ends_with(path, ".events"))
+    {
+        ForkEventReader reader(path);
+        if (reader.get_length() == 0) return std::vector<int>();
+        return reader.times(0, reader.get_length() - 1);
+    }
+
+    bool cseq = ends_with(path, ".cseq");
+    if (!cseq && !ends_with(path, ".txt"))
+        throw std::invalid_argument("Unknown replication times file " + path);
+
+    MappedFile file(path);
+    const char *begin = file.data();
+    const char *end   = begin + file.size();
+    try
+    {
+        return cseq ? parse_cseq(begin, end) : parse_base_times(begin, end);
+    }
+    catch (const std::runtime_error &error)
+    {
+        throw std::runtime_error(path + ": " + error.what());
+    }
+}
+
+std::vector<cell_record_t> read_cell_file(std::string path)
+{
+    MappedFile file(path);
+    const char *p   = file.data();
+    const char *end = p + file.size();
+
+    std::vector<cell_record_t> cells;
+    while (p < end && *p != '\n')
+    {
+        // Forks, speed, time and inter-origin distance, separated by tabs
+        std::string line = line_at(p, end);
+        std::istringstream fields(line);
+        cell_record_t cell;
+        if (!(fields >> cell.resources >> cell.speed >> cell.time >>
+              cell.interorigin_distance))
+            throw std::runtime_error("Invalid cell in " + path + ": " + line);
+        cells.push_back(cell);
+
+        p += std::min<size_t>(line.size() + 1, end - p);
+    }
+    return cells;
+}
+
+std::vector<std::string> simulation_folders(std::string run_folder)
+{
+    std::vector<std::string> folders;
+    for (auto &entry : std::filesystem::directory_iterator(run_folder))
+        if (entry.is_directory()) folders.push_back(entry.path().string());
+    std::sort(folders.begin(), folders.end());
+    return folders;
+}
+
+std::vector<std::string> timing_files(std::string simulation_folder)
+{
+    std::vector<std::string> files;
+    for (auto &entry : std::filesystem::directory_iterator(simulation_folder))
+    {
+        std::string path = entry.path().string();
+        if (!entry.is_regular_file() ||
+            entry.path().filename() == "cell.txt")
+            continue;
+        if (ends_with(path, ".cseq") || ends_with(path, ".cseq.zst") ||
+            ends_with(path, ".events") || ends_with(path, ".txt"))
+            files.push_back(path);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void parallel_for(size_t n_jobs, uint n_threads,
+                  std::function<void(size_t)> job)
+{
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto run = [&]() {
+        for (size_t i = next++; i < n_jobs; i = next++)
+        {
+            try
+            {
+                job(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next = n_jobs;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    n_threads = std::max<uint>(1, std::min<size_t>(n_threads, n_jobs));
+    for (uint t = 1; t < n_threads; t++)
+        threads.emplace_back(run);
+    run();
+    for (auto &thread : threads)
+        thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,52 @@
+#include "probability_landscape.hpp"
+#include <algorithm>
+
+static const uint page_size = 1 << LANDSCAPE_PAGE_BITS;
+
+ProbabilityLandscape::ProbabilityLandscape(
+    const std::vector<double> &shared_landscape)
+    : ProbabilityLandscape(landscape_view_t{shared_landscape.data(),
+                                            (uint)shared_landscape.size()})
+{
+}
+
+ProbabilityLandscape::ProbabilityLandscape(landscape_view_t shared_landscape)
+    : shared_landscape(shared_landscape),
+      pages((shared_landscape.size + page_size - 1) / page_size)
+{
+}
+
+uint ProbabilityLandscape::size() { return shared_landscape.size; }
+
+double ProbabilityLandscape::operator[](uint base)
+{
+    const pool_vector<double> &page = pages[base >> LANDSCAPE_PAGE_BITS];
+    if (page.empty()) return shared_landscape.data[base];
+    return page[base & (page_size - 1)];
+}
+
+void ProbabilityLandscape::set(uint base, double probability)
+{
+    pool_vector<double> &page = pages[base >> LANDSCAPE_PAGE_BITS];
+    if (page.empty())
+    {
+        uint first = base & ~(page_size - 1);
+        uint last  = std::min<uint>(first + page_size, size());
+        page.assign(shared_landscape.data + first,
+                    shared_landscape.data + last);
+    }
+    page[base & (page_size - 1)] = probability;
+}
+
+void ProbabilityLandscape::reset()
+{
+    for (auto &page : pages)
+        page.clear();
+}
+
+uint ProbabilityLandscape::n_copied_pages()
+{
+    return std::count_if(
+        pages.begin(), pages.end(),
+        [](const pool_vector<double> &page) { return !page.empty(); });
+}
@@ -0,0 +1,62 @@
+#include "quantile_sketch.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+QuantileSketch::QuantileSketch() : n(0) {}
+
+void QuantileSketch::add(uint bucket, unsigned long long count)
+{
+    auto found = std::lower_bound(
+        buckets.begin(), buckets.end(), bucket,
+        [](const std::pair<uint, unsigned long long> &entry, uint bucket) {
+            return entry.first < bucket;
+        });
+    if (found != buckets.end() && found->first == bucket)
+        found->second += count;
+    else
+        buckets.insert(found, std::make_pair(bucket, count));
+    n += count;
+}
+
+void QuantileSketch::add(unsigned long long value) { add(bucket(value), 1); }
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    for (auto &entry : other.buckets)
+        add(entry.first, entry.second);
+}
+
+unsigned long long QuantileSketch::count() const { return n; }
+
+double QuantileSketch::quantile(double q) const
+{
+    if (q < 0 || q > 1)
+        throw std::invalid_argument("A quantile must be between 0 and 1.");
+    if (!n) return 0;
+
+    unsigned long long rank = (unsigned long long)(q * (n - 1));
+    unsigned long long seen = 0;
+    for (auto &entry : buckets)
+    {
+        seen += entry.second;
+        if (seen <= rank) continue;
+
+        // Middle of the integers from lower to upper - 1
+        double lower = bucket_lower_bound(entry.first);
+        double upper = entry.first < bucket(UINT64_MAX)
+                           ? bucket_lower_bound(entry.first + 1)
+                           : 0x1.0p64;
+        return (lower + upper - 1) / 2;
+    }
+    return bucket_lower_bound(buckets.back().first);
+}
+
+uint QuantileSketch::bucket(unsigned long long value)
+{
+    return log_linear_bin(value, SKETCH_SUB_BITS);
+}
+
+unsigned long long QuantileSketch::bucket_lower_bound(uint bucket)
+{
+    return log_linear_bin_lower_bound(bucket, SKETCH_SUB_BITS);
+}
@@ -0,0 +1,130 @@
+#include "random_generator.hpp"
+#include <stdexcept>
+
+// Philox4x32 multipliers and Weyl sequence constants
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+RandomGenerator::RandomGenerator(unsigned long long seed)
+    : twister(std::make_unique<std::mt19937>(seed)), key{0, 0},
+      counter{0, 0, 0, 0},
+      block{0, 0, 0, 0}, block_index(0), position(0)
+{
+}
+
+RandomGenerator::RandomGenerator(unsigned long long seed,
+                                 unsigned long long cell,
+                                 unsigned long long generation, uint stream)
+    : block{0, 0, 0, 0}, position(0)
+{
+    if (cell > UINT32_MAX)
+        throw std::invalid_argument("The cell of a counter based generator "
+                                    "must fit in 32 bits.");
+    if (generation > RNG_MAX_GENERATION || stream > RNG_MAX_STREAM)
+        throw std::invalid_argument(
+            "Generation or stream too large for a counter based generator.");
+
+    // The seed is the key, the two high words of the counter place the cell
+    // and the two low ones count the blocks drawn
+    key[0]     = (uint32_t)seed;
+    key[1]     = (uint32_t)(seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t)cell;
+    counter[3] = (uint32_t)(generation << 8 | stream);
+
+    // No block drawn yet
+    block_index = ~0ULL;
+}
+
+RandomGenerator::RandomGenerator(const RandomGenerator &other)
+    : twister(other.twister ? std::make_unique<std::mt19937>(*other.twister)
+                            : nullptr),
+      key{other.key[0], other.key[1]},
+      counter{other.counter[0], other.counter[1], other.counter[2],
+              other.counter[3]},
+      block{other.block[0], other.block[1], other.block[2], other.block[3]},
+      block_index(other.block_index), position(other.position)
+{
+}
+
+RandomGenerator &RandomGenerator::operator=(const RandomGenerator &other)
+{
+    if (this != &other) *this = RandomGenerator(other);
+    return *this;
+}
+
+bool RandomGenerator::is_counter_based() const { return !twister; }
+
+void RandomGenerator::discard(unsigned long long n)
+{
+    if (twister)
+        twister->discard(n);
+    else
+        position += n;
+}
+
+void RandomGenerator::fill(uint64_t *words, size_t n)
+{
+    size_t i = 0;
+    if (!twister && position % 4 == 0)
+    {
+        uint32_t block_counter[4] = {0, 0, counter[2], counter[3]};
+        uint32_t result[4];
+        for (; i + 2 <= n; i += 2)
+        {
+            unsigned long long index = position / 4;
+            block_counter[0]         = (uint32_t)index;
+            block_counter[1]         = (uint32_t)(index >> 32);
+            philox(block_counter, key, result);
+
+            words[i]     = (uint64_t)result[0] << 32 | result[1];
+            words[i + 1] = (uint64_t)result[2] << 32 | result[3];
+            position += 4;
+        }
+    }
+
+    for (; i < n; i++)
+    {
+        uint64_t high = (*this)();
+        words[i]      = high << 32 | (*this)();
+    }
+}
+
+void RandomGenerator::generate_block()
+{
+    block_index = position / 4;
+    counter[0]  = (uint32_t)block_index;
+    counter[1]  = (uint32_t)(block_index >> 32);
+    philox(counter, key, block);
+}
+
+void RandomGenerator::philox(const uint32_t counter[4], const uint32_t key[2],
+                             uint32_t result[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2],
+             c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        uint64_t product0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t product1 = (uint64_t)PHILOX_M1 * c2;
+
+        c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)product1;
+        c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)product0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
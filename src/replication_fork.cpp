@@ -1,72 +1,71 @@
 #include "replication_fork.hpp"
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
-ReplicationFork::ReplicationFork(std::shared_ptr<Genome> genome,
-                                 ForkManager *fork_manager, uint speed)
-    : genome(genome), chromosome(nullptr), fork_manager(fork_manager)
+ReplicationFork::ReplicationFork(ForkManager *fork_manager, uint index)
+    : fork_manager(fork_manager), index(index)
 {
-    this->speed         = speed;
-    this->base          = -1;
-    this->direction     = 0;
-    this->just_detached = false;
+    if (index >= fork_manager->n_forks)
+        throw std::out_of_range("There is no fork with the given index.");
 }
 
-void ReplicationFork::attach(GenomicLocation &gen_loc, int direction, uint time)
+void ReplicationFork::attach(const GenomicLocation &gen_loc, int direction,
+                             uint time)
 {
-    if (this->is_attached())
-        throw std::runtime_error("This fork is already attached.");
-    if (this->get_just_detached())
-        throw std::runtime_error(
-            "This fork has just detached and cannot be used right now.");
-
-    this->base       = gen_loc.base;
-    this->chromosome = gen_loc.chromosome;
-    this->direction  = direction;
-    this->chromosome->replicate(this->base, this->base, time);
+    fork_manager->attach_fork(index, gen_loc, direction, time);
 }
 
 void ReplicationFork::detach(bool problem)
 {
-    this->base       = -1;
-    this->direction  = 0;
-    this->chromosome = nullptr;
-    if (problem) this->just_detached = true;
-    // increment metrics of detachment
-    // TODO: compare with the actual number of collisions
-    if (problem)
-        fork_manager->metric_times_detached_normal++;
-    else
-        fork_manager->metric_times_detached_collision++;
+    fork_manager->detach_fork(index, problem);
 }
 
 bool ReplicationFork::advance(uint time)
 {
-    int end_base = base + speed * direction;
-    if (!chromosome->replicate(base, end_base, time))
-    {
-        detach(true);
-        return false;
-    }
+    return fork_manager->advance_fork(index, time);
+}
 
-    base = end_base;
-    return true;
+uint ReplicationFork::idle_steps(uint time, uint period, uint limit)
+{
+    return fork_manager->fork_idle_steps(index, time, period, limit);
 }
 
-bool ReplicationFork::is_attached() { return !(base == -1 || direction == 0); }
+bool ReplicationFork::is_attached()
+{
+    return fork_manager->fork_direction[index] != 0;
+}
 
-int ReplicationFork::get_direction() { return direction; }
+int ReplicationFork::get_direction()
+{
+    return fork_manager->fork_direction[index];
+}
 
-int ReplicationFork::get_base() { return base; }
+int ReplicationFork::get_base() { return fork_manager->fork_base[index]; }
 
 std::shared_ptr<Chromosome> ReplicationFork::get_chromosome()
 {
-    return chromosome;
+    if (!is_attached()) return nullptr;
+    return fork_manager->genome
+        ->chromosomes[fork_manager->fork_chromosome[index]];
 }
 
-bool ReplicationFork::get_just_detached() { return just_detached; }
+bool ReplicationFork::get_just_detached()
+{
+    return fork_manager->fork_flags[index] & FORK_JUST_DETACHED;
+}
 
 void ReplicationFork::set_just_detached(bool new_value)
 {
-    just_detached = new_value;
+    // A fork waiting to be freed is not available to attach_forks
+    pool_vector<uint> &free_forks = fork_manager->free_forks;
+    if (new_value)
+    {
+        fork_manager->fork_flags[index] |= FORK_JUST_DETACHED;
+        free_forks.erase(
+            std::remove(free_forks.begin(), free_forks.end(), index),
+            free_forks.end());
+    }
+    else
+        fork_manager->fork_flags[index] &= ~FORK_JUST_DETACHED;
 }
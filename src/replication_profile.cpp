@@ -0,0 +1,151 @@
+#include "replication_profile.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+ReplicationProfile::ReplicationProfile(uint bin_size) : bin_size(bin_size)
+{
+    if (!bin_size)
+        throw std::invalid_argument("The bins of a ReplicationProfile must "
+                                    "have at least one base.");
+}
+
+void ReplicationProfile::add(Genome &genome)
+{
+    if (codes.empty())
+        for (auto &chromosome : genome.chromosomes)
+        {
+            codes.push_back(chromosome->get_code());
+            lengths.push_back(chromosome->size());
+            bins.emplace_back((chromosome->size() + bin_size - 1) / bin_size);
+        }
+
+    if (codes.size() != genome.chromosomes.size())
+        throw std::invalid_argument("The Genome does not have the Chromosomes "
+                                    "of the ReplicationProfile.");
+
+    std::vector<unsigned long long> sums;
+    std::vector<uint> counts;
+    for (uint c = 0; c < codes.size(); c++)
+    {
+        if (genome.chromosomes[c]->size() != lengths[c])
+            throw std::invalid_argument("The Genome does not have the "
+                                        "Chromosomes of the "
+                                        "ReplicationProfile.");
+
+        bin_times(genome.chromosomes[c]->get_strand(), bin_size, sums, counts);
+
+        for (uint b = 0; b < sums.size(); b++)
+        {
+            if (!counts[b]) continue;
+
+            unsigned long long time = (sums[b] + counts[b] / 2) / counts[b];
+            profile_bin_t &bin      = bins[c][b];
+            bin.times.add(time);
+            bin.sketch.add(time);
+        }
+    }
+}
+
+void ReplicationProfile::merge(const ReplicationProfile &other)
+{
+    if (other.codes.empty()) return;
+    if (codes.empty())
+    {
+        codes   = other.codes;
+        lengths = other.lengths;
+        bins    = other.bins;
+        return;
+    }
+
+    if (bin_size != other.bin_size || codes != other.codes ||
+        lengths != other.lengths)
+        throw std::invalid_argument("Only ReplicationProfiles with the same "
+                                    "bins can be merged.");
+    for (uint c = 0; c < codes.size(); c++)
+        for (uint b = 0; b < bins[c].size(); b++)
+        {
+            const profile_bin_t &from = other.bins[c][b];
+            profile_bin_t &to         = bins[c][b];
+            to.times.merge(from.times);
+            to.sketch.merge(from.sketch);
+        }
+}
+
+const std::vector<std::string> &ReplicationProfile::get_codes() const
+{
+    return codes;
+}
+
+const std::vector<profile_bin_t> &
+ReplicationProfile::get_bins(uint chromosome) const
+{
+    return bins.at(chromosome);
+}
+
+// Sum of ceil(d / speed) for d from 1 to n
+static unsigned long long ceil_sum(unsigned long long n, uint speed)
+{
+    unsigned long long q = n / speed, r = n % speed;
+    return speed * q * (q + 1) / 2 + r * (q + 1);
+}
+
+void ReplicationProfile::bin_times(const Strand &strand, uint bin_size,
+                                   std::vector<unsigned long long> &sums,
+                                   std::vector<uint> &counts)
+{
+    uint n_bins = (strand.size() + bin_size - 1) / bin_size;
+    sums.assign(n_bins, 0);
+    counts.assign(n_bins, 0);
+
+    for (const strand_segment_t &segment : strand.get_segments())
+    {
+        // Split the segment at the bin boundaries
+        for (long long first = segment.first; first <= segment.last;)
+        {
+            uint b         = (uint)(first / bin_size);
+            long long last = std::min((long long)segment.last,
+                                      (long long)(b + 1) * bin_size - 1);
+            unsigned long long n = last - first + 1;
+
+            // Distances from the anchor of the first and last base
+            long long near = (first - segment.anchor) * segment.direction;
+            long long far  = (last - segment.anchor) * segment.direction;
+            if (near > far) std::swap(near, far);
+
+            unsigned long long sum = n * segment.anchor_time;
+            if (segment.speed)
+                sum += ceil_sum(far, segment.speed) -
+                       ceil_sum(near - 1, segment.speed);
+
+            sums[b] += sum;
+            counts[b] += n;
+            first = last + 1;
+        }
+    }
+}
+
+void ReplicationProfile::write(std::string folder) const
+{
+    std::filesystem::create_directories(folder);
+
+    for (uint c = 0; c < codes.size(); c++)
+    {
+        std::ofstream file(folder + "/" + codes[c] + ".profile");
+        file << "# start\tend\tcells\tmean\tsd\tmedian\n" << std::fixed
+             << std::setprecision(2);
+
+        for (uint b = 0; b < bins[c].size(); b++)
+        {
+            const profile_bin_t &bin = bins[c][b];
+            unsigned long long first = (unsigned long long)b * bin_size;
+            unsigned long long last =
+                std::min(first + bin_size, (unsigned long long)lengths[c]) - 1;
+            file << first << "\t" << last << "\t" << bin.times.count()
+                 << "\t" << bin.times.mean() << "\t" << bin.times.sd()
+                 << "\t" << bin.sketch.quantile(0.5) << "\n";
+        }
+    }
+}
@@ -1,34 +1,46 @@
 #include "s_phase.hpp"
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 SPhase::SPhase(int origins_range, int n_resources, int replication_speed,
                int timeout, int transcription_period, bool has_dormant,
                std::shared_ptr<DataProvider> data, std::string organism,
                std::string name, std::string output_folder,
-               unsigned long long seed)
+               unsigned long long seed, std::string engine,
+               std::string sampler, std::string output_format)
     : origins_range(origins_range), n_resources(n_resources),
       replication_speed(replication_speed), timeout(timeout),
       transcription_period(transcription_period), has_dormant(has_dormant),
-      data(data), organism(organism), name(name), output_folder(output_folder)
+      data(data), organism(organism), name(name), output_folder(output_folder),
+      engine(engine), sampler(sampler), output_format(output_format)
 {
     checkpoint_times.start_create = std::chrono::steady_clock::now();
 
     std::vector<std::shared_ptr<Chromosome>> chromosomes;
 
-    auto codes = data->get_codes();
-    for (auto code = codes.begin(); code != codes.end(); code++)
-    {
-        chromosomes.push_back(std::make_shared<Chromosome>(*code, data));
-    }
+    uint n_chromosomes = data->get_codes().size();
+    for (uint id = 0; id < n_chromosomes; id++)
+        chromosomes.push_back(std::make_shared<Chromosome>(id, data));
 
     genome = std::make_shared<Genome>(chromosomes, seed);
+    if (!sampler.compare("tree") && origins_range <= 0)
+        genome->enable_activation_sampling();
+    if (!sampler.compare("gap") && origins_range <= 0)
+        genome->enable_gap_sampling();
 
     fork_manager =
         std::make_shared<ForkManager>(n_resources, genome, replication_speed);
+    if (!output_format.compare("events"))
+    {
+        event_log = std::make_shared<ForkEventLog>();
+        fork_manager->set_event_log(event_log);
+    }
 
     checkpoint_times.end_create = std::chrono::steady_clock::now();
 }
@@ -48,27 +60,50 @@ SPhase::SPhase(Configuration &configuration, std::shared_ptr<DataProvider> data,
     organism             = args.organism;
     name                 = args.name;
     output_folder        = args.output;
+    engine               = args.engine;
+    sampler              = args.sampler;
+    output_format        = args.format;
 
     checkpoint_times.start_create = std::chrono::steady_clock::now();
 
     std::vector<std::shared_ptr<Chromosome>> chromosomes;
 
-    auto codes = data->get_codes();
-    for (auto code = codes.begin(); code != codes.end(); code++)
-    {
-        chromosomes.push_back(std::make_shared<Chromosome>(*code, data));
-    }
+    uint n_chromosomes = data->get_codes().size();
+    for (uint id = 0; id < n_chromosomes; id++)
+        chromosomes.push_back(std::make_shared<Chromosome>(id, data));
 
     genome = std::make_shared<Genome>(chromosomes, seed);
+    if (!sampler.compare("tree") && origins_range <= 0)
+        genome->enable_activation_sampling();
+    if (!sampler.compare("gap") && origins_range <= 0)
+        genome->enable_gap_sampling();
 
     fork_manager =
         std::make_shared<ForkManager>(n_resources, genome, replication_speed);
+    if (!output_format.compare("events"))
+    {
+        event_log = std::make_shared<ForkEventLog>();
+        fork_manager->set_event_log(event_log);
+    }
 
     checkpoint_times.end_create = std::chrono::steady_clock::now();
 }
 
 SPhase::~SPhase() {}
 
+void SPhase::reset(unsigned long long seed) { reset(RandomGenerator(seed)); }
+
+void SPhase::reset(const RandomGenerator &rand_generator)
+{
+    checkpoint_times.start_create = std::chrono::steady_clock::now();
+
+    genome->reset(rand_generator);
+    fork_manager->reset();
+    stats = simulation_stats();
+
+    checkpoint_times.end_create = std::chrono::steady_clock::now();
+}
+
 simulation_stats SPhase::get_stats() { return stats; }
 
 void SPhase::simulate(int sim_number)
@@ -76,7 +111,6 @@ void SPhase::simulate(int sim_number)
 
     checkpoint_times.start_sim = std::chrono::steady_clock::now();
 
-    int alpha                     = 1;
     int time                      = 0;
     int constitutive_origins      = (int)genome->n_constitutive_origins();
     int n_collisions              = 0;
@@ -84,6 +118,45 @@ void SPhase::simulate(int sim_number)
 
     std::cout << "[INFO] Starting simulation " << sim_number << std::endl
               << std::flush;
+
+    if (!engine.compare("event"))
+        simulate_events(time, n_collisions, constitutive_origins);
+    else
+        simulate_steps(time, n_collisions, constitutive_origins);
+
+    int iod                    = genome->average_interorigin_distance();
+    stats.time                 = time;
+    stats.collisions           = n_collisions;
+    stats.interorigin_distance = iod;
+
+    std::cout << "[INFO] " << sim_number << " Ended simulation" << std::endl;
+
+    if (genome->is_replicated())
+        std::cout << "\t[INFO] " << sim_number
+                  << " Genome fully replicated at time " << time << "."
+                  << std::endl;
+    else if (time == timeout)
+        std::cout << "\t[WARN] " << sim_number
+                  << " Timeout simulation: " << std::endl;
+
+    std::cout << "\t[INFO] " << sim_number
+              << " Number of Collisions: " << n_collisions << std::endl;
+    if (use_constitutive_origins)
+        std::cout << "\t[INFO] " << sim_number
+                  << " Number of constitutive origins that did not fire: "
+                  << constitutive_origins << std::endl;
+
+    checkpoint_times.end_sim = std::chrono::steady_clock::now();
+
+    output(sim_number, time, iod, genome);
+}
+
+void SPhase::simulate_steps(int &time, int &n_collisions,
+                            int &constitutive_origins)
+{
+    int alpha                     = 1;
+    bool use_constitutive_origins = origins_range > 0;
+
     while (!genome->is_replicated() && time < timeout &&
            !(use_constitutive_origins && constitutive_origins == 0 &&
              (int)fork_manager->n_free_forks == n_resources))
@@ -103,53 +176,174 @@ void SPhase::simulate(int sim_number)
         if (time % alpha == 0 && !genome->is_replicated())
         {
             int n_forks = (int)fork_manager->n_free_forks;
+            if (!sampler.compare("batch") && !use_constitutive_origins)
+            {
+                fire_batch(n_forks, time, constitutive_origins);
+                continue;
+            }
+            if (sampler.compare("rejection") && !use_constitutive_origins)
+            {
+                fire_attempts(n_forks, time, constitutive_origins);
+                continue;
+            }
             for (int i = 0; i < n_forks; i++)
             {
-                GenomicLocation loc = *genome->random_genomic_location();
+                GenomicLocation loc = genome->random_genomic_location();
 
                 if (!loc.is_replicated() && fork_manager->n_free_forks >= 2 &&
                     loc.will_activate(use_constitutive_origins, origins_range))
-                {
-                    fork_manager->attach_forks(loc, time);
-                    if (use_constitutive_origins)
-                    {
-                        constitutive_origin_t origin =
-                            loc.get_constitutive_origin(origins_range);
-                        if (!loc.put_fired_constitutive_origin(origin))
-                            constitutive_origins += 0;
-                        // std::cout << "[WARN] Failed to add origin. "
-                        //  "Simulation "
-                        //   << sim_number << std::endl;
-                        constitutive_origins--;
-                    }
-                }
+                    fire_origin(loc, time, constitutive_origins);
             }
         }
     }
+}
 
-    stats.time       = time;
-    stats.collisions = n_collisions;
+void SPhase::simulate_events(int &time, int &n_collisions,
+                             int &constitutive_origins)
+{
+    bool use_constitutive_origins = origins_range > 0;
+    double genome_size            = genome->size();
 
-    std::cout << "[INFO] " << sim_number << " Ended simulation" << std::endl;
+    while (!genome->is_replicated() && time < timeout &&
+           !(use_constitutive_origins && constitutive_origins == 0 &&
+             (int)fork_manager->n_free_forks == n_resources))
+    {
+        uint idle = fork_manager->idle_steps(time, transcription_period,
+                                             timeout - time);
 
-    if (genome->is_replicated())
-        std::cout << "\t[INFO] " << sim_number
-                  << " Genome fully replicated at time " << time << "."
-                  << std::endl;
-    else if (time == timeout)
-        std::cout << "\t[WARN] " << sim_number
-                  << " Timeout simulation: " << std::endl;
+        // Some fork event happens in the next step, simulate it exactly
+        if (idle == 0)
+        {
+            time++;
+            fork_manager->advance_attached_forks(time);
+            if (transcription_period > 0)
+                n_collisions +=
+                    fork_manager->check_replication_transcription_conflicts(
+                        time, transcription_period, has_dormant);
+            if (!genome->is_replicated())
+                fire_attempts((int)fork_manager->n_free_forks, time,
+                              constitutive_origins);
+            continue;
+        }
 
-    std::cout << "\t[INFO] " << sim_number
-              << " Number of Collisions: " << n_collisions << std::endl;
-    if (use_constitutive_origins)
-        std::cout << "\t[INFO] " << sim_number
-                  << " Number of constitutive origins that did not fire: "
-                  << constitutive_origins << std::endl;
+        // Every idle step makes one attempt per free fork. Draw the first
+        // attempt that passes the current activation bound; as bases only
+        // get replicated while idle, the bound holds for the whole window.
+        int n_forks                 = (int)fork_manager->n_free_forks;
+        unsigned long long failures = 0;
+        bool fires                  = false;
+        if (n_forks >= 2)
+        {
+            double bound = genome->activation_bound(use_constitutive_origins,
+                                                    origins_range);
+            if (bound > 0)
+            {
+                failures = genome->random_failed_attempts(bound / genome_size);
+                fires    = failures / n_forks < idle;
+            }
+        }
 
-    checkpoint_times.end_sim = std::chrono::steady_clock::now();
+        uint skipped = fires ? (uint)(failures / n_forks) : idle;
+        if (!fires)
+        {
+            fork_manager->advance_attached_forks(time + 1, skipped);
+            time += skipped;
+            continue;
+        }
+
+        // The candidate is drawn from the same bases the bound was computed
+        // from, before the forks advance, and succeeds only if its base is
+        // still unreplicated when the attempt is made
+        GenomicLocation candidate = genome->random_activation_candidate(
+            use_constitutive_origins, origins_range);
+        if (skipped > 0)
+        {
+            fork_manager->advance_attached_forks(time + 1, skipped);
+            time += skipped;
+        }
+        time++;
+        fork_manager->advance_attached_forks(time);
+        if (transcription_period > 0)
+            n_collisions +=
+                fork_manager->check_replication_transcription_conflicts(
+                    time, transcription_period, has_dormant);
+        if (genome->is_replicated()) continue;
+
+        if (!candidate.is_replicated())
+            fire_origin(candidate, time, constitutive_origins);
+        fire_attempts(n_forks - (int)(failures % n_forks) - 1, time,
+                      constitutive_origins);
+    }
+}
+
+void SPhase::fire_attempts(int n_attempts, int time,
+                           int &constitutive_origins)
+{
+    bool use_constitutive_origins = origins_range > 0;
+    double genome_size            = genome->size();
+
+    while (n_attempts > 0 && fork_manager->n_free_forks >= 2)
+    {
+        double bound =
+            genome->activation_bound(use_constitutive_origins, origins_range);
+        if (bound <= 0) return;
+
+        unsigned long long failures =
+            genome->random_failed_attempts(bound / genome_size);
+        if (failures >= (unsigned long long)n_attempts) return;
+        n_attempts -= failures + 1;
+
+        GenomicLocation candidate = genome->random_activation_candidate(
+            use_constitutive_origins, origins_range);
+        if (!candidate.is_replicated())
+            fire_origin(candidate, time, constitutive_origins);
+    }
+}
 
-    output(sim_number, time, genome->average_interorigin_distance(), genome);
+void SPhase::fire_batch(int n_attempts, int time, int &constitutive_origins)
+{
+    if (n_attempts <= 0) return;
+    genome->random_candidates(n_attempts, candidates);
+
+    // Firing only replicates bases, the landscape stays the same
+    for (int i = 0; i < n_attempts && fork_manager->n_free_forks >= 2; i++)
+    {
+        uint chromosome = candidates.chromosomes[i];
+        uint base       = candidates.bases[i];
+        if (!candidates.accepted[i] ||
+            genome->chromosomes[chromosome]->base_is_replicated(base))
+            continue;
+
+        GenomicLocation location = genome->location(chromosome, base);
+        fire_origin(location, time, constitutive_origins);
+    }
+}
+
+void SPhase::fire_origin(GenomicLocation &location, int time,
+                         int &constitutive_origins)
+{
+    fork_manager->attach_forks(location, time);
+    if (origins_range > 0)
+    {
+        constitutive_origin_t origin =
+            location.get_constitutive_origin(origins_range);
+        if (!location.put_fired_constitutive_origin(origin))
+            constitutive_origins += 0;
+        // std::cout << "[WARN] Failed to add origin. "
+        //  "Simulation "
+        //   << sim_number << std::endl;
+        constitutive_origins--;
+    }
+}
+
+void SPhase::set_output_queue(std::shared_ptr<OutputQueue> output_queue)
+{
+    this->output_queue = output_queue;
+}
+
+void SPhase::set_profile(std::shared_ptr<ReplicationProfile> profile)
+{
+    this->profile = profile;
 }
 
 void SPhase::output(int sim_number, int time, int iod,
@@ -157,6 +351,14 @@ void SPhase::output(int sim_number, int time, int iod,
 {
     checkpoint_times.start_save = std::chrono::steady_clock::now();
 
+    if (profile) profile->add(*genome);
+
+    if (!output_format.compare("summary"))
+    {
+        checkpoint_times.end_save = checkpoint_times.start_save;
+        return;
+    }
+
     // Create simulation folder
     std::stringstream folder_name_stream;
 
@@ -167,162 +369,129 @@ void SPhase::output(int sim_number, int time, int iod,
 
     std::string dir        = folder_name_stream.str();
     std::string simulation = "simulation_" + std::to_string(sim_number) + "/";
-
-    system(("mkdir -p " + output_folder).c_str());
-
-    system(("mkdir -p " + dir).c_str());
-    system(("mkdir  -p " + dir + simulation).c_str());
-
-    // Create Metadata File
-    std::ofstream output_file;
-    output_file.open((dir + simulation + "cell.txt").c_str());
-    output_file << n_resources << "\t" << this->replication_speed << "\t"
-                << time << "\t" << iod << "\t\n";
-    output_file.close();
-
-    // Save Chromosome data
-    semantic_compression_output(sim_number, time, iod, genome,
-                                dir + simulation);
-
-    // Write chromosome data
-
-    /*for (auto chromosome_ptr : this->genome->chromosomes)
+    std::string path       = dir + simulation;
+
+    // Only copies go to the job, which may run after this SPhase is gone or
+    // reset for another cell
+    int n_resources       = this->n_resources;
+    int replication_speed = this->replication_speed;
+    std::string format    = output_format;
+    std::vector<std::pair<std::string, Strand>> strands;
+    std::vector<std::pair<std::string, uint>> chromosomes;
+    std::vector<fork_run_t> runs;
+    // The events format needs the runs of the forks instead of the Strands
+    if (event_log)
     {
-        // Get chromosome reference
-        auto &chromosome = *chromosome_ptr;
-
-        // Make filename
-        std::string code = chromosome.get_code() + ".cseq";
-
-        std::ofstream output_file;
-        output_file.open((dir + simulation + code).c_str());
-
-        output_file << chromosome.to_string();
+        fork_manager->log_attached_forks();
+        runs.assign(event_log->get_runs().begin(), event_log->get_runs().end());
+        for (auto chromosome : genome->chromosomes)
+            chromosomes.emplace_back(chromosome->get_code(),
+                                     chromosome->size());
+    }
+    else
+        for (auto chromosome : genome->chromosomes)
+            strands.emplace_back(chromosome->get_code(),
+                                 chromosome->get_strand());
+    // Moved rather than copied, as this runs on the simulation thread
+    auto job = [path, n_resources, replication_speed, time, iod,
+                strands = std::move(strands),
+                chromosomes = std::move(chromosomes), runs = std::move(runs),
+                format]() mutable {
+        // Tell which cell failed, as the job may run on a writer thread
+        try
+        {
+            std::filesystem::create_directories(path);
+
+            // Create Metadata File
+            std::ofstream output_file;
+            output_file.open((path + "cell.txt").c_str());
+            output_file << n_resources << "\t" << replication_speed << "\t"
+                        << time << "\t" << iod << "\t\n";
+            output_file.close();
+
+            // Save Chromosome data
+            if (!format.compare("events"))
+                event_log_output(runs, chromosomes, replication_speed, path);
+            else
+                semantic_compression_output(strands, path, format);
+        }
+        catch (std::exception &e)
+        {
+            throw std::runtime_error("Could not write the output of " + path +
+                                     ": " + e.what());
+        }
+    };
 
-        output_file.close();
-    }*/
+    if (output_queue)
+        output_queue->push(std::move(job));
+    else
+        job();
 
     checkpoint_times.end_save = std::chrono::steady_clock::now();
 }
 
-void SPhase::semantic_compression_output(int sim_number, int time, int iod,
-                                         std::shared_ptr<Genome> genome,
-                                         std::string path)
+void SPhase::semantic_compression_output(
+    std::vector<std::pair<std::string, Strand>> &strands, std::string path,
+    std::string format)
 {
-    // Makes formatted string for compression
-    auto output_str = [](int start_value, int end_value, int seq_length) {
-        std::string out = std::to_string(start_value);
-        if (end_value != INT32_MIN && end_value != start_value)
-            out += "-" + std::to_string(end_value);
-        if (seq_length != 1) out += "x" + std::to_string(seq_length);
-
-        return out;
-    };
-
     // Write chromosome data
-    for (auto chromosome_ptr : this->genome->chromosomes)
+    for (auto &code_strand : strands)
     {
-        // Get chromosome reference
-        auto &chromosome = *chromosome_ptr;
+        // Get chromosome replication times
+        auto &chromosome = code_strand.second;
 
         // Make filename
-        std::string code = chromosome.get_code() + ".cseq";
+        std::string code = code_strand.first + ".cseq";
+
+        if (!format.compare("zst"))
+        {
+            TimingFileWriter writer(path + code + ".zst", code_strand.first,
+                                    chromosome.size());
+            compress_replication_times(
+                chromosome,
+                [&](const timing_record_t &record) { writer.write(record); });
+            writer.close();
+            continue;
+        }
 
         // Open file for writing
         std::ofstream output_file;
         output_file.open((path + code).c_str());
 
-        // Current and last two number streaks
-        struct number_streak
-        {
-            int value   = INT32_MIN;
-            int length  = INT32_MIN;
-            bool in_seq = false;
-        } number_streaks[3], null_streak;
-
-        // Sequence data
-        struct sequence_data
-        {
-            int start_value = INT32_MIN;
-            int direction   = 0;
-        } sequence, null_sequence;
-
-        // Cache chromosome size
-        const int chromosome_size = chromosome.size();
-
-        for (int bp = 0; bp < chromosome_size + 2; bp++)
-        {
-            // Retrieve value if in range
-            int value = INT32_MIN;
-            if (bp < chromosome_size) value = chromosome[bp];
-
-            // If a new number streak has started
-            if (value == INT32_MIN || value != number_streaks[0].value)
-            {
-                // Finalize sequence if unable to continue, like when streak
-                // changes size or step size
-                if (sequence.start_value != INT32_MIN &&
-                    (number_streaks[0].length != number_streaks[1].length ||
-                     sequence.direction !=
-                         number_streaks[0].value - number_streaks[1].value))
-                {
-                    // Write output for this sequence
-                    output_file << output_str(sequence.start_value,
-                                              number_streaks[1].value,
-                                              number_streaks[1].length)
-                                << std::endl;
-
-                    // Zero sequence data
-                    sequence = null_sequence;
-
-                    // Set as sequence
-                    number_streaks[1].in_seq = true;
-                }
-                // Start sequence if not in sequence, current streak is valid,
-                // and start of sequence is valid
-                else if (sequence.start_value == INT32_MIN &&
-                         number_streaks[0].value != INT32_MIN &&
-                         number_streaks[0].length != INT32_MIN &&
-                         number_streaks[0].length == number_streaks[1].length &&
-                         abs(number_streaks[0].value -
-                             number_streaks[1].value) == 1)
-                {
-                    // Create sequence
-                    sequence.start_value = number_streaks[1].value;
-                    sequence.direction =
-                        number_streaks[0].value - number_streaks[1].value;
-
-                    // Set as sequence
-                    number_streaks[1].in_seq = true;
-                }
-                // Set as sequence if in sequence
-                else if (sequence.start_value != INT32_MIN)
-                    number_streaks[1].in_seq = true;
-
-                // If it's a unique value streak (not a sequence)
-                if (!number_streaks[1].in_seq &&
-                    number_streaks[1].value != INT32_MIN)
-                {
-                    // Write output for this value
-                    output_file
-                        << output_str(number_streaks[1].value, INT32_MIN,
-                                      number_streaks[1].length)
-                        << std::endl;
-                }
-
-                // Shift number streaks
-                number_streaks[2] = number_streaks[1];
-                number_streaks[1] = number_streaks[0];
-                number_streaks[0] = number_streak{value, 0, false};
-            }
-
-            if (value != INT32_MIN) number_streaks[0].length++;
-        }
+        compress_replication_times(chromosome,
+                                   [&](const timing_record_t &record) {
+                                       output_file << to_string(record) << '\n';
+                                   });
 
         output_file.close();
     }
 }
 
+void SPhase::event_log_output(
+    std::vector<fork_run_t> &runs,
+    std::vector<std::pair<std::string, uint>> &chromosomes, uint speed,
+    std::string path)
+{
+    // Group the runs by Chromosome
+    std::stable_sort(runs.begin(), runs.end(),
+                     [](const fork_run_t &a, const fork_run_t &b) {
+                         return a.chromosome < b.chromosome;
+                     });
+
+    auto run = runs.begin();
+    for (uint id = 0; id < chromosomes.size(); id++)
+    {
+        auto end = std::find_if(run, runs.end(), [id](const fork_run_t &r) {
+            return r.chromosome != id;
+        });
+        std::vector<fork_run_t> chromosome_runs(run, end);
+        ForkEventLog::write(path + chromosomes[id].first + ".events",
+                            chromosomes[id].first, chromosomes[id].second,
+                            speed, chromosome_runs);
+        run = end;
+    }
+}
+
 const s_phase_checkpoints_t SPhase::getTimes() const
 {
     return checkpoint_times;
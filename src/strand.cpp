@@ -0,0 +1,142 @@
+#include "strand.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+Strand::Strand(uint length) : length(length), hint(0) {}
+
+uint Strand::size() const { return this->length; }
+
+int Strand::time_at(const strand_segment_t &segment, int base)
+{
+    if (segment.speed == 0) return segment.anchor_time;
+    uint distance = (base - segment.anchor) * segment.direction;
+    return segment.anchor_time + (distance + segment.speed - 1) / segment.speed;
+}
+
+uint Strand::first_ending_from(uint base)
+{
+    return std::lower_bound(segments.begin(), segments.end(), (int)base,
+                            [](const strand_segment_t &segment, int base) {
+                                return segment.last < base;
+                            }) -
+           segments.begin();
+}
+
+uint Strand::find(uint base)
+{
+    // Try the last segment found and the one after it first
+    for (uint i = hint; i < hint + 2 && i < segments.size(); i++)
+    {
+        if (segments[i].first <= (int)base && segments[i].last >= (int)base)
+        {
+            hint = i;
+            return i;
+        }
+    }
+
+    uint i = first_ending_from(base);
+    if (i == segments.size() || segments[i].first > (int)base)
+        return segments.size();
+    hint = i;
+    return i;
+}
+
+int Strand::operator[](uint base)
+{
+    uint i = find(base);
+    return i == segments.size() ? -1 : time_at(segments[i], base);
+}
+
+bool Strand::is_replicated(uint base)
+{
+    if (base >= this->length)
+        throw std::out_of_range("Given base is outside Strand length.");
+    return find(base) != segments.size();
+}
+
+uint Strand::unreplicated_run(int base, int direction, uint limit)
+{
+    long long first = (long long)base + direction;
+    if (first < 0 || first >= (long long)this->length) return 0;
+
+    // Closest replicated base at first or beyond it. A fork usually counts
+    // from the edge of its own segment, which find has just cached.
+    long long replicated;
+    uint i = base >= 0 && base < (int)this->length ? find(base)
+                                                   : segments.size();
+    if (i < segments.size())
+    {
+        if (direction == 1)
+            replicated = segments[i].last > base      ? first
+                         : i + 1 < segments.size() ? segments[i + 1].first
+                                                   : this->length;
+        else
+            replicated = segments[i].first < base ? first
+                         : i > 0                 ? segments[i - 1].last
+                                                 : -1;
+    }
+    else
+    {
+        i = first_ending_from(first);
+        if (direction == 1)
+            replicated = i == segments.size()
+                             ? this->length
+                             : std::max<long long>(first, segments[i].first);
+        else if (i < segments.size() && segments[i].first <= first)
+            replicated = first;
+        else
+            replicated = i == 0 ? -1 : segments[i - 1].last;
+    }
+
+    long long run = (replicated - first) * direction;
+    return (uint)std::min<long long>(run, limit);
+}
+
+void Strand::replicate(int anchor, int direction, uint speed, int anchor_time,
+                       uint n_bases)
+{
+    if (n_bases == 0) return;
+
+    // Grow the segment ending at anchor if the new bases follow its pattern
+    uint i = anchor >= 0 ? find(anchor) : segments.size();
+    if (i < segments.size() && segments[i].direction == direction &&
+        segments[i].speed == speed &&
+        (direction == 1 ? segments[i].last : segments[i].first) == anchor)
+    {
+        strand_segment_t &segment = segments[i];
+        uint distance             = (anchor - segment.anchor) * direction;
+        bool same_pattern =
+            speed == 0 ? segment.anchor_time == anchor_time
+                       : distance % speed == 0 &&
+                             time_at(segment, anchor) == anchor_time;
+        if (same_pattern)
+        {
+            if (direction == 1)
+                segment.last += n_bases;
+            else
+                segment.first -= n_bases;
+            return;
+        }
+    }
+
+    strand_segment_t segment;
+    segment.first       = direction == 1 ? anchor + 1 : anchor - (int)n_bases;
+    segment.last        = direction == 1 ? anchor + (int)n_bases : anchor - 1;
+    segment.anchor      = anchor;
+    segment.direction   = direction;
+    segment.speed       = speed;
+    segment.anchor_time = anchor_time;
+    segments.insert(segments.begin() + first_ending_from(segment.first),
+                    segment);
+}
+
+const pool_vector<strand_segment_t> &Strand::get_segments() const
+{
+    return segments;
+}
+
+void Strand::clear()
+{
+    segments.clear();
+    hint = 0;
+}
@@ -0,0 +1,88 @@
+#include "summary_statistic.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+SummaryStatistic::SummaryStatistic(bool keep_histogram)
+    : n(0), sum(0), sum_squares(0), minimum(0), maximum(0),
+      bins(keep_histogram ? SUMMARY_BINS : 0, 0)
+{
+}
+
+void SummaryStatistic::add(unsigned long long value)
+{
+    minimum = n ? std::min(minimum, value) : value;
+    maximum = n ? std::max(maximum, value) : value;
+    n++;
+    sum += value;
+    sum_squares += (unsigned __int128)value * value;
+    if (!bins.empty()) bins[bin(value)]++;
+}
+
+void SummaryStatistic::merge(const SummaryStatistic &other)
+{
+    if (!other.n) return;
+    if (bins.size() != other.bins.size())
+        throw std::invalid_argument("Only SummaryStatistics that both keep a "
+                                    "histogram or both do not can be merged.");
+
+    minimum = n ? std::min(minimum, other.minimum) : other.minimum;
+    maximum = n ? std::max(maximum, other.maximum) : other.maximum;
+    n += other.n;
+    sum += other.sum;
+    sum_squares += other.sum_squares;
+    for (uint i = 0; i < bins.size(); i++)
+        bins[i] += other.bins[i];
+}
+
+unsigned long long SummaryStatistic::count() const { return n; }
+
+double SummaryStatistic::mean() const { return n ? (double)sum / n : 0; }
+
+double SummaryStatistic::variance() const
+{
+    if (n < 2) return 0;
+
+    // n * sum of squares - sum^2 is exact, the only rounding is at the end
+    unsigned __int128 scaled = n * sum_squares - sum * sum;
+    return (double)scaled / ((double)n * (n - 1));
+}
+
+double SummaryStatistic::sd() const { return std::sqrt(variance()); }
+
+unsigned long long SummaryStatistic::min() const { return minimum; }
+
+unsigned long long SummaryStatistic::max() const { return maximum; }
+
+const std::vector<unsigned long long> &SummaryStatistic::histogram() const
+{
+    return bins;
+}
+
+uint SummaryStatistic::bin(unsigned long long value)
+{
+    return log_linear_bin(value, SUMMARY_SUB_BITS);
+}
+
+unsigned long long SummaryStatistic::bin_lower_bound(uint bin)
+{
+    return log_linear_bin_lower_bound(bin, SUMMARY_SUB_BITS);
+}
+
+std::string SummaryStatistic::to_string() const
+{
+    std::stringstream text;
+    text << n << "\t" << std::fixed << std::setprecision(2) << mean() << "\t"
+         << sd() << "\t" << minimum << "\t" << maximum << "\t";
+
+    bool first = true;
+    for (uint i = 0; i < bins.size(); i++)
+    {
+        if (!bins[i]) continue;
+        text << (first ? "" : ",") << bin_lower_bound(i) << ":" << bins[i];
+        first = false;
+    }
+    return text.str();
+}
@@ -0,0 +1,234 @@
+#include "timing_file.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+std::string to_string(const timing_record_t &record)
+{
+    std::string out = std::to_string(record.start);
+    if (record.end != record.start) out += "-" + std::to_string(record.end);
+    if (record.length != 1) out += "x" + std::to_string(record.length);
+
+    return out;
+}
+
+TimingFileWriter::TimingFileWriter(std::string path, std::string code,
+                                   uint length, int level)
+    : context(nullptr, ZSTD_freeCCtx),
+      in_buffer(std::max<size_t>(ZSTD_CStreamInSize(), TIMING_FILE_BUFFER)),
+      out_buffer(std::max<size_t>(ZSTD_CStreamOutSize(), TIMING_FILE_BUFFER))
+{
+    file.open(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file " + path);
+
+    context.reset(ZSTD_createCCtx());
+    if (context == nullptr)
+        throw std::runtime_error("Could not create the zstd context.");
+    ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(context.get(), ZSTD_c_checksumFlag, 1);
+
+    in_buffer.clear();
+    chunk.reserve(TIMING_FILE_CHUNK);
+
+    int32_t header[] = {TIMING_FILE_MAGIC, TIMING_FILE_VERSION, (int32_t)length,
+                        (int32_t)code.size()};
+    write_bytes(header, sizeof(header));
+    write_bytes(code.data(), code.size());
+}
+
+TimingFileWriter::~TimingFileWriter()
+{
+    // Throwing here would terminate, possibly while unwinding
+    try
+    {
+        close();
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "[ERROR] Could not close the timing file: " << e.what()
+                  << std::endl;
+    }
+}
+
+void TimingFileWriter::write_bytes(const void *data, size_t size)
+{
+    const char *bytes = (const char *)data;
+    while (size > 0)
+    {
+        size_t n = std::min(size, in_buffer.capacity() - in_buffer.size());
+        in_buffer.insert(in_buffer.end(), bytes, bytes + n);
+        bytes += n;
+        size -= n;
+        if (in_buffer.size() == in_buffer.capacity())
+            compress(ZSTD_e_continue);
+    }
+}
+
+void TimingFileWriter::write_chunk()
+{
+    int32_t n_records = chunk.size();
+    write_bytes(&n_records, sizeof(n_records));
+    write_bytes(chunk.data(), chunk.size() * sizeof(timing_record_t));
+    chunk.clear();
+}
+
+void TimingFileWriter::compress(ZSTD_EndDirective directive)
+{
+    ZSTD_inBuffer input = {in_buffer.data(), in_buffer.size(), 0};
+    bool finished;
+    do
+    {
+        ZSTD_outBuffer output = {out_buffer.data(), out_buffer.size(), 0};
+        size_t remaining =
+            ZSTD_compressStream2(context.get(), &output, &input, directive);
+        if (ZSTD_isError(remaining))
+            throw std::runtime_error(ZSTD_getErrorName(remaining));
+        file.write(out_buffer.data(), output.pos);
+
+        finished = directive == ZSTD_e_end ? remaining == 0
+                                           : input.pos == input.size;
+    } while (!finished);
+    in_buffer.clear();
+
+    if (!file.good())
+        throw std::runtime_error("Could not write the timing file.");
+}
+
+void TimingFileWriter::write(const timing_record_t &record)
+{
+    chunk.push_back(record);
+    if (chunk.size() == TIMING_FILE_CHUNK) write_chunk();
+}
+
+void TimingFileWriter::close()
+{
+    if (context == nullptr) return;
+
+    try
+    {
+        if (!chunk.empty()) write_chunk();
+        // Empty chunk marks the end
+        write_chunk();
+        compress(ZSTD_e_end);
+    }
+    catch (std::exception &e)
+    {
+        // A failed file is closed too, so that it is only reported once
+        context.reset();
+        file.close();
+        throw;
+    }
+
+    context.reset();
+    file.close();
+}
+
+TimingFileReader::TimingFileReader(std::string path)
+    : context(ZSTD_createDCtx(), ZSTD_freeDCtx),
+      in_buffer(ZSTD_DStreamInSize()), out_buffer(ZSTD_DStreamOutSize()),
+      input{in_buffer.data(), 0, 0}, out_pos(0), out_size(0), chunk_left(0),
+      ended(false)
+{
+    file.open(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file " + path);
+
+    if (context == nullptr)
+        throw std::runtime_error("Could not create the zstd context.");
+
+    int32_t header[4];
+    read_bytes(header, sizeof(header));
+    if (header[0] != TIMING_FILE_MAGIC)
+        throw std::runtime_error(path + " is not a timing file.");
+    if (header[1] != TIMING_FILE_VERSION)
+        throw std::runtime_error("Unsupported timing file version " +
+                                 std::to_string(header[1]) + ".");
+    if (header[2] < 0 || header[3] < 0 || header[3] > TIMING_FILE_MAX_CODE)
+        throw std::runtime_error(path + " has an invalid header.");
+    length = header[2];
+    code.resize(header[3]);
+    read_bytes(&code[0], code.size());
+}
+
+void TimingFileReader::read_bytes(void *data, size_t size)
+{
+    char *bytes = (char *)data;
+    while (size > 0)
+    {
+        if (out_pos == out_size)
+        {
+            if (input.pos == input.size)
+            {
+                file.read(in_buffer.data(), in_buffer.size());
+                if (file.gcount() == 0)
+                    throw std::runtime_error("Truncated timing file.");
+                input = {in_buffer.data(), (size_t)file.gcount(), 0};
+            }
+
+            ZSTD_outBuffer output = {out_buffer.data(), out_buffer.size(), 0};
+            size_t status =
+                ZSTD_decompressStream(context.get(), &output, &input);
+            if (ZSTD_isError(status))
+                throw std::runtime_error(ZSTD_getErrorName(status));
+            out_pos  = 0;
+            out_size = output.pos;
+            continue;
+        }
+
+        size_t n = std::min(size, out_size - out_pos);
+        std::copy(out_buffer.data() + out_pos, out_buffer.data() + out_pos + n,
+                  bytes);
+        out_pos += n;
+        bytes += n;
+        size -= n;
+    }
+}
+
+std::string TimingFileReader::get_code() { return code; }
+
+uint TimingFileReader::get_length() { return length; }
+
+bool TimingFileReader::next(timing_record_t &record)
+{
+    if (ended) return false;
+    if (chunk_left == 0)
+    {
+        int32_t n_records;
+        read_bytes(&n_records, sizeof(n_records));
+        if (n_records == 0)
+        {
+            ended = true;
+            return false;
+        }
+        chunk_left = n_records;
+    }
+
+    read_bytes(&record, sizeof(record));
+    chunk_left--;
+    return true;
+}
+
+std::vector<int> TimingFileReader::times()
+{
+    std::vector<int> times;
+    times.reserve(length);
+
+    timing_record_t record;
+    while (next(record))
+    {
+        int step = record.end < record.start ? -1 : 1;
+        for (int time = record.start;; time += step)
+        {
+            times.insert(times.end(), record.length, time);
+            if (time == record.end) break;
+        }
+    }
+
+    if (times.size() != length)
+        throw std::runtime_error("The records of " + code + " cover " +
+                                 std::to_string(times.size()) +
+                                 " bases instead of " +
+                                 std::to_string(length) + ".");
+    return times;
+}
@@ -0,0 +1,25 @@
+#include "transcription_region_index.hpp"
+#include <algorithm>
+#include <climits>
+
+TranscriptionRegionIndex::TranscriptionRegionIndex(
+    const std::vector<transcription_region_t> &regions)
+    : regions(regions), reach(regions.size())
+{
+    std::stable_sort(this->regions.begin(), this->regions.end(),
+                     [](const transcription_region_t &a,
+                        const transcription_region_t &b) {
+                         return std::min(a.start, a.end) <
+                                std::min(b.start, b.end);
+                     });
+
+    int highest = INT_MIN;
+    for (uint i = 0; i < this->regions.size(); i++)
+    {
+        highest  = std::max(highest, std::max(this->regions[i].start,
+                                              this->regions[i].end));
+        reach[i] = highest;
+    }
+}
+
+uint TranscriptionRegionIndex::size() const { return regions.size(); }
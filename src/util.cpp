@@ -4,3 +4,23 @@ bool operator==(const constitutive_origin_t &a, const constitutive_origin_t &b)
 {
     return (a.base == b.base);
 }
+
+uint log_linear_bin(unsigned long long value, uint sub_bits)
+{
+    uint sub_bins = 1U << sub_bits;
+    if (value < 2 * sub_bins) return (uint)value;
+
+    uint octave = 63 - __builtin_clzll(value);
+    uint sub    = (uint)(value >> (octave - sub_bits)) % sub_bins;
+    return 2 * sub_bins + (octave - sub_bits - 1) * sub_bins + sub;
+}
+
+unsigned long long log_linear_bin_lower_bound(uint bin, uint sub_bits)
+{
+    uint sub_bins = 1U << sub_bits;
+    if (bin < 2 * sub_bins) return bin;
+
+    uint octave = (bin - 2 * sub_bins) / sub_bins + sub_bits + 1;
+    uint sub    = (bin - 2 * sub_bins) % sub_bins;
+    return (unsigned long long)(sub_bins + sub) << (octave - sub_bits);
+}
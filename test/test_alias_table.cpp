@@ -0,0 +1,59 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "../include/alias_table.hpp"
+
+TEST(AliasTableTest, InvalidWeights)
+{
+    ASSERT_THROW(AliasTable(std::vector<double>()), std::invalid_argument);
+    ASSERT_THROW(AliasTable({1, -1}), std::invalid_argument);
+    ASSERT_THROW(AliasTable({0, 0}), std::invalid_argument);
+    ASSERT_EQ(AliasTable({0, 2, 0}).size(), 3);
+}
+
+/*! Tests the words at the edges of each column.
+ */
+TEST(AliasTableTest, Edges)
+{
+    AliasTable single({5});
+    ASSERT_EQ(single.sample(0), 0);
+    ASSERT_EQ(single.sample(UINT64_MAX), 0);
+
+    // Indexes without weight are never drawn
+    AliasTable table({0, 1, 0, 1});
+    for (uint64_t word : {(uint64_t)0, (uint64_t)1, (uint64_t)1 << 62,
+                          (uint64_t)1 << 63, UINT64_MAX})
+    {
+        uint index = table.sample(word);
+        ASSERT_TRUE(index == 1 || index == 3);
+    }
+}
+
+/*! Tests if the indexes are drawn with the chance of their weight.
+ */
+TEST(AliasTableTest, Distribution)
+{
+    std::vector<double> weights = {1, 0, 7, 2, 0.5, 9.5};
+    AliasTable table(weights);
+    std::mt19937_64 generator(3);
+
+    const int n = 200000;
+    std::vector<int> counts(weights.size(), 0);
+    for (int i = 0; i < n; i++)
+        counts[table.sample(generator())]++;
+
+    for (uint i = 0; i < weights.size(); i++)
+    {
+        double p = weights[i] / 20;
+        ASSERT_NEAR(counts[i], n * p, 5 * std::sqrt(n * p * (1 - p)) + 1e-9);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
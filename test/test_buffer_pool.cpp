@@ -0,0 +1,89 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+
+#include "../include/buffer_pool.hpp"
+
+/*! Tests if freed blocks are given again for sizes of the same class.
+ */
+TEST(BufferPoolTest, ReusesBlocks)
+{
+    BufferPool pool;
+    void *block = pool.allocate(1000);
+    ASSERT_EQ((uintptr_t)block % 64, 0);
+    ASSERT_EQ(pool.cached_bytes(), 0);
+
+    pool.deallocate(block, 1000);
+    ASSERT_EQ(pool.cached_bytes(), 1024);
+    ASSERT_EQ(pool.allocate(600), block);
+    ASSERT_EQ(pool.cached_bytes(), 0);
+
+    // Another class does not get it
+    pool.deallocate(block, 600);
+    void *other = pool.allocate(2000);
+    ASSERT_NE(other, block);
+    pool.deallocate(other, 2000);
+}
+
+/*! Tests if the pool keeps at most BUFFER_POOL_MAX_CACHED bytes.
+ */
+TEST(BufferPoolTest, CachedLimit)
+{
+    BufferPool pool;
+    size_t size = BUFFER_POOL_MAX_CACHED / 2;
+    void *first = pool.allocate(size);
+    void *second = pool.allocate(size);
+    void *third = pool.allocate(size);
+    pool.deallocate(first, size);
+    pool.deallocate(second, size);
+    pool.deallocate(third, size);
+    ASSERT_EQ(pool.cached_bytes(), BUFFER_POOL_MAX_CACHED);
+
+    // Blocks above the largest class are never kept
+    size_t large = (1ULL << BUFFER_POOL_MAX_BITS) + 1;
+    BufferPool huge(true);
+    void *block = huge.allocate(large);
+    ASSERT_EQ((uintptr_t)block % BUFFER_POOL_HUGE_PAGE, 0);
+    huge.deallocate(block, large);
+    ASSERT_EQ(huge.cached_bytes(), 0);
+}
+
+/*! Tests if blocks can be taken and given back by several threads.
+ */
+TEST(BufferPoolTest, Threads)
+{
+    BufferPool pool;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([&pool, i] {
+            for (int j = 0; j < 1000; j++)
+            {
+                size_t size = 64 << ((i + j) % 8);
+                char *block = (char *)pool.allocate(size);
+                block[0] = block[size - 1] = (char)j;
+                pool.deallocate(block, size);
+            }
+        });
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_LE(pool.cached_bytes(), 4 * (64ULL << 8));
+}
+
+/*! Tests if containers work with the PoolAllocator.
+ */
+TEST(BufferPoolTest, PoolVector)
+{
+    pool_vector<int> values;
+    for (int i = 0; i < 10000; i++)
+        values.push_back(i);
+    pool_vector<int> copy = values;
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(copy[i], i);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
 #include <memory>
 
@@ -9,6 +10,7 @@ class TestingProvider : public DataProvider
 {
   private:
     int size;
+    std::vector<std::string> codes;
     std::vector<double> prob_landscape;
     std::vector<transcription_region_t> transcription_regions;
     std::vector<constitutive_origin_t> cons_origins;
@@ -29,28 +31,31 @@ class TestingProvider : public DataProvider
         cons_origins.resize(size, origin);
     }
 
-    const std::vector<std::string> &get_codes()
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
     {
-        std::vector<std::string> codes;
-        return codes;
+        codes.assign(1, code);
+        return 0;
     }
 
-    int get_length(std::string code) { return size; }
+    int get_length(uint id) { return size; }
 
-    const std::vector<double> &get_probability_landscape(std::string code)
+    const std::vector<double> &get_probability_landscape(uint id)
     {
         return prob_landscape;
     }
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code)
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
     {
         return std::make_shared<std::vector<transcription_region_t>>(
             transcription_regions);
     }
 
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code)
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
     {
         return std::make_shared<std::vector<constitutive_origin_t>>(
             cons_origins);
@@ -159,6 +164,22 @@ TEST_F(ChromosomeTest, SetDormantActivationProbability)
     }
 }
 
+/*! Tests if dormant activation only changes the landscape of its own
+ * Chromosome, not the one shared through the DataProvider.
+ */
+TEST_F(ChromosomeTest, SetDormantActivationProbabilityNotShared)
+{
+    std::shared_ptr<TestingProvider> provider(new TestingProvider(300000));
+    Chromosome first("1", provider);
+    Chromosome second("1", provider);
+
+    first.set_dormant_activation_probability(150000);
+    ASSERT_EQ(first.activation_probability(150000), 1);
+    ASSERT_EQ(second.activation_probability(150000), (double)1 / 300001);
+    ASSERT_EQ(provider->get_probability_landscape(first.get_id())[150000],
+              (double)1 / 300001);
+}
+
 TEST_F(ChromosomeTest, SetDormantActivationProbabilityOutsideChromosome)
 {
     ASSERT_THROW(chrm->set_dormant_activation_probability(400),
@@ -190,6 +211,99 @@ TEST_F(ChromosomeTest, Replicate)
     ASSERT_EQ(chrm->get_n_replicated_bases(), 31);
 }
 
+/*! Tests if replicating a run of steps at once gives the same result as
+ * replicating one step at a time.
+ */
+TEST_F(ChromosomeTest, ReplicateRun)
+{
+    auto stepwise = create_chromosome();
+    for (int step = 0; step < 7; step++)
+        stepwise->replicate(101 + step * 3, 103 + step * 3, 10 + step);
+    chrm->replicate_run(100, 1, 3, 10, 7);
+    for (int base = 0; base < 300; base++)
+        ASSERT_EQ((*chrm)[base], (*stepwise)[base]);
+    ASSERT_EQ(chrm->get_n_replicated_bases(), 21);
+
+    chrm->replicate_run(100, -1, 3, 10, 2);
+    ASSERT_EQ((*chrm)[94], 11);
+    ASSERT_EQ((*chrm)[99], 10);
+    ASSERT_THROW(chrm->replicate_run(5, -1, 3, 10, 2), std::out_of_range);
+}
+
+TEST_F(ChromosomeTest, UnreplicatedRun)
+{
+    chrm->replicate(50, 59, 1);
+    ASSERT_EQ(chrm->unreplicated_run(20, 1, 100), 29);
+    ASSERT_EQ(chrm->unreplicated_run(20, 1, 10), 10);
+    ASSERT_EQ(chrm->unreplicated_run(20, -1, 100), 20);
+    ASSERT_EQ(chrm->unreplicated_run(70, 1, 1000), 229);
+    ASSERT_EQ(chrm->unreplicated_run(49, 1, 100), 0);
+}
+
+TEST_F(ChromosomeTest, UnreplicatedActivationMass)
+{
+    ASSERT_NEAR(chrm->unreplicated_activation_mass(), (double)300 / 301, 1e-6);
+    chrm->replicate(0, 99, 1);
+    ASSERT_NEAR(chrm->unreplicated_activation_mass(), (double)200 / 301, 1e-6);
+    chrm->replicate(100, 299, 2);
+    ASSERT_EQ(chrm->unreplicated_activation_mass(), 0);
+}
+
+/*! Tests if the activation sampler skips replicated bases and follows the
+ * landscape after dormant origins change it.
+ */
+TEST_F(ChromosomeTest, RandomActivationBase)
+{
+    auto chrm_5k = create_chromosome(5000);
+    ASSERT_THROW(chrm_5k->random_activation_base(0), std::runtime_error);
+
+    chrm_5k->replicate(0, 2999, 1);
+    chrm_5k->enable_activation_sampling();
+    ASSERT_EQ(chrm_5k->random_activation_base(0), 3000);
+    ASSERT_EQ(chrm_5k->random_activation_base(
+                  chrm_5k->unreplicated_activation_units() - 1),
+              4999);
+
+    // Dormant origins change the weights of the bases left
+    chrm_5k->replicate(3000, 3999, 2);
+    chrm_5k->set_dormant_activation_probability(4000);
+    unsigned long long units = 0;
+    for (uint base = 4000; base < 5000; base++)
+    {
+        unsigned long long weight = std::llround(
+            chrm_5k->activation_probability(base) * 4294967296.0);
+        ASSERT_EQ(chrm_5k->random_activation_base(units), base);
+        ASSERT_EQ(chrm_5k->random_activation_base(units + weight - 1), base);
+        units += weight;
+    }
+    ASSERT_EQ(chrm_5k->unreplicated_activation_units(), units);
+    ASSERT_THROW(chrm_5k->random_activation_base(units), std::out_of_range);
+}
+
+/*! Tests if the gap sampler ranks the unreplicated bases, before and after
+ * it is enabled.
+ */
+TEST_F(ChromosomeTest, RandomUnreplicatedBase)
+{
+    auto chrm_5k = create_chromosome(5000);
+    ASSERT_THROW(chrm_5k->random_unreplicated_base(0), std::runtime_error);
+
+    chrm_5k->replicate(0, 999, 1);
+    chrm_5k->enable_gap_sampling();
+    ASSERT_EQ(chrm_5k->random_unreplicated_base(0), 1000);
+
+    chrm_5k->replicate(2000, 2999, 2);
+    chrm_5k->replicate_run(2999, 1, 10, 3, 10);
+    ASSERT_EQ(chrm_5k->random_unreplicated_base(999), 1999);
+    ASSERT_EQ(chrm_5k->random_unreplicated_base(1000), 3100);
+    ASSERT_EQ(chrm_5k->random_unreplicated_base(
+                  chrm_5k->size() - chrm_5k->get_n_replicated_bases() - 1),
+              4999);
+    ASSERT_THROW(chrm_5k->random_unreplicated_base(
+                     chrm_5k->size() - chrm_5k->get_n_replicated_bases()),
+                 std::out_of_range);
+}
+
 TEST_F(ChromosomeTest, IsReplicated)
 {
     ASSERT_FALSE(chrm->is_replicated());
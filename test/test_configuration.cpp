@@ -130,6 +130,148 @@ TEST_F(ConfigurationTest, InvalidCmdOption)
                  std::invalid_argument);
 }
 
+TEST_F(ConfigurationTest, EngineCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells", "2",      "--organism", "dummy",
+        "--resources",  "5",       "--timeout", "10",      "--engine",
+        "event",
+    };
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .engine,
+              "event");
+
+    optind        = 1;
+    argv_mock[10] = "warp";
+    ASSERT_THROW(Configuration(argv_mock.size(), argv_mock.data()),
+                 std::invalid_argument);
+}
+
+TEST_F(ConfigurationTest, SamplerCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells", "2",      "--organism", "dummy",
+        "--resources",  "5",       "--timeout", "10",      "--sampler",
+        "tree",
+    };
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .sampler,
+              "tree");
+
+    optind        = 1;
+    argv_mock[10] = "gap";
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .sampler,
+              "gap");
+
+    optind        = 1;
+    argv_mock[10] = "batch";
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .sampler,
+              "batch");
+
+    optind        = 1;
+    argv_mock[10] = "alias";
+    ASSERT_THROW(Configuration(argv_mock.size(), argv_mock.data()),
+                 std::invalid_argument);
+}
+
+TEST_F(ConfigurationTest, FormatCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells", "2",      "--organism", "dummy",
+        "--resources",  "5",       "--timeout", "10",      "--format",
+        "zst",
+    };
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .format,
+              "zst");
+
+    optind        = 1;
+    argv_mock[10] = "events";
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .format,
+              "events");
+
+    optind        = 1;
+    argv_mock[10] = "summary";
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .format,
+              "summary");
+
+    optind        = 1;
+    argv_mock[10] = "csv";
+    ASSERT_THROW(Configuration(argv_mock.size(), argv_mock.data()),
+                 std::invalid_argument);
+}
+
+TEST_F(ConfigurationTest, HugePagesCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells",   "2",  "--organism",  "dummy",
+        "--resources",  "5",         "--timeout", "10",
+    };
+    ASSERT_FALSE(Configuration(argv_mock.size(), argv_mock.data())
+                     .arguments()
+                     .huge_pages);
+
+    optind = 1;
+    argv_mock.push_back("--huge-pages");
+    ASSERT_TRUE(Configuration(argv_mock.size(), argv_mock.data())
+                    .arguments()
+                    .huge_pages);
+}
+
+TEST_F(ConfigurationTest, RngCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells", "2",      "--organism", "dummy",
+        "--resources",  "5",       "--timeout", "10",      "--rng",
+        "philox",
+    };
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .rng,
+              "philox");
+
+    optind        = 1;
+    argv_mock[10] = "xorshift";
+    ASSERT_THROW(Configuration(argv_mock.size(), argv_mock.data()),
+                 std::invalid_argument);
+}
+
+TEST_F(ConfigurationTest, ProfileBinCmdOption)
+{
+    std::vector<char *> argv_mock = {
+        "program_name", "--cells", "2",      "--organism", "dummy",
+        "--resources",  "5",       "--timeout", "10",
+    };
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .profile_bin,
+              0);
+
+    optind = 1;
+    argv_mock.push_back("--profile-bin");
+    argv_mock.push_back("1000");
+    ASSERT_EQ(Configuration(argv_mock.size(), argv_mock.data())
+                  .arguments()
+                  .profile_bin,
+              1000);
+
+    optind        = 1;
+    argv_mock[10] = "4294967296";
+    ASSERT_THROW(Configuration(argv_mock.size(), argv_mock.data()),
+                 std::invalid_argument);
+}
+
 TEST_F(ConfigurationTest, MandatoryCmdOption)
 {
     std::vector<char *> argv_mock = {
@@ -243,6 +385,98 @@ TEST_F(ConfigurationTest, ValidEvolutionConfigFile)
     ASSERT_EQ(expected, result);
 }
 
+TEST_F(ConfigurationTest, ValidSweepConfigFile)
+{
+    cl_configuration_data expected;
+    expected.mode     = "sweep";
+    expected.cells    = 10;
+    expected.name     = "abc";
+    expected.organism = "TcruziCLBrenerEsmeraldo-like";
+    expected.speed    = 65;
+    expected.timeout  = 1000000;
+    expected.seed     = 3;
+    for (unsigned long long resources = 10; resources <= 100; resources += 5)
+        expected.sweep.resources.push_back(resources);
+    expected.sweep.period  = {0, 100, 1000, 10000, 100000};
+    expected.sweep.dormant = {false, true};
+
+    std::vector<char *> argv_config = {"program_name", "-C",
+                                       "../test/config/config_sweep.yaml"};
+    cl_configuration_data result =
+        Configuration(argv_config.size(), argv_config.data()).arguments();
+    ASSERT_EQ(expected, result);
+    ASSERT_EQ(sweep_points(result).size(), 19 * 5 * 2);
+}
+
+TEST_F(ConfigurationTest, SweepLists)
+{
+    ASSERT_EQ(parse_ull_list({"5", " 7 ", "10:20:5", "1:2", "3:8:4"}),
+              std::vector<unsigned long long>({5, 7, 10, 15, 20, 1, 2, 3, 7}));
+    ASSERT_EQ(parse_ull_list({}), std::vector<unsigned long long>());
+
+    for (std::string item : {"", "a", "-1", "1.5", "2:1", "1:5:0", "1:2:3:4",
+                             "1:", ":1", "1::2"})
+        ASSERT_THROW(parse_ull_list({item}), std::invalid_argument) << item;
+
+    ASSERT_EQ(parse_bool_list({"true", " false"}),
+              std::vector<bool>({true, false}));
+    ASSERT_THROW(parse_bool_list({"yes"}), std::invalid_argument);
+}
+
+TEST_F(ConfigurationTest, SweepPoints)
+{
+    cl_configuration_data arguments;
+    arguments.mode            = "sweep";
+    arguments.cells           = 3;
+    arguments.name            = "abc";
+    arguments.resources       = 7;
+    arguments.speed           = 65;
+    arguments.period          = 100;
+    arguments.sweep.resources = {10, 20};
+    arguments.sweep.dormant   = {false, true};
+
+    // Unswept parameters keep their value and the names stay the same
+    std::vector<cl_configuration_data> points = sweep_points(arguments);
+    ASSERT_EQ(points.size(), 4);
+    for (uint i = 0; i < points.size(); i++)
+    {
+        ASSERT_EQ(points[i].mode, "basic");
+        ASSERT_EQ(points[i].dormant, i >= 2);
+        ASSERT_EQ(points[i].resources, i % 2 ? 20 : 10);
+        ASSERT_EQ(points[i].speed, 65);
+        ASSERT_EQ(points[i].period, 100);
+        ASSERT_EQ(points[i].cells, 3);
+        ASSERT_EQ(points[i].name, "abc");
+        ASSERT_TRUE(points[i].sweep == cl_sweep_data());
+    }
+
+    // Without a sweep there is only the configured point
+    cl_configuration_data single = arguments;
+    single.sweep                 = cl_sweep_data();
+    points                       = sweep_points(single);
+    ASSERT_EQ(points.size(), 1);
+    ASSERT_EQ(points[0].resources, 7);
+
+    // Speeds share a folder, so they are told apart by name
+    arguments.sweep.speed = {1, 65};
+    points                = sweep_points(arguments);
+    ASSERT_EQ(points.size(), 8);
+    ASSERT_EQ(points[0].name, "abc_speed1");
+    ASSERT_EQ(points[1].name, "abc_speed65");
+    ASSERT_EQ(points[1].speed, 65);
+
+    // Longest first sorts by resources * speed, keeping ties in order
+    arguments.sweep.order = "longest";
+    points                = sweep_points(arguments);
+    ASSERT_EQ(points.size(), 8);
+    for (uint i = 0; i < points.size(); i++)
+    {
+        ASSERT_EQ(points[i].resources, i % 4 < 2 ? 10 : 20);
+        ASSERT_EQ(points[i].speed, i < 4 ? 1 : 65);
+        ASSERT_EQ(points[i].dormant, i % 2 == 1);
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../include/constitutive_origin_index.hpp"
+
+class ConstitutiveOriginIndexTest : public ::testing::Test
+{
+  protected:
+    ConstitutiveOriginIndex *index;
+
+  protected:
+    ConstitutiveOriginIndexTest() {}
+
+    void SetUp()
+    {
+        std::vector<constitutive_origin_t> origins;
+        for (int base : {500, 100, 300, 100, 700})
+        {
+            constitutive_origin_t origin;
+            origin.base = base;
+            origins.push_back(origin);
+        }
+        index = new ConstitutiveOriginIndex(origins);
+    }
+
+    void TearDown() { delete index; }
+};
+
+TEST_F(ConstitutiveOriginIndexTest, Empty)
+{
+    ConstitutiveOriginIndex empty;
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_FALSE(empty.has_unfired(0, 1000));
+    ASSERT_EQ(empty.first_unfired(0, 1000).base, -1);
+    ASSERT_FALSE(empty.fire(0));
+    ASSERT_TRUE(empty.unfired().empty());
+}
+
+TEST_F(ConstitutiveOriginIndexTest, HasUnfired)
+{
+    ASSERT_EQ(index->size(), 5);
+    ASSERT_TRUE(index->has_unfired(100, 100));
+    ASSERT_TRUE(index->has_unfired(250, 350));
+    ASSERT_FALSE(index->has_unfired(101, 299));
+    ASSERT_FALSE(index->has_unfired(701, 1000));
+    ASSERT_FALSE(index->has_unfired(350, 250));
+}
+
+TEST_F(ConstitutiveOriginIndexTest, Fire)
+{
+    ASSERT_TRUE(index->fire(300));
+    ASSERT_TRUE(index->is_fired(300));
+    ASSERT_FALSE(index->has_unfired(250, 350));
+    ASSERT_TRUE(index->has_unfired(250, 500));
+    ASSERT_FALSE(index->fire(300));
+
+    // Both origins on base 100 fire at once
+    ASSERT_TRUE(index->fire(100));
+    ASSERT_FALSE(index->has_unfired(0, 499));
+    ASSERT_FALSE(index->fire(100));
+
+    ASSERT_FALSE(index->fire(200));
+    ASSERT_FALSE(index->is_fired(200));
+    ASSERT_FALSE(index->is_fired(500));
+}
+
+/*! The origin returned is the first of the original list, not the closest.
+ */
+TEST_F(ConstitutiveOriginIndexTest, FirstUnfired)
+{
+    ASSERT_EQ(index->first_unfired(0, 1000).base, 500);
+    ASSERT_EQ(index->first_unfired(0, 400).base, 100);
+    ASSERT_EQ(index->first_unfired(600, 1000).base, 700);
+    ASSERT_EQ(index->first_unfired(150, 250).base, -1);
+
+    index->fire(500);
+    ASSERT_EQ(index->first_unfired(0, 1000).base, 100);
+}
+
+TEST_F(ConstitutiveOriginIndexTest, Unfired)
+{
+    index->fire(500);
+    std::vector<int> bases;
+    for (auto origin : index->unfired())
+        bases.push_back(origin.base);
+    ASSERT_EQ(bases, std::vector<int>({100, 100, 300, 700}));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
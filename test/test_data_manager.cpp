@@ -48,6 +48,19 @@ TEST_F(DataManagerTest, GetTranscriptionRegions)
     ASSERT_EQ(result[0].end, 80);
 }
 
+TEST_F(DataManagerTest, GetTranscriptionRegionIndex)
+{
+    auto index = data->get_transcription_region_index("dummy_01");
+    ASSERT_EQ(index->size(), data->get_transcription_regions("dummy_01")->size());
+    ASSERT_TRUE(index->find_containing(
+        50, [](const transcription_region_t &region) {
+            return region.start == 25 && region.end == 80;
+        }));
+
+    // Built once and shared by every caller
+    ASSERT_EQ(index, data->get_transcription_region_index("dummy_01"));
+}
+
 TEST_F(DataManagerTest, GetConstitutiveOrigin)
 {
     std::vector<constitutive_origin_t> result =
@@ -55,6 +68,47 @@ TEST_F(DataManagerTest, GetConstitutiveOrigin)
     ASSERT_EQ(result[0].base, 1234);
 }
 
+TEST_F(DataManagerTest, GetChromosomeId)
+{
+    auto codes = data->get_codes();
+    for (uint id = 0; id < codes.size(); id++)
+        ASSERT_EQ(data->get_chromosome_id(codes[id]), id);
+    ASSERT_THROW(data->get_chromosome_id("no_such_code"), std::out_of_range);
+}
+
+TEST_F(DataManagerTest, GetChromosomeData)
+{
+    auto codes = data->get_codes();
+    for (uint id = 0; id < codes.size(); id++)
+    {
+        auto chromosome = data->get_chromosome_data(id);
+        ASSERT_EQ(chromosome->code, codes[id]);
+        ASSERT_EQ(chromosome->length, data->get_length(codes[id]));
+        ASSERT_EQ(chromosome->probability_landscape.data,
+                  data->get_probability_landscape(codes[id]).data());
+        // Regions and origins are shared with the snapshot, not copied
+        ASSERT_EQ(chromosome->transcription_regions,
+                  data->get_transcription_regions(codes[id]));
+        ASSERT_EQ(chromosome->constitutive_origins,
+                  data->get_constitutive_origins(codes[id]));
+        ASSERT_EQ(chromosome->transcription_region_index,
+                  data->get_transcription_region_index(codes[id]));
+
+        // The same snapshot is given to every caller, by id or by code
+        ASSERT_EQ(chromosome, data->get_chromosome_data(codes[id]));
+    }
+    ASSERT_THROW(data->get_chromosome_data((uint)codes.size()),
+                 std::out_of_range);
+}
+
+TEST(DataManagerLoadTest, MissingMFASeqFileThrows)
+{
+    // Reported from the constructor once every loader has stopped
+    ASSERT_THROW(DataManager("dummy", "../data/database.sqlite",
+                             "../data/MFA-Seq_missing/"),
+                 std::runtime_error);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../include/fenwick_tree.hpp"
+
+class FenwickTreeTest : public ::testing::Test
+{
+  protected:
+    FenwickTree *tree;
+
+  protected:
+    FenwickTreeTest() {}
+
+    void SetUp() { tree = new FenwickTree({3, 0, 5, 1, 0, 0, 2}); }
+
+    void TearDown() { delete tree; }
+};
+
+TEST_F(FenwickTreeTest, Empty)
+{
+    FenwickTree empty;
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_EQ(empty.total(), 0);
+    unsigned long long target = 0;
+    ASSERT_THROW(empty.find(target), std::out_of_range);
+    ASSERT_THROW(empty.add(0, 1), std::out_of_range);
+}
+
+TEST_F(FenwickTreeTest, Total)
+{
+    ASSERT_EQ(tree->size(), 7);
+    ASSERT_EQ(tree->total(), 11);
+}
+
+/*! Every target must land on the index whose weight covers it, and come back
+ * reduced to its offset inside that weight.
+ */
+TEST_F(FenwickTreeTest, Find)
+{
+    std::vector<uint> expected = {0, 0, 0, 2, 2, 2, 2, 2, 3, 6, 6};
+    for (uint value = 0; value < expected.size(); value++)
+    {
+        unsigned long long target = value;
+        ASSERT_EQ(tree->find(target), expected[value]);
+        ASSERT_LT(target, 5);
+    }
+
+    unsigned long long target = 9;
+    tree->find(target);
+    ASSERT_EQ(target, 0);
+
+    target = 11;
+    ASSERT_THROW(tree->find(target), std::out_of_range);
+}
+
+TEST_F(FenwickTreeTest, Add)
+{
+    tree->add(2, -5);
+    tree->add(4, 4);
+    ASSERT_EQ(tree->total(), 10);
+
+    std::vector<uint> expected = {0, 0, 0, 3, 4, 4, 4, 4, 6, 6};
+    for (uint value = 0; value < expected.size(); value++)
+    {
+        unsigned long long target = value;
+        ASSERT_EQ(tree->find(target), expected[value]);
+    }
+    ASSERT_THROW(tree->add(7, 1), std::out_of_range);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
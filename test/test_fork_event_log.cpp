@@ -0,0 +1,291 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include "../include/fork_event_log.hpp"
+#include "../include/fork_manager.hpp"
+#include "../include/util.hpp"
+
+class TestingProvider : public DataProvider
+{
+  private:
+    int size;
+    std::vector<std::string> codes;
+    std::vector<double> prob_landscape;
+    std::vector<transcription_region_t> transcription_regions;
+    std::vector<constitutive_origin_t> cons_origins;
+
+  public:
+    TestingProvider(uint size) : size(size)
+    {
+        prob_landscape.resize(size, (double)1 / (size + 1));
+
+        transcription_region_t reg;
+        reg.start = size / 2;
+        reg.end   = size - 1;
+
+        transcription_region_t reg2;
+        reg2.start = size / 3;
+        reg2.end   = 0;
+
+        transcription_regions.push_back(reg);
+        transcription_regions.push_back(reg2);
+    }
+
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
+    {
+        codes.assign(1, code);
+        return 0;
+    }
+
+    int get_length(uint id) { return size; }
+
+    const std::vector<double> &get_probability_landscape(uint id)
+    {
+        return prob_landscape;
+    }
+
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
+    {
+        return std::make_shared<std::vector<transcription_region_t>>(
+            transcription_regions);
+    }
+
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
+    {
+        return std::make_shared<std::vector<constitutive_origin_t>>(
+            cons_origins);
+    }
+};
+
+class ForkEventLogTest : public ::testing::Test
+{
+  protected:
+    std::string path = "test_fork_event_log.events";
+    std::shared_ptr<Genome> gen;
+    std::shared_ptr<ForkManager> manager;
+    std::shared_ptr<ForkEventLog> log;
+    RandomGenerator *rand_generator;
+    uint speed;
+
+  protected:
+    ForkEventLogTest() {}
+
+    void SetUp() { rand_generator = new RandomGenerator(1); }
+
+    void TearDown()
+    {
+        std::remove(path.c_str());
+        delete rand_generator;
+    }
+
+    void create_manager(uint size, uint n_forks, uint speed)
+    {
+        this->speed = speed;
+        std::vector<std::shared_ptr<Chromosome>> chrms(1);
+        std::shared_ptr<TestingProvider> provider(new TestingProvider(size));
+        chrms[0] = std::make_shared<Chromosome>("chr1", provider);
+        gen      = std::make_shared<Genome>(chrms, 7);
+        manager  = std::make_shared<ForkManager>(n_forks, gen, speed);
+        log      = std::make_shared<ForkEventLog>();
+        manager->set_event_log(log);
+    }
+
+    void fire(uint base, uint time)
+    {
+        GenomicLocation location(base, gen->chromosomes[0], rand_generator);
+        manager->attach_forks(location, time);
+    }
+
+    // Simulates the Chromosome step by step, firing random origins. When
+    // jump is set, the idle steps before each step are made in bulk.
+    void simulate(uint period, bool jump, uint timeout = 100000)
+    {
+        uint time = 0;
+        while (!gen->is_replicated() && time < timeout)
+        {
+            uint idle = jump ? manager->idle_steps(time, period, 5) : 0;
+            if (idle > 0)
+            {
+                manager->advance_attached_forks(time + 1, idle);
+                time += idle;
+            }
+
+            time++;
+            manager->advance_attached_forks(time);
+            if (period > 0)
+                manager->check_replication_transcription_conflicts(
+                    time, period, false);
+            for (int i = 0; i < 2 && !gen->is_replicated(); i++)
+            {
+                GenomicLocation location = gen->random_genomic_location();
+                if (!location.is_replicated())
+                    manager->attach_forks(location, time);
+            }
+        }
+        manager->log_attached_forks();
+    }
+
+    void write()
+    {
+        std::vector<fork_run_t> runs(log->get_runs().begin(),
+                                     log->get_runs().end());
+        ForkEventLog::write(path, "chr1", gen->chromosomes[0]->size(), speed,
+                            runs);
+    }
+
+    void expect_same_times()
+    {
+        Chromosome &chromosome = *gen->chromosomes[0];
+        ForkEventReader reader(path);
+        ASSERT_EQ(reader.get_code(), "chr1");
+        ASSERT_EQ(reader.get_length(), chromosome.size());
+
+        Strand strand  = reader.strand();
+        auto times     = reader.times(0, chromosome.size() - 1);
+        uint mid       = chromosome.size() / 2;
+        auto mid_times = reader.times(mid - 10, mid + 10);
+        for (uint base = 0; base < chromosome.size(); base++)
+        {
+            ASSERT_EQ(reader.time(base), chromosome[base]);
+            ASSERT_EQ(times[base], chromosome[base]);
+            ASSERT_EQ(strand[base], chromosome[base]);
+        }
+        for (uint base = mid - 10; base <= mid + 10; base++)
+            ASSERT_EQ(mid_times[base - mid + 10], chromosome[base]);
+    }
+};
+
+/*! Tests how the runs of the forks of an origin end.
+ */
+TEST_F(ForkEventLogTest, RunEnds)
+{
+    create_manager(1000, 4, 10);
+
+    // Two origins whose inner forks meet at the third step
+    fire(100, 1);
+    fire(130, 1);
+    manager->advance_attached_forks(2);
+    manager->advance_attached_forks(3);
+    ASSERT_EQ(log->get_runs().size(), 2);
+    for (auto run : log->get_runs())
+    {
+        ASSERT_EQ(run.end, FORK_RUN_MET);
+        ASSERT_EQ(run.start_time, 1);
+    }
+    ASSERT_EQ(log->get_runs()[0].origin, 100);
+    ASSERT_EQ(log->get_runs()[0].last, 119);
+    ASSERT_EQ(log->get_runs()[1].origin, 130);
+    ASSERT_EQ(log->get_runs()[1].last, 120);
+
+    // The outer forks go on, the left one up to the end of the Chromosome
+    for (int time = 4; time <= 12; time++)
+        manager->advance_attached_forks(time);
+    ASSERT_EQ(log->get_runs().size(), 3);
+    ASSERT_EQ(log->get_runs()[2].origin, 100);
+    ASSERT_EQ(log->get_runs()[2].last, 0);
+    ASSERT_EQ(log->get_runs()[2].end, FORK_RUN_END);
+
+    manager->log_attached_forks();
+    ASSERT_EQ(log->get_runs().size(), 4);
+    ASSERT_EQ(log->get_runs()[3].origin, 130);
+    ASSERT_EQ(log->get_runs()[3].last, 240);
+    ASSERT_EQ(log->get_runs()[3].end, FORK_RUN_ATTACHED);
+
+    manager->reset();
+    ASSERT_EQ(log->get_runs().size(), 0);
+}
+
+/*! Tests the runs of forks stopped by head-to-head RNAPs.
+ */
+TEST_F(ForkEventLogTest, Collisions)
+{
+    create_manager(3000, 2, 15);
+    fire(900, 10);
+    ASSERT_EQ(
+        manager->check_replication_transcription_conflicts(100, 1000, false),
+        1);
+    ASSERT_EQ(log->get_runs().size(), 1);
+    ASSERT_EQ(log->get_runs()[0].origin, 900);
+    ASSERT_EQ(log->get_runs()[0].last, 900);
+    ASSERT_EQ(log->get_runs()[0].direction, 1);
+    ASSERT_EQ(log->get_runs()[0].end, FORK_RUN_COLLISION);
+}
+
+/*! Tests if the times rebuilt from the runs are the simulated ones, with
+ * collisions and forks moved one step at a time.
+ */
+TEST_F(ForkEventLogTest, RebuildSteps)
+{
+    create_manager(5000, 8, 7);
+    simulate(97, false);
+    ASSERT_TRUE(gen->is_replicated());
+    write();
+    expect_same_times();
+}
+
+/*! Tests if the times rebuilt from the runs are the simulated ones when the
+ * forks are moved several steps at once.
+ */
+TEST_F(ForkEventLogTest, RebuildJumps)
+{
+    create_manager(5000, 6, 13);
+    simulate(0, true);
+    ASSERT_TRUE(gen->is_replicated());
+    write();
+    expect_same_times();
+}
+
+/*! Tests if the unreplicated bases of a cell that timed out are rebuilt.
+ */
+TEST_F(ForkEventLogTest, RebuildTimeout)
+{
+    create_manager(5000, 4, 5);
+    simulate(0, false, 40);
+    ASSERT_FALSE(gen->is_replicated());
+    write();
+    expect_same_times();
+}
+
+/*! Tests if files that are not fork event files are rejected.
+ */
+TEST_F(ForkEventLogTest, InvalidFile)
+{
+    ASSERT_THROW(ForkEventReader("no_such_file.events"), std::runtime_error);
+
+    std::ofstream text(path);
+    text << "-1x300\n";
+    text.close();
+    ASSERT_THROW(ForkEventReader reader(path), std::runtime_error);
+
+    text.open(path);
+    text << "# chr1 100 5\n"
+         << "10\t1\t3\t120\tM\n";
+    text.close();
+    ASSERT_THROW(ForkEventReader reader(path), std::runtime_error);
+
+    text.open(path);
+    text << "# chr1 100 5\n"
+         << "10\t1\t3\t20\tM\n";
+    text.close();
+    ForkEventReader reader(path);
+    ASSERT_THROW(reader.time(100), std::out_of_range);
+    ASSERT_EQ(reader.time(9), -1);
+    ASSERT_EQ(reader.time(10), 3);
+    ASSERT_EQ(reader.time(15), 4);
+    ASSERT_EQ(reader.time(16), 5);
+    ASSERT_EQ(reader.time(20), 5);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
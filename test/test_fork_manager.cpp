@@ -9,6 +9,7 @@ class TestingProvider : public DataProvider
 {
   private:
     int size;
+    std::vector<std::string> codes;
     std::vector<double> prob_landscape;
     std::vector<transcription_region_t> transcription_regions;
     std::vector<constitutive_origin_t> cons_origins;
@@ -34,28 +35,31 @@ class TestingProvider : public DataProvider
         cons_origins.push_back(origin);
     }
 
-    const std::vector<std::string> &get_codes()
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
     {
-        std::vector<std::string> codes;
-        return codes;
+        codes.assign(1, code);
+        return 0;
     }
 
-    int get_length(std::string code) { return size; }
+    int get_length(uint id) { return size; }
 
-    const std::vector<double> &get_probability_landscape(std::string code)
+    const std::vector<double> &get_probability_landscape(uint id)
     {
         return prob_landscape;
     }
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code)
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
     {
         return std::make_shared<std::vector<transcription_region_t>>(
             transcription_regions);
     }
 
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code)
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
     {
         return std::make_shared<std::vector<constitutive_origin_t>>(
             cons_origins);
@@ -67,7 +71,7 @@ class ForkManagerTest : public ::testing::Test
   protected:
     std::shared_ptr<ForkManager> manager;
     std::shared_ptr<Genome> gen;
-    std::mt19937 *rand_generator;
+    RandomGenerator *rand_generator;
 
   protected:
     ForkManagerTest() {}
@@ -78,7 +82,7 @@ class ForkManagerTest : public ::testing::Test
         chrms[0] = create_chromosome(3000, "2");
         gen      = std::make_shared<Genome>(chrms);
         manager  = std::make_shared<ForkManager>(3, gen, 15);
-        rand_generator = new std::mt19937(1);
+        rand_generator = new RandomGenerator(1);
     }
 
     void TearDown() {
@@ -101,8 +105,8 @@ TEST_F(ForkManagerTest, CheckConflicts)
     ASSERT_EQ(
         manager->check_replication_transcription_conflicts(1400, 1000, true),
         1);
-    ASSERT_TRUE(manager->replication_forks[0]->is_attached());
-    ASSERT_FALSE(manager->replication_forks[1]->is_attached());
+    ASSERT_TRUE(manager->get_fork(0).is_attached());
+    ASSERT_FALSE(manager->get_fork(1).is_attached());
 }
 
 TEST_F(ForkManagerTest, CheckConflictsReversed)
@@ -112,35 +116,66 @@ TEST_F(ForkManagerTest, CheckConflictsReversed)
     ASSERT_EQ(
         manager->check_replication_transcription_conflicts(140, 100, true),
         1);
-    ASSERT_FALSE(manager->replication_forks[0]->is_attached());
-    ASSERT_TRUE(manager->replication_forks[1]->is_attached());
+    ASSERT_FALSE(manager->get_fork(0).is_attached());
+    ASSERT_TRUE(manager->get_fork(1).is_attached());
 }
 
 TEST_F(ForkManagerTest, AdvanceAttachedForks)
 {
     GenomicLocation loc(1800, gen->chromosomes[0], rand_generator);
     manager->attach_forks(loc, 10);
-    manager->replication_forks[2]->set_just_detached(true);
+    manager->get_fork(2).set_just_detached(true);
     manager->advance_attached_forks(12);
-    ASSERT_FALSE(manager->replication_forks[2]->get_just_detached());
-    ASSERT_TRUE(manager->replication_forks[0]->is_attached());
-    ASSERT_TRUE(manager->replication_forks[1]->is_attached());
-    ASSERT_EQ(manager->replication_forks[0]->get_base(), 1815);
-    ASSERT_EQ(manager->replication_forks[1]->get_base(), 1785);
+    ASSERT_FALSE(manager->get_fork(2).get_just_detached());
+    ASSERT_TRUE(manager->get_fork(0).is_attached());
+    ASSERT_TRUE(manager->get_fork(1).is_attached());
+    ASSERT_EQ(manager->get_fork(0).get_base(), 1815);
+    ASSERT_EQ(manager->get_fork(1).get_base(), 1785);
 }
 
 TEST_F(ForkManagerTest, AttachForks)
 {
     GenomicLocation loc(1800, gen->chromosomes[0], rand_generator);
     manager->attach_forks(loc, 10);
-    ASSERT_TRUE(manager->replication_forks[0]->is_attached());
-    ASSERT_TRUE(manager->replication_forks[1]->is_attached());
-    ASSERT_FALSE(manager->replication_forks[2]->is_attached());
-    ASSERT_EQ(manager->replication_forks[0]->get_base(), 1800);
-    ASSERT_EQ(manager->replication_forks[1]->get_base(), 1800);
+    ASSERT_TRUE(manager->get_fork(0).is_attached());
+    ASSERT_TRUE(manager->get_fork(1).is_attached());
+    ASSERT_FALSE(manager->get_fork(2).is_attached());
+    ASSERT_EQ(manager->get_fork(0).get_base(), 1800);
+    ASSERT_EQ(manager->get_fork(1).get_base(), 1800);
     ASSERT_EQ(gen->chromosomes[0]->get_n_replicated_bases(), 1);
 }
 
+/*! The left fork meets the head of the RNAP carousel of the first
+ * transcription region at step 50, so 49 steps are idle.
+ */
+TEST_F(ForkManagerTest, IdleSteps)
+{
+    GenomicLocation loc(1800, gen->chromosomes[0], rand_generator);
+    manager->attach_forks(loc, 0);
+    ASSERT_EQ(manager->get_fork(0).idle_steps(0, 1000, 1000), 79);
+    ASSERT_EQ(manager->get_fork(1).idle_steps(0, 1000, 1000), 49);
+    ASSERT_EQ(manager->idle_steps(0, 1000, 1000), 49);
+    ASSERT_EQ(manager->idle_steps(0, 1000, 10), 10);
+
+    manager->advance_attached_forks(1, 49);
+    ASSERT_EQ(manager->get_fork(0).get_base(), 2535);
+    ASSERT_EQ(manager->get_fork(1).get_base(), 1065);
+    ASSERT_EQ(gen->chromosomes[0]->get_n_replicated_bases(), 1471);
+    ASSERT_EQ(manager->check_replication_transcription_conflicts(49, 1000, true),
+              0);
+    manager->advance_attached_forks(50);
+    ASSERT_EQ(manager->check_replication_transcription_conflicts(50, 1000, true),
+              1);
+}
+
+TEST_F(ForkManagerTest, IdleStepsJustDetached)
+{
+    GenomicLocation loc(1800, gen->chromosomes[0], rand_generator);
+    manager->attach_forks(loc, 0);
+    manager->get_fork(2).set_just_detached(true);
+    ASSERT_EQ(manager->idle_steps(0, 0, 1000), 0);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,104 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+
+#include "../include/gap_index.hpp"
+
+class GapIndexTest : public ::testing::Test
+{
+  protected:
+    GapIndex *index;
+
+  protected:
+    GapIndexTest() {}
+
+    void SetUp() { index = new GapIndex(100); }
+
+    void TearDown() { delete index; }
+};
+
+TEST_F(GapIndexTest, Empty)
+{
+    GapIndex empty;
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_EQ(empty.total(), 0);
+    ASSERT_THROW(empty.find(0), std::out_of_range);
+}
+
+TEST_F(GapIndexTest, Whole)
+{
+    ASSERT_EQ(index->size(), 1);
+    ASSERT_EQ(index->total(), 100);
+    for (uint rank = 0; rank < 100; rank++)
+        ASSERT_EQ(index->find(rank), rank);
+    ASSERT_THROW(index->find(100), std::out_of_range);
+}
+
+TEST_F(GapIndexTest, Remove)
+{
+    index->remove(40, 49);
+    index->remove(0, 9);
+    index->remove(90, 99);
+    std::vector<std::pair<uint, uint>> expected = {{10, 39}, {50, 89}};
+    ASSERT_EQ(index->get_gaps(), expected);
+    ASSERT_EQ(index->total(), 70);
+    ASSERT_EQ(index->find(0), 10);
+    ASSERT_EQ(index->find(29), 39);
+    ASSERT_EQ(index->find(30), 50);
+    ASSERT_EQ(index->find(69), 89);
+
+    index->remove(10, 39);
+    ASSERT_EQ(index->size(), 1);
+    ASSERT_EQ(index->find(0), 50);
+
+    // Runs must be unreplicated
+    ASSERT_THROW(index->remove(45, 55), std::out_of_range);
+    ASSERT_THROW(index->remove(85, 95), std::out_of_range);
+}
+
+TEST_F(GapIndexTest, FromGaps)
+{
+    std::vector<std::pair<uint, uint>> gaps = {{3, 5}, {8, 8}, {20, 29}};
+    GapIndex from_gaps(gaps);
+    ASSERT_EQ(from_gaps.get_gaps(), gaps);
+    ASSERT_EQ(from_gaps.total(), 14);
+    ASSERT_EQ(from_gaps.find(3), 8);
+    ASSERT_EQ(from_gaps.find(4), 20);
+}
+
+/*! Replicates random runs, the way forks do, and compares the index with a
+ * plain list of bases.
+ */
+TEST_F(GapIndexTest, RandomRuns)
+{
+    const uint length = 5000;
+    GapIndex gaps(length);
+    std::vector<bool> replicated(length, false);
+    std::mt19937 generator(7);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        uint base = generator() % length;
+        if (replicated[base]) continue;
+        uint last = base;
+        while (last + 1 < length && !replicated[last + 1] &&
+               last - base < generator() % 20)
+            last++;
+        gaps.remove(base, last);
+        for (uint curr = base; curr <= last; curr++)
+            replicated[curr] = true;
+    }
+
+    std::vector<uint> unreplicated;
+    for (uint base = 0; base < length; base++)
+        if (!replicated[base]) unreplicated.push_back(base);
+    ASSERT_EQ(gaps.total(), unreplicated.size());
+    for (uint rank = 0; rank < unreplicated.size(); rank++)
+        ASSERT_EQ(gaps.find(rank), unreplicated[rank]);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,22 +1,44 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
 #include "../include/chromosome.hpp"
 #include "../include/genome.hpp"
 #include "../include/util.hpp"
 
+// Counts every allocation of the test program
+static std::atomic<unsigned long long> n_allocations(0);
+
+void *operator new(size_t size)
+{
+    n_allocations++;
+    void *block = std::malloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete(void *block, size_t) noexcept { std::free(block); }
+
 class TestingProvider : public DataProvider
 {
   private:
     int size;
+    std::vector<std::string> codes;
     std::vector<double> prob_landscape;
     std::vector<transcription_region_t> transcription_regions;
     std::vector<constitutive_origin_t> cons_origins;
 
   public:
-    TestingProvider(uint size) : size(size)
+    TestingProvider(uint size) : TestingProvider(size, (double)1 / (size + 1))
+    {
+    }
+
+    TestingProvider(uint size, double probability) : size(size)
     {
-        prob_landscape.resize(size, (double)1 / (size + 1));
+        prob_landscape.resize(size, probability);
 
         transcription_region_t reg;
         reg.start = 0;
@@ -29,28 +51,31 @@ class TestingProvider : public DataProvider
         cons_origins.resize(size / 3, origin);
     }
 
-    const std::vector<std::string> &get_codes()
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
     {
-        std::vector<std::string> codes;
-        return codes;
+        codes.assign(1, code);
+        return 0;
     }
 
-    int get_length(std::string code) { return size; }
+    int get_length(uint id) { return size; }
 
-    const std::vector<double> &get_probability_landscape(std::string code)
+    const std::vector<double> &get_probability_landscape(uint id)
     {
         return prob_landscape;
     }
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code)
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
     {
         return std::make_shared<std::vector<transcription_region_t>>(
             transcription_regions);
     }
 
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code)
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
     {
         return std::make_shared<std::vector<constitutive_origin_t>>(
             cons_origins);
@@ -88,20 +113,118 @@ class GenomeTest : public ::testing::Test
 
 TEST_F(GenomeTest, Size) { ASSERT_EQ(200 * 300, gen->size()); }
 
+TEST_F(GenomeTest, ChromosomeIds)
+{
+    // Each Chromosome keeps its id in its own provider
+    for (uint index = 0; index < gen->chromosomes.size(); index++)
+    {
+        ASSERT_EQ(gen->chromosomes[index]->get_index(), index);
+        ASSERT_EQ(gen->chromosomes[index]->get_id(), 0);
+        ASSERT_EQ(gen->chromosomes[index]->get_code(), std::to_string(index));
+    }
+}
+
 TEST_F(GenomeTest, RandomGenomicLocation)
 {
     for (int i = 0; i < 50; i++)
     {
-        GenomicLocation loc = *gen->random_genomic_location();
+        GenomicLocation loc = gen->random_genomic_location();
         bool found          = false;
         for (auto chrm : gen->chromosomes)
         {
-            if (chrm == loc.chromosome) found = true;
+            if (chrm.get() == loc.chromosome) found = true;
         }
         ASSERT_TRUE(found);
     }
 }
 
+TEST_F(GenomeTest, RandomCandidates)
+{
+    candidate_batch_t batch;
+    std::vector<uint> hits(gen->chromosomes.size(), 0);
+    for (int round = 0; round < 20; round++)
+    {
+        gen->random_candidates(1000, batch);
+        ASSERT_EQ(batch.bases.size(), 1000);
+        for (uint i = 0; i < 1000; i++)
+        {
+            auto chromosome = gen->chromosomes.at(batch.chromosomes[i]);
+            ASSERT_LT(batch.bases[i], chromosome->size());
+            ASSERT_GE(batch.thresholds[i], 0);
+            ASSERT_LT(batch.thresholds[i], 1);
+            ASSERT_EQ(batch.probabilities[i],
+                      chromosome->activation_probability(batch.bases[i]));
+            ASSERT_EQ(batch.accepted[i],
+                      batch.thresholds[i] < batch.probabilities[i]);
+            hits[batch.chromosomes[i]]++;
+        }
+    }
+
+    // Equal sizes, so every Chromosome is drawn about 100 times
+    for (uint count : hits)
+    {
+        ASSERT_GT(count, 50);
+        ASSERT_LT(count, 150);
+    }
+}
+
+// Firing attempts must not allocate, whichever way they are drawn
+TEST_F(GenomeTest, AttemptsDoNotAllocate)
+{
+    candidate_batch_t batch;
+    gen->random_candidates(100, batch);
+
+    unsigned long long before = n_allocations;
+    unsigned long long fired  = 0;
+    for (int i = 0; i < 10000; i++)
+    {
+        GenomicLocation location = gen->random_genomic_location();
+        if (!location.is_replicated() && location.will_activate(false, 0))
+            fired++;
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        GenomicLocation location = gen->random_activation_candidate(false, 0);
+        location += 1;
+        fired += (location + 1).base > 0;
+    }
+    for (int i = 0; i < 100; i++)
+        gen->random_candidates(100, batch);
+    ASSERT_EQ(n_allocations, before);
+    ASSERT_GT(fired, 0);
+
+    gen->enable_gap_sampling();
+    before = n_allocations;
+    for (int i = 0; i < 100; i++)
+        gen->random_activation_candidate(false, 0);
+    ASSERT_EQ(n_allocations, before);
+
+    gen->enable_activation_sampling();
+    before = n_allocations;
+    for (int i = 0; i < 100; i++)
+        gen->random_activation_candidate(false, 0);
+    ASSERT_EQ(n_allocations, before);
+}
+
+// Without activation mass no attempt can succeed, whatever the sampler
+TEST_F(GenomeTest, RandomActivationCandidateWithoutMass)
+{
+    std::vector<std::shared_ptr<Chromosome>> chrms;
+    chrms.push_back(std::make_shared<Chromosome>(
+        "1", std::make_shared<TestingProvider>(300, 0)));
+    gen = std::make_shared<Genome>(chrms);
+
+    ASSERT_EQ(gen->activation_bound(false, 0), 0);
+    ASSERT_THROW(gen->random_activation_candidate(false, 0),
+                 std::runtime_error);
+    gen->enable_gap_sampling();
+    ASSERT_THROW(gen->random_activation_candidate(false, 0),
+                 std::runtime_error);
+    gen->enable_activation_sampling();
+    ASSERT_THROW(gen->random_activation_candidate(false, 0),
+                 std::runtime_error);
+}
+
 TEST_F(GenomeTest, RandomUnreplicatedGenomicLocation)
 {
     std::vector<std::shared_ptr<Chromosome>> chrms;
@@ -110,11 +233,11 @@ TEST_F(GenomeTest, RandomUnreplicatedGenomicLocation)
 
     gen->chromosomes[0]->replicate(1, 299, 1);
 
-    GenomicLocation loc = *gen->random_unreplicated_genomic_location();
+    GenomicLocation loc = gen->random_unreplicated_genomic_location();
     bool found          = false;
     for (auto chrm : gen->chromosomes)
     {
-        if (chrm == loc.chromosome) found = true;
+        if (chrm.get() == loc.chromosome) found = true;
     }
     ASSERT_EQ(loc.base, 0);
     ASSERT_TRUE(found);
@@ -128,11 +251,11 @@ TEST_F(GenomeTest, RandomUnreplicatedGenLoc)
 
     for (int i = 0; i < 50; i++)
     {
-        GenomicLocation loc = *gen->random_genomic_location();
+        GenomicLocation loc = gen->random_genomic_location();
         bool found          = false;
         for (auto chrm : gen->chromosomes)
         {
-            if (chrm == loc.chromosome) found = true;
+            if (chrm.get() == loc.chromosome) found = true;
         }
         ASSERT_TRUE(found);
         ASSERT_FALSE(loc.chromosome->is_replicated());
@@ -148,6 +271,17 @@ TEST_F(GenomeTest, IsReplicated)
         ASSERT_TRUE(chrm->is_replicated());
     }
     ASSERT_TRUE(gen->is_replicated());
+
+    // The count follows runs and resets
+    gen->reset(1);
+    ASSERT_FALSE(gen->is_replicated());
+    for (auto chrm : gen->chromosomes)
+    {
+        chrm->replicate(0, 0, 1);
+        chrm->replicate_run(0, 1, 100, 2, 2);
+        chrm->replicate(299, 200, 3);
+    }
+    ASSERT_TRUE(gen->is_replicated());
 }
 
 TEST_F(GenomeTest, AverageInterOriginDistance)
@@ -0,0 +1,157 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+#include "../include/data_manager.hpp"
+#include "../include/genome_cache.hpp"
+
+class GenomeCacheTest : public ::testing::Test
+{
+  protected:
+    std::string cache_dir  = "genome_cache_test";
+    std::string cache_path = cache_dir + "/dummy_0.cache";
+    std::shared_ptr<DataManager> data;
+
+  protected:
+    GenomeCacheTest() {}
+
+    void SetUp()
+    {
+        std::filesystem::remove_all(cache_dir);
+        data = std::make_shared<DataManager>("dummy", "../data/database.sqlite",
+                                             "../data/MFA-Seq_dummy/");
+    }
+
+    void TearDown() { std::filesystem::remove_all(cache_dir); }
+
+    unsigned long long dummy_hash()
+    {
+        return GenomeCache::source_hash("dummy", "../data/database.sqlite",
+                                        "../data/MFA-Seq_dummy/",
+                                        data->get_codes());
+    }
+};
+
+/*! Tests if a written cache gives back the data of the provider.
+ */
+TEST_F(GenomeCacheTest, WriteAndRead)
+{
+    std::filesystem::create_directories(cache_dir);
+    GenomeCache::write(cache_path, dummy_hash(), 0, *data);
+
+    GenomeCache cache(cache_path);
+    ASSERT_EQ(cache.get_source_hash(), dummy_hash());
+    ASSERT_EQ(cache.get_uniform(), 0);
+    ASSERT_EQ(cache.get_codes(), data->get_codes());
+
+    for (auto code : data->get_codes())
+    {
+        ASSERT_EQ(cache.get_length(code), data->get_length(code));
+
+        auto &expected_landscape = data->get_probability_landscape(code);
+        landscape_view_t landscape = cache.get_landscape(code);
+        ASSERT_EQ(landscape.size, expected_landscape.size());
+        for (uint base = 0; base < landscape.size; base++)
+            ASSERT_EQ(landscape.data[base], expected_landscape[base]);
+
+        auto regions          = cache.get_transcription_regions(code);
+        auto expected_regions = data->get_transcription_regions(code);
+        ASSERT_EQ(regions.size(), expected_regions->size());
+        for (uint i = 0; i < regions.size(); i++)
+        {
+            ASSERT_EQ(regions[i].start, (*expected_regions)[i].start);
+            ASSERT_EQ(regions[i].end, (*expected_regions)[i].end);
+        }
+
+        ASSERT_EQ(cache.get_constitutive_origins(code),
+                  *data->get_constitutive_origins(code));
+    }
+
+    ASSERT_THROW(cache.get_length("no_such_code"), std::out_of_range);
+}
+
+/*! Tests if the hash changes with the content of the MFA-Seq files.
+ */
+TEST_F(GenomeCacheTest, SourceHash)
+{
+    std::filesystem::create_directories(cache_dir + "/mfa");
+    std::filesystem::copy_file("../data/MFA-Seq_dummy/dummy_01.txt",
+                               cache_dir + "/mfa/dummy_01.txt");
+    auto hash = [&] {
+        return GenomeCache::source_hash("dummy", "../data/database.sqlite",
+                                        cache_dir + "/mfa/", {"dummy_01"});
+    };
+
+    ASSERT_EQ(hash(), dummy_hash());
+
+    std::ofstream file(cache_dir + "/mfa/dummy_01.txt", std::ios::app);
+    file << "1.0\n";
+    file.close();
+    ASSERT_NE(hash(), dummy_hash());
+
+    std::filesystem::remove(cache_dir + "/mfa/dummy_01.txt");
+    ASSERT_THROW(hash(), std::runtime_error);
+}
+
+/*! Tests if files that are not genome caches are rejected.
+ */
+TEST_F(GenomeCacheTest, InvalidFile)
+{
+    ASSERT_THROW(GenomeCache("no_such_file.cache"), std::runtime_error);
+
+    std::filesystem::create_directories(cache_dir);
+    std::ofstream file(cache_path);
+    file << "not a cache, but long enough to hold a header";
+    file.close();
+    ASSERT_THROW(GenomeCache cache(cache_path), std::runtime_error);
+
+    // A valid cache cut short
+    GenomeCache::write(cache_path, dummy_hash(), 0, *data);
+    std::filesystem::resize_file(cache_path,
+                                 std::filesystem::file_size(cache_path) - 16);
+    ASSERT_THROW(GenomeCache cache(cache_path), std::runtime_error);
+}
+
+/*! Tests if a DataManager writes the cache, then reads the same data from it.
+ */
+TEST_F(GenomeCacheTest, DataManagerUsesCache)
+{
+    DataManager first("dummy", "../data/database.sqlite",
+                      "../data/MFA-Seq_dummy/", 0, cache_dir);
+    ASSERT_TRUE(std::filesystem::exists(cache_path));
+
+    DataManager second("dummy", "../data/database.sqlite",
+                       "../data/MFA-Seq_dummy/", 0, cache_dir);
+    ASSERT_EQ(second.get_codes(), data->get_codes());
+    ASSERT_EQ(second.get_length("dummy_01"), data->get_length("dummy_01"));
+    ASSERT_EQ(second.get_probability_landscape("dummy_01"),
+              data->get_probability_landscape("dummy_01"));
+    ASSERT_EQ(second.get_landscape_view("dummy_01").size,
+              data->get_probability_landscape("dummy_01").size());
+    // The landscape is read from the mapped file, not from a vector
+    ASSERT_NE(second.get_landscape_view("dummy_01").data,
+              second.get_probability_landscape("dummy_01").data());
+    ASSERT_EQ(second.get_transcription_regions("dummy_01")->size(),
+              data->get_transcription_regions("dummy_01")->size());
+    ASSERT_EQ(*second.get_constitutive_origins("dummy_01"),
+              *data->get_constitutive_origins("dummy_01"));
+
+    // A different probability has its own cache
+    DataManager uniform("dummy", "../data/database.sqlite",
+                        "../data/MFA-Seq_dummy/", 0.5, cache_dir);
+    ASSERT_TRUE(std::filesystem::exists(cache_dir + "/dummy_0.5.cache"));
+    ASSERT_EQ(uniform.get_landscape_view("dummy_01").data[0], 0.5);
+
+    // Even if it only differs after the sixth decimal
+    DataManager close("dummy", "../data/database.sqlite",
+                      "../data/MFA-Seq_dummy/", 0.5000001, cache_dir);
+    ASSERT_TRUE(std::filesystem::exists(cache_dir + "/dummy_0.5000001.cache"));
+    ASSERT_EQ(close.get_landscape_view("dummy_01").data[0], 0.5000001);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
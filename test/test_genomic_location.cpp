@@ -9,6 +9,7 @@ class TestingProvider : public DataProvider
 {
   private:
     int size;
+    std::vector<std::string> codes;
     std::vector<double> prob_landscape;
     std::vector<transcription_region_t> transcription_regions;
     std::vector<constitutive_origin_t> cons_origins;
@@ -29,28 +30,31 @@ class TestingProvider : public DataProvider
         cons_origins.resize(1, origin);
     }
 
-    const std::vector<std::string> &get_codes()
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
     {
-        std::vector<std::string> codes;
-        return codes;
+        codes.assign(1, code);
+        return 0;
     }
 
-    int get_length(std::string code) { return size; }
+    int get_length(uint id) { return size; }
 
-    const std::vector<double> &get_probability_landscape(std::string code)
+    const std::vector<double> &get_probability_landscape(uint id)
     {
         return prob_landscape;
     }
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code)
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
     {
         return std::make_shared<std::vector<transcription_region_t>>(
             transcription_regions);
     }
 
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code)
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
     {
         return std::make_shared<std::vector<constitutive_origin_t>>(
             cons_origins);
@@ -61,16 +65,19 @@ class GenomicLocationTest : public ::testing::Test
 {
   protected:
     std::shared_ptr<GenomicLocation> gen_loc;
-    std::mt19937 *rand_generator;
+    // Locations do not keep their Chromosome alive
+    std::shared_ptr<Chromosome> gen_loc_chromosome;
+    RandomGenerator *rand_generator;
 
   protected:
     GenomicLocationTest() {}
     void SetUp()
     {
-        std::shared_ptr<Chromosome> chrm = create_chromosome();
-        uint base                        = rand() % chrm->size();
-        rand_generator                   = new std::mt19937(1);
-        gen_loc = std::make_shared<GenomicLocation>(base, chrm, rand_generator);
+        gen_loc_chromosome = create_chromosome();
+        uint base          = rand() % gen_loc_chromosome->size();
+        rand_generator     = new RandomGenerator(1);
+        gen_loc            = std::make_shared<GenomicLocation>(
+            base, gen_loc_chromosome, rand_generator);
     }
 
     std::shared_ptr<Chromosome> create_chromosome(uint size      = 300,
@@ -0,0 +1,127 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+#include "../include/output_analysis.hpp"
+#include "../include/output_reader.hpp"
+
+class OutputAnalysisTest : public ::testing::Test
+{
+  protected:
+    std::string run = "test_output_analysis_run";
+
+  protected:
+    OutputAnalysisTest() {}
+
+    std::vector<uint> distances(std::string fixture)
+    {
+        std::vector<uint> distances;
+        collision_distances(
+            read_replication_times("../test/expected_outputs/" + fixture),
+            distances);
+        return distances;
+    }
+
+    void write_cell(std::string simulation, std::string line)
+    {
+        std::filesystem::create_directories(run + "/" + simulation);
+        std::ofstream cell(run + "/" + simulation + "/cell.txt");
+        cell << line;
+    }
+
+    void TearDown() { std::filesystem::remove_all(run); }
+};
+
+/*! Tests the streaks found in the fixtures, which are the ones
+ * script/collision_distance_median_parallel.py finds.
+ */
+TEST_F(OutputAnalysisTest, FixtureStreaks)
+{
+    ASSERT_EQ(distances("dummy01_times_with_transcription.txt"),
+              std::vector<uint>({3, 8}));
+    ASSERT_EQ(distances("dummy01_times_dormant_with_transcription.txt"),
+              std::vector<uint>({3}));
+    ASSERT_EQ(distances("dummy01_times_without_transcription.txt").size(), 0);
+    ASSERT_EQ(distances("dummy01_times_dormant_without_transcription.txt")
+                  .size(),
+              0);
+    ASSERT_EQ(
+        distances("dummy01_times_constitutive_with_transcription.txt").size(),
+        0);
+    ASSERT_EQ(distances("dummy01_times_constitutive_without_transcription.txt")
+                  .size(),
+              0);
+
+    std::vector<uint> all = distances("dummy01_times_with_transcription.txt");
+    for (uint distance :
+         distances("dummy01_times_dormant_with_transcription.txt"))
+        all.push_back(distance);
+    ASSERT_EQ(to_string(distance_statistics(all)), "3.0\t4.7\t2.9");
+}
+
+/*! Tests the streaks of a single direction.
+ */
+TEST_F(OutputAnalysisTest, FindStreaks)
+{
+    // Origin at the fourth base, collision after the seventh
+    std::vector<int> times = {9, 8, 7, 6, 7, 8, 9, 20, 21};
+    std::vector<uint> found;
+    ASSERT_EQ(find_streaks(times, found), 1);
+    ASSERT_EQ(found, std::vector<uint>({3}));
+
+    // Too short to hold a streak
+    found.clear();
+    ASSERT_EQ(find_streaks(std::vector<int>({2, 1, 2}), found), 0);
+    ASSERT_EQ(found.size(), 0);
+}
+
+/*! Tests the statistics against the test sample of
+ * script/collision_distance_median_parallel.py.
+ */
+TEST_F(OutputAnalysisTest, DistanceStatistics)
+{
+    std::vector<uint> sample = {
+        49484,   321,    409688, 413369,  77859,   952621, 540744, 32172,
+        486870,  50200,  48955,  842453,  1128739, 1165905, 159539, 216615,
+        26772,   5048,   502345, 1541822, 822259,  2272213, 49721, 236036,
+        186926,  246734, 1137875, 379739, 17575,   28574,  181984};
+    ASSERT_EQ(to_string(distance_statistics(sample)),
+              "236036.0\t458424.4\t541215.9");
+
+    std::vector<uint> even = {3, 8, 3, 5};
+    ASSERT_EQ(to_string(distance_statistics(even)), "4.0\t4.8\t2.4");
+
+    std::vector<uint> none;
+    ASSERT_EQ(to_string(distance_statistics(none)), "0.0\t0.0\t0.0");
+}
+
+/*! Tests the aggregates against the output of
+ * script/cell_output_aggregator.py for the same cells.
+ */
+TEST_F(OutputAnalysisTest, AggregateCells)
+{
+    write_cell("simulation_0", "30\t65\t13150\t52341\t\n");
+    write_cell("simulation_1", "30\t65\t12903\t50877\t\n");
+    write_cell("simulation_2", "30\t65\t14011\t49990\t\n");
+    write_cell("simulation_3", "30\t65\t12777\t55012\t\n");
+    write_cell("simulation_4", "10\t20\t3000\t1020018\t\n");
+
+    std::vector<cell_record_t> cells;
+    for (auto folder : simulation_folders(run))
+        for (auto cell : read_cell_file(folder + "/cell.txt"))
+            cells.push_back(cell);
+
+    auto aggregates = aggregate_cells(cells);
+    ASSERT_EQ(aggregates.size(), 2);
+    ASSERT_EQ(to_string(aggregates[0]),
+              "30\t65\t13210.25\t555.86\t52055.00\t2196.78\t4");
+    ASSERT_EQ(to_string(aggregates[1]),
+              "10\t20\t3000.00\t0.00\t1020018.00\t0.00\t1");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include "../include/output_queue.hpp"
+
+/*! Tests if invalid sizes are rejected.
+ */
+TEST(OutputQueueTest, InvalidSizes)
+{
+    ASSERT_THROW(OutputQueue(0, 1), std::invalid_argument);
+    ASSERT_THROW(OutputQueue(1, 0), std::invalid_argument);
+}
+
+/*! Tests if every job runs once before close returns.
+ */
+TEST(OutputQueueTest, RunsAllJobs)
+{
+    std::atomic<int> sum(0);
+    OutputQueue queue(4, 3);
+    for (int i = 1; i <= 100; i++)
+        queue.push([&sum, i] { sum += i; });
+    queue.close();
+
+    ASSERT_EQ(sum, 5050);
+    ASSERT_THROW(queue.push([] {}), std::runtime_error);
+}
+
+/*! Tests if push waits while the queue is full.
+ */
+TEST(OutputQueueTest, Backpressure)
+{
+    std::atomic<bool> release(false);
+    std::atomic<int> pushed(0);
+    OutputQueue queue(1, 1);
+
+    // The writer takes the first job and stays busy, the second one fills
+    // the queue and the third one has to wait
+    std::thread producer([&] {
+        for (int i = 0; i < 3; i++)
+        {
+            queue.push([&] {
+                while (!release)
+                    std::this_thread::yield();
+            });
+            pushed++;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(pushed, 2);
+
+    release = true;
+    producer.join();
+    ASSERT_EQ(pushed, 3);
+    queue.close();
+}
+
+/*! Tests if an exception thrown by a job comes out of close.
+ */
+TEST(OutputQueueTest, JobError)
+{
+    std::atomic<int> done(0);
+    OutputQueue queue(2, 1);
+    queue.push([] { throw std::runtime_error("disk full"); });
+    queue.push([&done] { done++; });
+
+    ASSERT_THROW(queue.close(), std::runtime_error);
+    ASSERT_EQ(done, 1);
+    ASSERT_NO_THROW(queue.close());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "../include/fork_event_log.hpp"
+#include "../include/output_reader.hpp"
+#include "../include/timing_file.hpp"
+
+class OutputReaderTest : public ::testing::Test
+{
+  protected:
+    std::string folder = "test_output_reader_files";
+
+  protected:
+    OutputReaderTest() {}
+
+    void SetUp() { std::filesystem::create_directories(folder); }
+
+    void TearDown() { std::filesystem::remove_all(folder); }
+
+    void write_text(std::string name, std::string text)
+    {
+        std::ofstream file(folder + "/" + name);
+        file << text;
+    }
+
+    std::vector<int> parse(std::string text, bool cseq)
+    {
+        const char *begin = text.data();
+        return cseq ? parse_cseq(begin, begin + text.size())
+                    : parse_base_times(begin, begin + text.size());
+    }
+};
+
+/*! Tests the contents of mapped files.
+ */
+TEST_F(OutputReaderTest, MappedFile)
+{
+    write_text("text", "12\n34\n");
+    MappedFile file(folder + "/text");
+    ASSERT_EQ(file.size(), 6);
+    ASSERT_EQ(std::string(file.data(), file.size()), "12\n34\n");
+
+    write_text("empty", "");
+    MappedFile empty(folder + "/empty");
+    ASSERT_EQ(empty.size(), 0);
+
+    ASSERT_THROW(MappedFile(folder + "/no_such_file"), std::runtime_error);
+}
+
+/*! Tests the parsing of times written one per line and of .cseq records.
+ */
+TEST_F(OutputReaderTest, Parse)
+{
+    ASSERT_EQ(parse("3\n-1\r\n\n 7\n10", false),
+              std::vector<int>({3, -1, 7, 10}));
+    ASSERT_THROW(parse("3\n4x\n", false), std::runtime_error);
+
+    ASSERT_EQ(parse("-1x2\n1-3x2\n5\n7-6\n", true),
+              std::vector<int>({-1, -1, 1, 1, 2, 2, 3, 3, 5, 7, 6}));
+    ASSERT_THROW(parse("1-\n", true), std::runtime_error);
+    ASSERT_THROW(parse("1x0\n", true), std::runtime_error);
+}
+
+/*! Tests if every format the simulator writes is read back with the times
+ * of the Strand.
+ */
+TEST_F(OutputReaderTest, ReplicationTimes)
+{
+    // Two forks of an origin at 500 with speed 3, up to base 800 on the right
+    uint speed = 3;
+    Strand strand(1000);
+    strand.replicate(499, 1, 0, 10, 1);
+    strand.replicate(500, 1, speed, 10, 300);
+    strand.replicate(500, -1, speed, 10, 500);
+    std::vector<fork_run_t> runs = {{0, 500, 1, 10, 800, FORK_RUN_ATTACHED},
+                                    {0, 500, -1, 10, 0, FORK_RUN_END}};
+
+    std::vector<int> expected;
+    for (uint base = 0; base < strand.size(); base++)
+        expected.push_back(strand[base]);
+
+    std::ofstream text(folder + "/chr1.txt");
+    for (int time : expected)
+        text << time << "\n";
+    text.close();
+
+    std::ofstream cseq(folder + "/chr1.cseq");
+    compress_replication_times(strand, [&](const timing_record_t &record) {
+        cseq << to_string(record) << '\n';
+    });
+    cseq.close();
+
+    TimingFileWriter writer(folder + "/chr1.cseq.zst", "chr1", strand.size());
+    compress_replication_times(strand, [&](const timing_record_t &record) {
+        writer.write(record);
+    });
+    writer.close();
+
+    ForkEventLog::write(folder + "/chr1.events", "chr1", strand.size(), speed,
+                        runs);
+
+    write_text("cell.txt", "2\t3\t4\t5\t\n");
+
+    auto files = timing_files(folder);
+    ASSERT_EQ(files.size(), 4);
+    for (auto file : files)
+        ASSERT_EQ(read_replication_times(file), expected) << file;
+
+    ASSERT_THROW(read_replication_times(folder + "/cell.csv"),
+                 std::invalid_argument);
+}
+
+/*! Tests the reading of cell.txt files and the listing of a run.
+ */
+TEST_F(OutputReaderTest, Cells)
+{
+    std::filesystem::create_directories(folder + "/simulation_1");
+    std::filesystem::create_directories(folder + "/simulation_0");
+    write_text("simulation_0/cell.txt", "30\t65\t13150\t52341\t\n\n9\n");
+    write_text("simulation_1/cell.txt", "30\t65\tfast\t52341\t\n");
+    write_text("notes.txt", "not a simulation\n");
+
+    auto folders = simulation_folders(folder);
+    ASSERT_EQ(folders.size(), 2);
+    ASSERT_EQ(folders[0], folder + "/simulation_0");
+    ASSERT_EQ(folders[1], folder + "/simulation_1");
+
+    auto cells = read_cell_file(folders[0] + "/cell.txt");
+    ASSERT_EQ(cells.size(), 1);
+    ASSERT_EQ(cells[0].resources, 30);
+    ASSERT_EQ(cells[0].speed, 65);
+    ASSERT_EQ(cells[0].time, 13150);
+    ASSERT_EQ(cells[0].interorigin_distance, 52341);
+
+    ASSERT_THROW(read_cell_file(folders[1] + "/cell.txt"), std::runtime_error);
+}
+
+/*! Tests if every job runs once and errors reach the caller.
+ */
+TEST_F(OutputReaderTest, ParallelFor)
+{
+    std::vector<std::atomic<int>> runs(1000);
+    parallel_for(runs.size(), 4, [&](size_t i) { runs[i]++; });
+    for (auto &count : runs)
+        ASSERT_EQ(count, 1);
+
+    parallel_for(0, 4, [&](size_t i) { runs[i]++; });
+
+    ASSERT_THROW(parallel_for(100, 4,
+                              [](size_t i) {
+                                  if (i == 42)
+                                      throw std::runtime_error("Job 42");
+                              }),
+                 std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
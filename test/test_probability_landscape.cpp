@@ -0,0 +1,67 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../include/probability_landscape.hpp"
+
+class ProbabilityLandscapeTest : public ::testing::Test
+{
+  protected:
+    std::vector<double> shared_landscape;
+
+  protected:
+    ProbabilityLandscapeTest() {}
+
+    void SetUp()
+    {
+        // Three and a half pages
+        shared_landscape.resize(7 << (LANDSCAPE_PAGE_BITS - 1));
+        for (uint base = 0; base < shared_landscape.size(); base++)
+            shared_landscape[base] = (double)base / shared_landscape.size();
+    }
+
+    void TearDown() {}
+};
+
+TEST_F(ProbabilityLandscapeTest, ReadsSharedLandscape)
+{
+    ProbabilityLandscape landscape(shared_landscape);
+    ASSERT_EQ(landscape.size(), shared_landscape.size());
+    for (uint base = 0; base < shared_landscape.size(); base++)
+        ASSERT_EQ(landscape[base], shared_landscape[base]);
+    ASSERT_EQ(landscape.n_copied_pages(), 0);
+}
+
+TEST_F(ProbabilityLandscapeTest, SetCopiesOnlyTouchedPage)
+{
+    ProbabilityLandscape landscape(shared_landscape);
+    ProbabilityLandscape other(shared_landscape);
+    uint base = (1 << LANDSCAPE_PAGE_BITS) + 5;
+
+    landscape.set(base, 1);
+    ASSERT_EQ(landscape[base], 1);
+    ASSERT_EQ(landscape[base + 1], shared_landscape[base + 1]);
+    ASSERT_EQ(landscape[base - 6], shared_landscape[base - 6]);
+    ASSERT_EQ(landscape.n_copied_pages(), 1);
+
+    // Neither the shared landscape nor other views change
+    ASSERT_EQ(shared_landscape[base], (double)base / shared_landscape.size());
+    ASSERT_EQ(other[base], shared_landscape[base]);
+    ASSERT_EQ(other.n_copied_pages(), 0);
+}
+
+TEST_F(ProbabilityLandscapeTest, SetLastPartialPage)
+{
+    ProbabilityLandscape landscape(shared_landscape);
+    uint last = shared_landscape.size() - 1;
+
+    landscape.set(last, 0.5);
+    ASSERT_EQ(landscape[last], 0.5);
+    ASSERT_EQ(landscape[last - 1], shared_landscape[last - 1]);
+    ASSERT_EQ(landscape.n_copied_pages(), 1);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/quantile_sketch.hpp"
+
+TEST(QuantileSketchTest, Empty)
+{
+    QuantileSketch sketch;
+    ASSERT_EQ(sketch.count(), 0);
+    ASSERT_EQ(sketch.quantile(0.5), 0);
+    ASSERT_THROW(sketch.quantile(-0.1), std::invalid_argument);
+    ASSERT_THROW(sketch.quantile(1.1), std::invalid_argument);
+}
+
+/*! Tests if small values are kept exactly.
+ */
+TEST(QuantileSketchTest, SmallValues)
+{
+    QuantileSketch sketch;
+    for (unsigned long long value : {5, 1, 100, 7, 7})
+        sketch.add(value);
+    ASSERT_EQ(sketch.count(), 5);
+    ASSERT_EQ(sketch.quantile(0), 1);
+    ASSERT_EQ(sketch.quantile(0.5), 7);
+    ASSERT_EQ(sketch.quantile(1), 100);
+}
+
+/*! Tests the median of large values against the exact one.
+ */
+TEST(QuantileSketchTest, Median)
+{
+    std::mt19937 generator(5);
+    std::lognormal_distribution<double> distribution(10, 1);
+
+    for (int n : {1, 2, 11, 1000})
+    {
+        QuantileSketch sketch;
+        std::vector<unsigned long long> values;
+        for (int i = 0; i < n; i++)
+        {
+            values.push_back((unsigned long long)distribution(generator));
+            sketch.add(values.back());
+        }
+        std::sort(values.begin(), values.end());
+        double median = values[(n - 1) / 2];
+        ASSERT_NEAR(sketch.quantile(0.5), median, median / 64) << n;
+    }
+}
+
+/*! Tests if merging in any order gives the same sketch.
+ */
+TEST(QuantileSketchTest, Merge)
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<unsigned long long> distribution(0, 1 << 20);
+
+    QuantileSketch whole, first, second;
+    for (int i = 0; i < 500; i++)
+    {
+        unsigned long long value = distribution(generator);
+        whole.add(value);
+        (i % 3 ? first : second).add(value);
+    }
+
+    QuantileSketch forward = first, backward = second;
+    forward.merge(second);
+    backward.merge(first);
+    for (double q : {0.0, 0.1, 0.5, 0.9, 1.0})
+    {
+        ASSERT_EQ(forward.quantile(q), whole.quantile(q));
+        ASSERT_EQ(backward.quantile(q), whole.quantile(q));
+    }
+    ASSERT_EQ(forward.count(), 500);
+}
+
+/*! Tests if the buckets cover all values in order, each at most 1/64 of its
+ * values wide.
+ */
+TEST(QuantileSketchTest, Buckets)
+{
+    uint last = QuantileSketch::bucket(UINT64_MAX);
+    for (uint bucket = 1; bucket <= last; bucket++)
+    {
+        unsigned long long lower = QuantileSketch::bucket_lower_bound(bucket);
+        ASSERT_EQ(QuantileSketch::bucket(lower), bucket);
+        ASSERT_EQ(QuantileSketch::bucket(lower - 1), bucket - 1);
+        ASSERT_LE(lower - QuantileSketch::bucket_lower_bound(bucket - 1),
+                  lower / 64 + 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/random_generator.hpp"
+
+/*! Tests the Philox4x32-10 blocks against the known answers of Random123.
+ */
+TEST(RandomGeneratorTest, PhiloxKnownAnswers)
+{
+    uint32_t result[4];
+
+    uint32_t zero_counter[4] = {0, 0, 0, 0}, zero_key[2] = {0, 0};
+    RandomGenerator::philox(zero_counter, zero_key, result);
+    ASSERT_THAT(result, ::testing::ElementsAre(0x6627e8d5, 0xe169c58d,
+                                               0xbc57ac4c, 0x9b00dbd8));
+
+    uint32_t ones_counter[4] = {~0U, ~0U, ~0U, ~0U}, ones_key[2] = {~0U, ~0U};
+    RandomGenerator::philox(ones_counter, ones_key, result);
+    ASSERT_THAT(result, ::testing::ElementsAre(0x408f276d, 0x41c83b0e,
+                                               0xa20bc7c6, 0x6d5451fd));
+
+    uint32_t pi_counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    uint32_t pi_key[2]     = {0xa4093822, 0x299f31d0};
+    RandomGenerator::philox(pi_counter, pi_key, result);
+    ASSERT_THAT(result, ::testing::ElementsAre(0xd16cfe09, 0x94fdcceb,
+                                               0x5001e420, 0x24126ea1));
+}
+
+/*! Tests if the seeded generator is the Mersenne Twister, also through a
+ * distribution.
+ */
+TEST(RandomGeneratorTest, MatchesMersenneTwister)
+{
+    RandomGenerator generator(1234);
+    std::mt19937 twister(1234);
+    ASSERT_FALSE(generator.is_counter_based());
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(generator(), twister());
+
+    std::uniform_int_distribution<int> distribution(0, 999);
+    for (int i = 0; i < 10000; i++)
+        ASSERT_EQ(distribution(generator), distribution(twister));
+
+    generator.discard(12345);
+    twister.discard(12345);
+    ASSERT_EQ(generator(), twister());
+}
+
+/*! Tests if a counter based generator only depends on its coordinates.
+ */
+TEST(RandomGeneratorTest, CounterBasedStreams)
+{
+    auto draw = [](RandomGenerator generator) {
+        std::vector<RandomGenerator::result_type> numbers;
+        for (int i = 0; i < 64; i++)
+            numbers.push_back(generator());
+        return numbers;
+    };
+
+    RandomGenerator generator(7, 3, 2, 1);
+    ASSERT_TRUE(generator.is_counter_based());
+    auto numbers = draw(generator);
+    ASSERT_EQ(numbers, draw(RandomGenerator(7, 3, 2, 1)));
+
+    // Each coordinate gives another sequence
+    ASSERT_NE(numbers, draw(RandomGenerator(8, 3, 2, 1)));
+    ASSERT_NE(numbers, draw(RandomGenerator(7, 4, 2, 1)));
+    ASSERT_NE(numbers, draw(RandomGenerator(7, 3, 3, 1)));
+    ASSERT_NE(numbers, draw(RandomGenerator(7, 3, 2, 0)));
+
+    // The numbers are the words of consecutive blocks
+    uint32_t counter[4] = {1, 0, 3, 2 << 8 | 1}, key[2] = {7, 0}, block[4];
+    RandomGenerator::philox(counter, key, block);
+    for (int i = 0; i < 4; i++)
+        ASSERT_EQ(numbers[4 + i], block[i]);
+}
+
+/*! Tests if skipping numbers lands where drawing them would.
+ */
+TEST(RandomGeneratorTest, CounterBasedDiscard)
+{
+    for (unsigned long long skip : {0ULL, 1ULL, 3ULL, 4ULL, 1001ULL})
+    {
+        RandomGenerator drawn(11, 5, 0, RNG_STREAM_GENOME);
+        RandomGenerator jumped(11, 5, 0, RNG_STREAM_GENOME);
+
+        // Start in the middle of a block
+        drawn();
+        jumped();
+        for (unsigned long long i = 0; i < skip; i++)
+            drawn();
+        jumped.discard(skip);
+
+        for (int i = 0; i < 10; i++)
+            ASSERT_EQ(drawn(), jumped());
+    }
+
+    // Far jumps use the high word of the block counter
+    RandomGenerator far(11, 5, 0, RNG_STREAM_GENOME);
+    far.discard(4ULL << 32);
+    uint32_t counter[4] = {0, 1, 5, 0}, key[2] = {11, 0}, block[4];
+    RandomGenerator::philox(counter, key, block);
+    ASSERT_EQ(far(), block[0]);
+}
+
+/*! Tests if words are made of consecutive numbers, for both kinds of
+ * generator and from any position.
+ */
+TEST(RandomGeneratorTest, Fill)
+{
+    for (bool counter_based : {false, true})
+        for (int offset : {0, 1, 2, 3})
+        {
+            RandomGenerator drawn = counter_based
+                                        ? RandomGenerator(3, 1, 0, 0)
+                                        : RandomGenerator(3);
+            RandomGenerator filled = drawn;
+            drawn.discard(offset);
+            filled.discard(offset);
+
+            std::vector<uint64_t> words(9);
+            filled.fill(words.data(), words.size());
+            for (uint64_t word : words)
+            {
+                uint64_t high = drawn();
+                ASSERT_EQ(word, high << 32 | drawn());
+            }
+            ASSERT_EQ(filled(), drawn());
+        }
+}
+
+/*! Tests if copies draw the same numbers independently of the original,
+ * and if a generator does not carry the state of a Mersenne Twister.
+ */
+TEST(RandomGeneratorTest, Copies)
+{
+    ASSERT_LT(sizeof(RandomGenerator), sizeof(std::mt19937));
+
+    for (bool counter_based : {false, true})
+    {
+        RandomGenerator original = counter_based ? RandomGenerator(5, 2, 0, 0)
+                                                 : RandomGenerator(5);
+        original.discard(3);
+        RandomGenerator copy = original;
+        ASSERT_EQ(copy.is_counter_based(), counter_based);
+
+        std::vector<RandomGenerator::result_type> numbers;
+        for (int i = 0; i < 10; i++)
+            numbers.push_back(original());
+
+        RandomGenerator assigned(9);
+        assigned = copy;
+        for (int i = 0; i < 10; i++)
+        {
+            ASSERT_EQ(copy(), numbers[i]);
+            ASSERT_EQ(assigned(), numbers[i]);
+        }
+    }
+}
+
+/*! Tests if coordinates that do not fit in the counter are rejected.
+ */
+TEST(RandomGeneratorTest, InvalidCoordinates)
+{
+    ASSERT_NO_THROW(RandomGenerator(0, UINT32_MAX, RNG_MAX_GENERATION,
+                                    RNG_MAX_STREAM));
+    ASSERT_THROW(RandomGenerator(0, 1ULL << 32, 0, 0), std::invalid_argument);
+    ASSERT_THROW(RandomGenerator(0, 0, RNG_MAX_GENERATION + 1, 0),
+                 std::invalid_argument);
+    ASSERT_THROW(RandomGenerator(0, 0, 0, RNG_MAX_STREAM + 1),
+                 std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
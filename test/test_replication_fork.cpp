@@ -10,6 +10,7 @@ class TestingProvider : public DataProvider
 {
   private:
     int size;
+    std::vector<std::string> codes;
     std::vector<double> prob_landscape;
     std::vector<transcription_region_t> transcription_regions;
     std::vector<constitutive_origin_t> cons_origins;
@@ -30,28 +31,31 @@ class TestingProvider : public DataProvider
         cons_origins.resize(1, origin);
     }
 
-    const std::vector<std::string> &get_codes()
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
     {
-        std::vector<std::string> codes;
-        return codes;
+        codes.assign(1, code);
+        return 0;
     }
 
-    int get_length(std::string code) { return size; }
+    int get_length(uint id) { return size; }
 
-    const std::vector<double> &get_probability_landscape(std::string code)
+    const std::vector<double> &get_probability_landscape(uint id)
     {
         return prob_landscape;
     }
 
-    const std::shared_ptr<std::vector<transcription_region_t>>
-    get_transcription_regions(std::string code)
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
     {
         return std::make_shared<std::vector<transcription_region_t>>(
             transcription_regions);
     }
 
-    const std::shared_ptr<std::vector<constitutive_origin_t>>
-    get_constitutive_origins(std::string code)
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
     {
         return std::make_shared<std::vector<constitutive_origin_t>>(
             cons_origins);
@@ -64,7 +68,7 @@ class ReplicationForkTest : public ::testing::Test
   protected:
     std::shared_ptr<ReplicationFork> fork;
     std::vector<std::shared_ptr<Chromosome>> chrms;
-    std::mt19937 *rand_generator;
+    RandomGenerator *rand_generator;
 
   protected:
     ReplicationForkTest() {}
@@ -74,9 +78,9 @@ class ReplicationForkTest : public ::testing::Test
         for (int i = 0; i < 100; i++)
             chrms.push_back(create_chromosome(300, std::to_string(i)));
         std::shared_ptr<Genome> gen = std::make_shared<Genome>(chrms);
-        ForkManager *fork_manager   = new ForkManager(2, gen, 1);
-        fork = std::make_shared<ReplicationFork>(gen, fork_manager, 40);
-        rand_generator = new std::mt19937(1);
+        ForkManager *fork_manager   = new ForkManager(2, gen, 40);
+        fork = std::make_shared<ReplicationFork>(fork_manager, 0);
+        rand_generator = new RandomGenerator(1);
     }
 
     void TearDown() {
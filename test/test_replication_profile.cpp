@@ -0,0 +1,214 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include "../include/chromosome.hpp"
+#include "../include/genome.hpp"
+#include "../include/replication_profile.hpp"
+
+class ProfileProvider : public DataProvider
+{
+  private:
+    int size;
+    std::vector<std::string> codes;
+    std::vector<double> prob_landscape;
+
+  public:
+    ProfileProvider(uint size) : size(size), prob_landscape(size, 0.5) {}
+
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
+    {
+        codes.assign(1, code);
+        return 0;
+    }
+
+    int get_length(uint id) { return size; }
+
+    const std::vector<double> &get_probability_landscape(uint id)
+    {
+        return prob_landscape;
+    }
+
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
+    {
+        return std::make_shared<std::vector<transcription_region_t>>();
+    }
+
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
+    {
+        return std::make_shared<std::vector<constitutive_origin_t>>();
+    }
+};
+
+class ReplicationProfileTest : public ::testing::Test
+{
+  protected:
+    /*! Builds a Genome with a Chromosome of each size, replicated by forks
+     * fired at random.
+     */
+    std::shared_ptr<Genome> replicated_genome(std::vector<uint> sizes,
+                                              unsigned long long seed,
+                                              int n_origins = 5)
+    {
+        std::vector<std::shared_ptr<Chromosome>> chromosomes;
+        for (uint i = 0; i < sizes.size(); i++)
+            chromosomes.push_back(std::make_shared<Chromosome>(
+                std::to_string(i),
+                std::make_shared<ProfileProvider>(sizes[i])));
+        auto genome = std::make_shared<Genome>(chromosomes);
+
+        std::mt19937 generator(seed);
+        for (auto &chromosome : genome->chromosomes)
+            for (int i = 0; i < n_origins; i++)
+            {
+                uint base     = generator() % chromosome->size();
+                Strand strand = chromosome->get_strand();
+                if (strand.is_replicated(base)) continue;
+                uint speed = 1 + generator() % 4;
+                uint time  = generator() % 50;
+                uint right = chromosome->unreplicated_run(base, 1, 30);
+                uint left  = chromosome->unreplicated_run(base, -1, 30);
+                chromosome->replicate(base, base, time);
+                if (right >= speed)
+                    chromosome->replicate_run(base, 1, speed, time + 1,
+                                              right / speed);
+                if (left >= speed)
+                    chromosome->replicate_run(base, -1, speed, time + 1,
+                                              left / speed);
+            }
+        return genome;
+    }
+};
+
+/*! Tests the sums of each bin against reading the Strand base by base.
+ */
+TEST_F(ReplicationProfileTest, BinTimes)
+{
+    for (unsigned long long seed = 0; seed < 20; seed++)
+    {
+        auto genome = replicated_genome({257, 100}, seed);
+        for (auto &chromosome : genome->chromosomes)
+            for (uint bin_size : {1, 7, 64, 1000})
+            {
+                Strand strand = chromosome->get_strand();
+                std::vector<unsigned long long> sums;
+                std::vector<uint> counts;
+                ReplicationProfile::bin_times(strand, bin_size, sums, counts);
+                ASSERT_EQ(sums.size(),
+                          (strand.size() + bin_size - 1) / bin_size);
+
+                std::vector<unsigned long long> expected_sums(sums.size());
+                std::vector<uint> expected_counts(sums.size());
+                for (uint base = 0; base < strand.size(); base++)
+                {
+                    if (strand[base] < 0) continue;
+                    expected_sums[base / bin_size] += strand[base];
+                    expected_counts[base / bin_size]++;
+                }
+                ASSERT_EQ(sums, expected_sums);
+                ASSERT_EQ(counts, expected_counts);
+            }
+    }
+}
+
+/*! Tests the statistics of the bins over some cells, and that merging
+ * profiles gives the same ones.
+ */
+TEST_F(ReplicationProfileTest, Statistics)
+{
+    ASSERT_THROW(ReplicationProfile(0), std::invalid_argument);
+
+    ReplicationProfile whole(10), first(10), second(10);
+    std::vector<std::vector<double>> times(26);
+    for (unsigned long long seed = 0; seed < 9; seed++)
+    {
+        auto genome = replicated_genome({257}, seed);
+        whole.add(*genome);
+        (seed % 2 ? first : second).add(*genome);
+
+        Strand strand = genome->chromosomes[0]->get_strand();
+        for (uint b = 0; b < times.size(); b++)
+        {
+            unsigned long long sum = 0, count = 0;
+            for (uint base = b * 10; base < std::min(257U, b * 10 + 10); base++)
+                if (strand[base] >= 0)
+                {
+                    sum += strand[base];
+                    count++;
+                }
+            if (count) times[b].push_back((sum + count / 2) / count);
+        }
+    }
+
+    ASSERT_EQ(whole.get_codes(), std::vector<std::string>({"0"}));
+    const std::vector<profile_bin_t> &bins = whole.get_bins(0);
+    ASSERT_EQ(bins.size(), 26);
+    for (uint b = 0; b < bins.size(); b++)
+    {
+        double mean = 0, variance = 0;
+        for (double time : times[b])
+            mean += time;
+        mean /= std::max<size_t>(times[b].size(), 1);
+        for (double time : times[b])
+            variance += (time - mean) * (time - mean);
+        if (times[b].size() > 1) variance /= times[b].size() - 1;
+
+        ASSERT_EQ(bins[b].times.count(), times[b].size());
+        ASSERT_NEAR(bins[b].times.mean(), mean, 1e-9);
+        ASSERT_NEAR(bins[b].times.variance(), variance, 1e-6);
+    }
+
+    ReplicationProfile merged(10);
+    merged.merge(second);
+    merged.merge(first);
+    for (uint b = 0; b < bins.size(); b++)
+    {
+        const profile_bin_t &bin = merged.get_bins(0)[b];
+        ASSERT_EQ(bin.times.count(), bins[b].times.count());
+        ASSERT_EQ(bin.times.mean(), bins[b].times.mean());
+        ASSERT_EQ(bin.times.variance(), bins[b].times.variance());
+        ASSERT_EQ(bin.sketch.quantile(0.5), bins[b].sketch.quantile(0.5));
+    }
+
+    ReplicationProfile other_bins(20);
+    other_bins.add(*replicated_genome({257}, 0));
+    ASSERT_THROW(merged.merge(other_bins), std::invalid_argument);
+    ASSERT_THROW(whole.add(*replicated_genome({257, 100}, 0)),
+                 std::invalid_argument);
+}
+
+/*! Tests the profile file of a Chromosome.
+ */
+TEST_F(ReplicationProfileTest, Write)
+{
+    auto genome = replicated_genome({25}, 0, 0);
+    genome->chromosomes[0]->replicate(0, 24, 3);
+
+    ReplicationProfile profile(10);
+    profile.add(*genome);
+    profile.write("profile_test");
+
+    std::ifstream file("profile_test/0.profile");
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    ASSERT_EQ(content, "# start\tend\tcells\tmean\tsd\tmedian\n"
+                       "0\t9\t1\t3.00\t0.00\t3.00\n"
+                       "10\t19\t1\t3.00\t0.00\t3.00\n"
+                       "20\t24\t1\t3.00\t0.00\t3.00\n");
+    std::filesystem::remove_all("profile_test");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include "../include/s_phase.hpp"
+#include <cmath>
 #include <fstream>
 #include <vector>
 
@@ -40,10 +41,11 @@ class PublicSPhase : public SPhase
                  int timeout, int transcription_period, bool has_dormant,
                  std::shared_ptr<DataProvider> data, std::string organism,
                  std::string name, std::string output_folder = "output",
-                 unsigned long long seed = 0)
+                 unsigned long long seed = 0, std::string engine = "step",
+                 std::string sampler = "rejection")
         : SPhase(origins_range, n_resources, replication_speed, timeout,
                  transcription_period, has_dormant, data, organism, name,
-                 output_folder, seed){};
+                 output_folder, seed, engine, sampler){};
 
     std::shared_ptr<Genome> get_genome() { return SPhase::genome; }
     std::shared_ptr<ForkManager> get_fork_manager()
@@ -689,6 +691,198 @@ TEST_F(SPhaseTest, DormantWithTranscription)
     for (auto str : argv_mock)
         free(str);
 }
+// The event engine and the tree sampler do not consume random numbers in the
+// same order as the reference step engine, so they are compared on the mean
+// of their statistics instead, within tolerance standard errors.
+void expect_same_statistics(
+    std::vector<std::pair<std::string, std::string>> engines_and_samplers,
+    std::shared_ptr<DataProvider> data, int n_resources = 10,
+    int replication_speed = 1, int transcription_period = 50,
+    int n_cells = 100, double tolerance = 4)
+{
+    std::vector<std::vector<double>> times, collisions, origins;
+    for (auto engine_and_sampler : engines_and_samplers)
+    {
+        times.push_back(std::vector<double>());
+        collisions.push_back(std::vector<double>());
+        origins.push_back(std::vector<double>());
+        for (unsigned long long seed = 0; seed < (unsigned)n_cells; seed++)
+        {
+            PublicSPhase s_phase(0, n_resources, replication_speed, 1000000,
+                                 transcription_period, true, data, "dummy",
+                                 "test", "test_out_folder/", seed,
+                                 engine_and_sampler.first,
+                                 engine_and_sampler.second);
+            s_phase.simulate(0);
+            ASSERT_TRUE(s_phase.get_genome()->is_replicated());
+            times.back().push_back(s_phase.get_stats().time);
+            collisions.back().push_back(s_phase.get_stats().collisions);
+            origins.back().push_back(
+                s_phase.get_fork_manager()->metric_times_attached);
+        }
+    }
+
+    for (auto stat : {times, collisions, origins})
+    {
+        std::vector<double> mean(stat.size(), 0), var(stat.size(), 0);
+        for (uint i = 0; i < stat.size(); i++)
+        {
+            for (double value : stat[i])
+                mean[i] += value / n_cells;
+            for (double value : stat[i])
+                var[i] += (value - mean[i]) * (value - mean[i]) / (n_cells - 1);
+        }
+        for (uint i = 1; i < stat.size(); i++)
+        {
+            double std_error = std::sqrt((var[0] + var[i]) / n_cells);
+            EXPECT_NEAR(mean[0], mean[i], tolerance * std_error + 1e-9);
+        }
+    }
+}
+
+std::shared_ptr<DataProvider> dummy_data(double p = 0)
+{
+    return std::make_shared<DataManager>(
+        "dummy", "../data/database.sqlite", "../data/MFA-Seq_dummy/", p);
+}
+
+// Origins fire seldom enough that the forks replicate a good part of the
+// Genome between two of them, which is where skipping idle steps could bias
+// the firing rate
+TEST_F(SPhaseTest, EventEngineMatchesStepEngine)
+{
+    expect_same_statistics({{"step", "rejection"},
+                            {"event", "rejection"},
+                            {"event", "tree"},
+                            {"event", "gap"}},
+                           dummy_data(0.01), 10, 2, 0, 1000, 3);
+    expect_same_statistics({{"step", "rejection"}, {"event", "rejection"}},
+                           dummy_data());
+}
+
+TEST_F(SPhaseTest, TreeSamplerMatchesRejectionSampler)
+{
+    expect_same_statistics(
+        {{"step", "rejection"}, {"step", "tree"}, {"event", "tree"}},
+        dummy_data());
+}
+
+TEST_F(SPhaseTest, GapSamplerMatchesRejectionSampler)
+{
+    expect_same_statistics(
+        {{"step", "rejection"}, {"step", "gap"}, {"event", "gap"}},
+        dummy_data());
+}
+
+TEST_F(SPhaseTest, BatchSamplerMatchesRejectionSampler)
+{
+    expect_same_statistics({{"step", "rejection"}, {"step", "batch"}},
+                           dummy_data());
+}
+
+// The samplers only apply to the probability landscape, with constitutive
+// origins the step engine has to simulate exactly as with rejection
+TEST_F(SPhaseTest, SamplersIgnoredWithConstitutiveOrigins)
+{
+    std::shared_ptr<DataProvider> data = dummy_data();
+
+    for (unsigned long long seed = 0; seed < 5; seed++)
+    {
+        PublicSPhase rejection(15, 2, 1, 1000000, 0, false, data, "dummy",
+                               "test", "test_out_folder/", seed, "step",
+                               "rejection");
+        rejection.simulate(0);
+
+        for (auto sampler : {"tree", "gap", "batch"})
+        {
+            PublicSPhase s_phase(15, 2, 1, 1000000, 0, false, data,
+                                 "dummy", "test", "test_out_folder/", seed,
+                                 "step", sampler);
+            s_phase.simulate(0);
+
+            ASSERT_EQ(rejection.get_stats().time, s_phase.get_stats().time);
+            ASSERT_EQ(rejection.get_fork_manager()->metric_times_attached,
+                      s_phase.get_fork_manager()->metric_times_attached);
+            for (uint i = 0; i < s_phase.get_genome()->chromosomes.size(); i++)
+                ASSERT_EQ(rejection.get_genome()->chromosomes[i]->to_string(),
+                          s_phase.get_genome()->chromosomes[i]->to_string());
+        }
+    }
+}
+
+// A reset SPhase has to simulate exactly as a new one with the same seed
+TEST_F(SPhaseTest, ResetMatchesNewSPhase)
+{
+    std::shared_ptr<DataManager> data = std::make_shared<DataManager>(
+        "dummy", "../data/database.sqlite", "../data/MFA-Seq_dummy/", 0);
+
+    for (auto engine : {"step", "event"})
+        for (auto sampler : {"rejection", "tree", "gap"})
+            for (int origins_range : {0, 1000})
+            {
+                PublicSPhase reused(origins_range, 10, 1, 1000000, 50, true,
+                                    data, "dummy", "test", "test_out_folder/",
+                                    0, engine, sampler);
+                for (unsigned long long seed = 0; seed < 5; seed++)
+                {
+                    if (seed > 0) reused.reset(seed);
+                    reused.simulate(0);
+
+                    PublicSPhase created(origins_range, 10, 1, 1000000, 50,
+                                         true, data, "dummy", "test",
+                                         "test_out_folder/", seed, engine,
+                                         sampler);
+                    created.simulate(0);
+
+                    ASSERT_EQ(reused.get_stats().time,
+                              created.get_stats().time);
+                    ASSERT_EQ(reused.get_stats().collisions,
+                              created.get_stats().collisions);
+                    ASSERT_EQ(reused.get_fork_manager()->metric_times_attached,
+                              created.get_fork_manager()->metric_times_attached);
+                    for (uint i = 0; i < created.get_genome()->chromosomes.size();
+                         i++)
+                        ASSERT_EQ(
+                            reused.get_genome()->chromosomes[i]->to_string(),
+                            created.get_genome()->chromosomes[i]->to_string());
+                }
+            }
+}
+
+// With a counter based generator a cell simulates the same no matter which
+// cells the SPhase simulated before it
+TEST_F(SPhaseTest, CounterBasedCellsIndependentOfOrder)
+{
+    std::shared_ptr<DataManager> data = std::make_shared<DataManager>(
+        "dummy", "../data/database.sqlite", "../data/MFA-Seq_dummy/", 0);
+
+    PublicSPhase forward(0, 10, 1, 1000000, 50, true, data, "dummy", "test",
+                         "test_out_folder/", 0, "event", "rejection");
+    PublicSPhase backward(0, 10, 1, 1000000, 50, true, data, "dummy", "test",
+                          "test_out_folder/", 0, "event", "rejection");
+
+    const unsigned long long n_cells = 6;
+    std::vector<simulation_stats> forward_stats(n_cells), backward_stats(n_cells);
+    for (unsigned long long cell = 0; cell < n_cells; cell++)
+    {
+        forward.reset(RandomGenerator(42, cell, 0, RNG_STREAM_GENOME));
+        forward.simulate(cell);
+        forward_stats[cell] = forward.get_stats();
+
+        unsigned long long other = n_cells - 1 - cell;
+        backward.reset(RandomGenerator(42, other, 0, RNG_STREAM_GENOME));
+        backward.simulate(other);
+        backward_stats[other] = backward.get_stats();
+    }
+
+    for (unsigned long long cell = 0; cell < n_cells; cell++)
+    {
+        ASSERT_EQ(forward_stats[cell].time, backward_stats[cell].time);
+        ASSERT_EQ(forward_stats[cell].collisions,
+                  backward_stats[cell].collisions);
+    }
+}
+
 // std::cout << "chromosome[0] \n"
 //           << s_phase->get_genome()->chromosomes[0]->to_string()
 //           << "\nline: " << __LINE__ << std::endl;
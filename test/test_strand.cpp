@@ -0,0 +1,112 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../include/strand.hpp"
+
+class StrandTest : public ::testing::Test
+{
+  protected:
+    Strand *strand;
+
+  protected:
+    StrandTest() {}
+
+    void SetUp() { strand = new Strand(100); }
+
+    void TearDown() { delete strand; }
+};
+
+TEST_F(StrandTest, Empty)
+{
+    ASSERT_EQ(strand->size(), 100);
+    ASSERT_TRUE(strand->get_segments().empty());
+    for (uint base = 0; base < 100; base++)
+    {
+        ASSERT_EQ((*strand)[base], -1);
+        ASSERT_FALSE(strand->is_replicated(base));
+    }
+}
+
+TEST_F(StrandTest, OutOfRangeIsReplicated)
+{
+    ASSERT_THROW(strand->is_replicated(100), std::out_of_range);
+    ASSERT_NO_THROW(strand->is_replicated(99));
+}
+
+TEST_F(StrandTest, ReplicateConstant)
+{
+    strand->replicate(9, 1, 0, 5, 10);
+    ASSERT_EQ((*strand)[9], -1);
+    for (uint base = 10; base < 20; base++)
+        ASSERT_EQ((*strand)[base], 5);
+    ASSERT_EQ((*strand)[20], -1);
+}
+
+/*! A fork at base 50 with speed 3 and its mirror going left, both starting
+ * at time 7.
+ */
+TEST_F(StrandTest, ReplicateProgression)
+{
+    strand->replicate(49, 1, 0, 7, 1);
+    strand->replicate(50, 1, 3, 7, 8);
+    strand->replicate(50, -1, 3, 7, 7);
+
+    ASSERT_EQ((*strand)[50], 7);
+    ASSERT_EQ((*strand)[51], 8);
+    ASSERT_EQ((*strand)[53], 8);
+    ASSERT_EQ((*strand)[54], 9);
+    ASSERT_EQ((*strand)[58], 10);
+    ASSERT_EQ((*strand)[59], -1);
+    ASSERT_EQ((*strand)[49], 8);
+    ASSERT_EQ((*strand)[47], 8);
+    ASSERT_EQ((*strand)[46], 9);
+    ASSERT_EQ((*strand)[43], 10);
+    ASSERT_EQ((*strand)[42], -1);
+    ASSERT_EQ(strand->get_segments().size(), 3);
+}
+
+/*! Runs that continue the pattern of the segment they start from extend it.
+ */
+TEST_F(StrandTest, ReplicateGrowsSegment)
+{
+    strand->replicate(49, 1, 0, 0, 1);
+    for (int time = 1; time <= 5; time++)
+    {
+        strand->replicate(50 - 2 * (time - 1), -1, 2, time - 1, 2);
+        strand->replicate(50 + 2 * (time - 1), 1, 2, time - 1, 2);
+    }
+    ASSERT_EQ(strand->get_segments().size(), 3);
+    for (int offset = 1; offset <= 10; offset++)
+    {
+        ASSERT_EQ((*strand)[50 + offset], (offset + 1) / 2);
+        ASSERT_EQ((*strand)[50 - offset], (offset + 1) / 2);
+    }
+
+    // A different time does not follow the pattern
+    strand->replicate(60, 1, 2, 9, 2);
+    ASSERT_EQ(strand->get_segments().size(), 4);
+    ASSERT_EQ((*strand)[61], 10);
+}
+
+TEST_F(StrandTest, UnreplicatedRun)
+{
+    strand->replicate(39, 1, 0, 1, 10);
+    strand->replicate(80, -1, 0, 1, 10);
+
+    ASSERT_EQ(strand->unreplicated_run(-1, 1, 100), 40);
+    ASSERT_EQ(strand->unreplicated_run(20, 1, 100), 19);
+    ASSERT_EQ(strand->unreplicated_run(20, 1, 5), 5);
+    ASSERT_EQ(strand->unreplicated_run(20, -1, 100), 20);
+    ASSERT_EQ(strand->unreplicated_run(49, 1, 100), 20);
+    ASSERT_EQ(strand->unreplicated_run(60, -1, 100), 10);
+    ASSERT_EQ(strand->unreplicated_run(79, 1, 100), 20);
+    ASSERT_EQ(strand->unreplicated_run(100, -1, 100), 20);
+    ASSERT_EQ(strand->unreplicated_run(45, 1, 100), 0);
+    ASSERT_EQ(strand->unreplicated_run(99, 1, 100), 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../include/summary_statistic.hpp"
+
+TEST(SummaryStatisticTest, Empty)
+{
+    SummaryStatistic statistic;
+    ASSERT_EQ(statistic.count(), 0);
+    ASSERT_EQ(statistic.mean(), 0);
+    ASSERT_EQ(statistic.variance(), 0);
+    ASSERT_EQ(statistic.min(), 0);
+    ASSERT_EQ(statistic.max(), 0);
+    ASSERT_EQ(statistic.to_string(), "0\t0.00\t0.00\t0\t0\t");
+
+    statistic.add(7);
+    ASSERT_EQ(statistic.variance(), 0);
+    ASSERT_EQ(statistic.to_string(), "1\t7.00\t0.00\t7\t7\t7:1");
+}
+
+/*! Tests the moments and extremes against a direct computation.
+ */
+TEST(SummaryStatisticTest, Moments)
+{
+    std::vector<unsigned long long> values = {12000, 15500, 9800, 20000,
+                                              11111, 9800,  31000};
+    SummaryStatistic statistic;
+    for (unsigned long long value : values)
+        statistic.add(value);
+
+    double mean = 0, variance = 0;
+    for (unsigned long long value : values)
+        mean += value;
+    mean /= values.size();
+    for (unsigned long long value : values)
+        variance += (value - mean) * (value - mean);
+    variance /= values.size() - 1;
+
+    ASSERT_EQ(statistic.count(), values.size());
+    ASSERT_DOUBLE_EQ(statistic.mean(), mean);
+    ASSERT_DOUBLE_EQ(statistic.variance(), variance);
+    ASSERT_DOUBLE_EQ(statistic.sd(), std::sqrt(variance));
+    ASSERT_EQ(statistic.min(), 9800);
+    ASSERT_EQ(statistic.max(), 31000);
+
+    // Large values of the same magnitude do not lose the variance
+    SummaryStatistic large;
+    for (unsigned long long value : {1000000000001ULL, 1000000000002ULL,
+                                     1000000000003ULL})
+        large.add(value);
+    ASSERT_EQ(large.variance(), 1);
+}
+
+/*! Tests if merging gives exactly the same statistic no matter how the
+ * values were split.
+ */
+TEST(SummaryStatisticTest, Merge)
+{
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<unsigned long long> distribution(0, 1000000);
+    std::vector<unsigned long long> values(1000);
+    for (auto &value : values)
+        value = distribution(generator);
+
+    SummaryStatistic whole;
+    for (unsigned long long value : values)
+        whole.add(value);
+
+    for (uint parts : {2, 3, 7})
+    {
+        std::vector<SummaryStatistic> split(parts);
+        for (uint i = 0; i < values.size(); i++)
+            split[(i * 7919) % parts].add(values[i]);
+
+        SummaryStatistic merged;
+        for (int i = parts - 1; i >= 0; i--)
+            merged.merge(split[i]);
+        merged.merge(SummaryStatistic());
+
+        ASSERT_EQ(merged.count(), whole.count());
+        ASSERT_EQ(merged.mean(), whole.mean());
+        ASSERT_EQ(merged.variance(), whole.variance());
+        ASSERT_EQ(merged.min(), whole.min());
+        ASSERT_EQ(merged.max(), whole.max());
+        ASSERT_EQ(merged.histogram(), whole.histogram());
+        ASSERT_EQ(merged.to_string(), whole.to_string());
+    }
+}
+
+/*! Tests if the bins cover all values in order, each at most 1/8 of its
+ * values wide.
+ */
+TEST(SummaryStatisticTest, Bins)
+{
+    for (uint bin = 0; bin < SUMMARY_EXACT_BINS; bin++)
+    {
+        ASSERT_EQ(SummaryStatistic::bin(bin), bin);
+        ASSERT_EQ(SummaryStatistic::bin_lower_bound(bin), bin);
+    }
+
+    for (uint bin = 1; bin < SUMMARY_BINS; bin++)
+    {
+        unsigned long long lower = SummaryStatistic::bin_lower_bound(bin);
+        ASSERT_EQ(SummaryStatistic::bin(lower), bin);
+        ASSERT_EQ(SummaryStatistic::bin(lower - 1), bin - 1);
+        if (bin >= SUMMARY_EXACT_BINS)
+        {
+            ASSERT_LE(lower - SummaryStatistic::bin_lower_bound(bin - 1),
+                      lower / 8 + 1);
+        }
+    }
+    ASSERT_EQ(SummaryStatistic::bin(UINT64_MAX), SUMMARY_BINS - 1);
+
+    SummaryStatistic statistic;
+    for (unsigned long long value : {3ULL, 16ULL, 17ULL, 18ULL, 1000ULL})
+        statistic.add(value);
+    ASSERT_EQ(statistic.histogram()[SummaryStatistic::bin(16)], 2);
+    ASSERT_EQ(statistic.to_string(),
+              "5\t210.80\t441.22\t3\t1000\t3:1,16:2,18:1,960:1");
+}
+
+/*! Tests a statistic without a histogram, as kept for each profile bin.
+ */
+TEST(SummaryStatisticTest, WithoutHistogram)
+{
+    SummaryStatistic statistic(false), with_histogram;
+    for (unsigned long long value : {3ULL, 16ULL, 1000ULL})
+    {
+        statistic.add(value);
+        with_histogram.add(value);
+    }
+    ASSERT_TRUE(statistic.histogram().empty());
+    ASSERT_EQ(statistic.variance(), with_histogram.variance());
+    ASSERT_EQ(statistic.to_string(), "3\t339.67\t571.90\t3\t1000\t");
+
+    ASSERT_THROW(statistic.merge(with_histogram), std::invalid_argument);
+    ASSERT_THROW(with_histogram.merge(statistic), std::invalid_argument);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,197 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include "../include/timing_file.hpp"
+
+class TestingProvider : public DataProvider
+{
+  private:
+    int size;
+    std::vector<std::string> codes;
+    std::vector<double> prob_landscape;
+    std::vector<transcription_region_t> transcription_regions;
+    std::vector<constitutive_origin_t> cons_origins;
+
+  public:
+    TestingProvider(uint size) : size(size)
+    {
+        prob_landscape.resize(size, (double)1 / (size + 1));
+    }
+
+    const std::vector<std::string> &get_codes() { return codes; }
+
+    // The only Chromosome of the provider, whatever its code
+    uint get_chromosome_id(std::string code)
+    {
+        codes.assign(1, code);
+        return 0;
+    }
+
+    int get_length(uint id) { return size; }
+
+    const std::vector<double> &get_probability_landscape(uint id)
+    {
+        return prob_landscape;
+    }
+
+    std::shared_ptr<const std::vector<transcription_region_t>>
+    get_transcription_regions(uint id)
+    {
+        return std::make_shared<std::vector<transcription_region_t>>(
+            transcription_regions);
+    }
+
+    std::shared_ptr<const std::vector<constitutive_origin_t>>
+    get_constitutive_origins(uint id)
+    {
+        return std::make_shared<std::vector<constitutive_origin_t>>(
+            cons_origins);
+    }
+};
+
+class TimingFileTest : public ::testing::Test
+{
+  protected:
+    std::string path = "test_timing_file.cseq.zst";
+
+  protected:
+    TimingFileTest() {}
+
+    std::shared_ptr<Chromosome> create_chromosome(uint size)
+    {
+        std::shared_ptr<TestingProvider> provider(new TestingProvider(size));
+
+        return std::make_shared<Chromosome>("chr1", provider);
+    }
+
+    std::vector<timing_record_t> records(Chromosome &chromosome)
+    {
+        std::vector<timing_record_t> records;
+        compress_replication_times(chromosome,
+                                   [&](const timing_record_t &record) {
+                                       records.push_back(record);
+                                   });
+        return records;
+    }
+
+    void write(Chromosome &chromosome)
+    {
+        TimingFileWriter writer(path, chromosome.get_code(), chromosome.size());
+        for (auto record : records(chromosome))
+            writer.write(record);
+    }
+
+    void TearDown() { std::remove(path.c_str()); }
+};
+
+/*! Tests the text of the records of runs, sequences and unreplicated bases.
+ */
+TEST_F(TimingFileTest, CompressReplicationTimes)
+{
+    auto chromosome = create_chromosome(300);
+
+    // A fork moving right from base 10 at speed 2
+    for (int time = 1; time <= 10; time++)
+        chromosome->replicate(8 + 2 * time, 9 + 2 * time, time);
+    // A single base
+    chromosome->replicate(100, 100, 7);
+    // A run of equal times
+    chromosome->replicate(200, 249, 3);
+
+    std::vector<std::string> lines;
+    for (auto record : records(*chromosome))
+        lines.push_back(to_string(record));
+
+    std::vector<std::string> expected = {"-1x10",  "1-10x2", "-1x70", "7",
+                                         "-1x99",  "3x50",   "-1x50"};
+    ASSERT_EQ(lines, expected);
+}
+
+/*! Tests if the times read back are the ones of the Chromosome.
+ */
+TEST_F(TimingFileTest, RoundTrip)
+{
+    auto chromosome = create_chromosome(1000);
+    for (int time = 1; time <= 100; time++)
+    {
+        chromosome->replicate(500 + time, 500 + time, time);
+        chromosome->replicate(500 - time, 500 - time, time);
+    }
+    chromosome->replicate(500, 500, 0);
+    chromosome->replicate(900, 949, 42);
+
+    write(*chromosome);
+
+    TimingFileReader reader(path);
+    ASSERT_EQ(reader.get_code(), "chr1");
+    ASSERT_EQ(reader.get_length(), 1000);
+
+    auto times = reader.times();
+    for (uint base = 0; base < chromosome->size(); base++)
+        ASSERT_EQ(times[base], (*chromosome)[base]);
+}
+
+/*! Tests files with several chunks and the records read one by one.
+ */
+TEST_F(TimingFileTest, SeveralChunks)
+{
+    uint size       = 3 * TIMING_FILE_CHUNK + 7;
+    auto chromosome = create_chromosome(size);
+    for (uint base = 0; base < size; base++)
+        chromosome->replicate(base, base, 1 + 2 * (base % 2));
+
+    auto expected = records(*chromosome);
+    ASSERT_EQ(expected.size(), size);
+    write(*chromosome);
+
+    TimingFileReader reader(path);
+    timing_record_t record;
+    for (auto expected_record : expected)
+    {
+        ASSERT_TRUE(reader.next(record));
+        ASSERT_EQ(record.start, expected_record.start);
+        ASSERT_EQ(record.end, expected_record.end);
+        ASSERT_EQ(record.length, expected_record.length);
+    }
+    ASSERT_FALSE(reader.next(record));
+    ASSERT_FALSE(reader.next(record));
+}
+
+/*! Tests if files that are not timing files are rejected.
+ */
+TEST_F(TimingFileTest, InvalidFile)
+{
+    ASSERT_THROW(TimingFileReader("no_such_file.cseq.zst"),
+                 std::runtime_error);
+
+    std::ofstream text(path);
+    text << "-1x300\n";
+    text.close();
+    ASSERT_THROW(TimingFileReader reader(path), std::runtime_error);
+
+    // Headers with a negative length or code size, or an implausible one
+    for (int32_t length : {-1, 300})
+        for (int32_t code_size : {-5, 4, TIMING_FILE_MAX_CODE + 1})
+        {
+            if (length > 0 && code_size == 4) continue;
+            int32_t header[] = {TIMING_FILE_MAGIC, TIMING_FILE_VERSION, length,
+                                code_size};
+            std::vector<char> compressed(ZSTD_compressBound(sizeof(header)));
+            size_t size = ZSTD_compress(compressed.data(), compressed.size(),
+                                        header, sizeof(header), 1);
+            std::ofstream file(path, std::ios::binary);
+            file.write(compressed.data(), size);
+            file.close();
+            ASSERT_THROW(TimingFileReader reader(path), std::runtime_error)
+                << length << " " << code_size;
+        }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../include/transcription_region_index.hpp"
+
+class TranscriptionRegionIndexTest : public ::testing::Test
+{
+  protected:
+    std::vector<transcription_region_t> regions;
+
+  protected:
+    TranscriptionRegionIndexTest() {}
+
+    void SetUp()
+    {
+        // A long region, a backwards one nested inside it and two disjoint
+        // ones, not sorted
+        regions = {{500, 600}, {100, 900}, {300, 200}, {950, 980}};
+    }
+
+    /*! Lists the regions visited by find_overlapping, sorted by start.
+     */
+    std::vector<int> overlapping(const TranscriptionRegionIndex &index,
+                                 int first, int last)
+    {
+        std::vector<int> starts;
+        index.find_overlapping(first, last,
+                               [&](const transcription_region_t &region) {
+                                   starts.push_back(region.start);
+                                   return false;
+                               });
+        std::sort(starts.begin(), starts.end());
+        return starts;
+    }
+
+    void TearDown() {}
+};
+
+TEST_F(TranscriptionRegionIndexTest, Empty)
+{
+    TranscriptionRegionIndex index(std::vector<transcription_region_t>(0));
+    ASSERT_EQ(index.size(), 0);
+    ASSERT_TRUE(overlapping(index, 0, 1000).empty());
+}
+
+TEST_F(TranscriptionRegionIndexTest, FindContaining)
+{
+    TranscriptionRegionIndex index(regions);
+    ASSERT_EQ(index.size(), 4);
+    ASSERT_EQ(overlapping(index, 50, 50), std::vector<int>());
+    ASSERT_EQ(overlapping(index, 100, 100), std::vector<int>({100}));
+    ASSERT_EQ(overlapping(index, 250, 250), std::vector<int>({100, 300}));
+    ASSERT_EQ(overlapping(index, 300, 300), std::vector<int>({100, 300}));
+    ASSERT_EQ(overlapping(index, 550, 550), std::vector<int>({100, 500}));
+    ASSERT_EQ(overlapping(index, 925, 925), std::vector<int>());
+    ASSERT_EQ(overlapping(index, 980, 980), std::vector<int>({950}));
+}
+
+TEST_F(TranscriptionRegionIndexTest, FindOverlapping)
+{
+    TranscriptionRegionIndex index(regions);
+    ASSERT_EQ(overlapping(index, 0, 99), std::vector<int>());
+    ASSERT_EQ(overlapping(index, 0, 200), std::vector<int>({100, 300}));
+    ASSERT_EQ(overlapping(index, 601, 2000), std::vector<int>({100, 950}));
+    ASSERT_EQ(overlapping(index, 901, 949), std::vector<int>());
+}
+
+TEST_F(TranscriptionRegionIndexTest, FindStopsWhenVisitReturnsTrue)
+{
+    TranscriptionRegionIndex index(regions);
+    int n_visited = 0;
+    ASSERT_TRUE(index.find_containing(
+        550, [&](const transcription_region_t &region) {
+            n_visited++;
+            return true;
+        }));
+    ASSERT_EQ(n_visited, 1);
+    ASSERT_FALSE(index.find_containing(
+        50, [](const transcription_region_t &region) { return true; }));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}